@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "mlang/script/lexer.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/parser/parser.hpp"
+#include "mlang/ast/flat_tree.hpp"
+#include "mlang/script/reload.hpp"
+
+#include "script_generator.hpp"
+
+namespace {
+
+/* loops, calls and arithmetic, the time is spent walking the AST */
+const char* const execute_script =
+    "function weight (value, limit) {\n"
+    "    if (value > limit) { return value - limit; }\n"
+    "    else if (value == limit) { return 0; }\n"
+    "    return limit - value;\n"
+    "}\n"
+    "var total = 0;\n"
+    "var values = { 3, 1, 4, 1, 5, 9, 2, 6 };\n"
+    "for (var i = 0; i < 200; ++i) {\n"
+    "    var j = 0;\n"
+    "    while (j < 8) {\n"
+    "        total += weight(values[j] * 2 + i, 10);\n"
+    "        ++j;\n"
+    "    }\n"
+    "    if (total > 100000) { total = 0; }\n"
+    "}\n";
+
+struct Compiled {
+    std::shared_ptr<mlang::script::Source> source;
+    std::vector<mlang::script::Token> tokens;
+};
+
+Compiled lex (std::string text) {
+    Compiled compiled { std::make_shared<mlang::script::Source>(std::move(text)), {} };
+    mlang::script::Lexer lexer { *compiled.source };
+    compiled.tokens = lexer.tokenize();
+    return compiled;
+}
+
+/* 'count' functions of which the script calls three */
+std::string generate_library (std::size_t count) {
+    std::string text;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+        text += "function f" + n + " (a, b) {\n";
+        text += "    var c = a * " + n + " + b;\n";
+        text += "    if (c > 100) { c = c - 100; }\n";
+        text += "    else { c += 1; }\n";
+        text += "    var i = 0;\n";
+        text += "    while (i < 3) { c += i; ++i; }\n";
+        text += "    return c;\n";
+        text += "}\n";
+    }
+    text += "var total = f1(1, 2) + f" + std::to_string(count / 2) + "(3, 4) + f" + std::to_string(count - 1) + "(5, 6);\n";
+    return text;
+}
+
+} /* namespace */
+
+/* tokens -> node tree, including its destruction */
+static void BM_CompileTree (benchmark::State& state) {
+    const Compiled compiled = lex(generate_script(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        mlang::parser::Parser parser {};
+        mlang::ast::node_ptr root = parser.parse(compiled.tokens, compiled.source);
+        benchmark::DoNotOptimize(root.get());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(compiled.tokens.size()));
+}
+BENCHMARK(BM_CompileTree)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+/* tokens -> flat tree, including its destruction */
+static void BM_CompileFlat (benchmark::State& state) {
+    const Compiled compiled = lex(generate_script(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        mlang::parser::FlatParser parser {};
+        std::unique_ptr<mlang::ast::FlatTree> tree = parser.parse(compiled.tokens, compiled.source);
+        benchmark::DoNotOptimize(tree.get());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(compiled.tokens.size()));
+}
+BENCHMARK(BM_CompileFlat)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+static void BM_ExecuteTree (benchmark::State& state) {
+    const Compiled compiled = lex(execute_script);
+    mlang::parser::Parser parser {};
+    mlang::ast::node_ptr root = parser.parse(compiled.tokens, compiled.source);
+    for (auto _ : state) {
+        mlang::script::EnvStack env {};
+        root->execute(env);
+        benchmark::DoNotOptimize(env.get_variable("total"));
+    }
+}
+BENCHMARK(BM_ExecuteTree)->Unit(benchmark::kMicrosecond);
+
+static void BM_ExecuteFlat (benchmark::State& state) {
+    const Compiled compiled = lex(execute_script);
+    mlang::parser::FlatParser parser {};
+    std::unique_ptr<mlang::ast::FlatTree> tree = parser.parse(compiled.tokens, compiled.source);
+    for (auto _ : state) {
+        mlang::script::EnvStack env {};
+        tree->execute(env);
+        benchmark::DoNotOptimize(env.get_variable("total"));
+    }
+}
+BENCHMARK(BM_ExecuteFlat)->Unit(benchmark::kMicrosecond);
+
+/* time to first execution of a large library, every function body is compiled before running */
+static void BM_FirstExecutionEager (benchmark::State& state) {
+    const Compiled compiled = lex(generate_library(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        mlang::parser::Parser parser {};
+        mlang::ast::node_ptr root = parser.parse(compiled.tokens, compiled.source);
+        mlang::script::EnvStack env {};
+        root->execute(env);
+        benchmark::DoNotOptimize(env.get_variable("total"));
+    }
+}
+BENCHMARK(BM_FirstExecutionEager)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+/* the same with the bodies compiled by their first call, only the three called functions are built */
+static void BM_FirstExecutionLazy (benchmark::State& state) {
+    Compiled compiled = lex(generate_library(static_cast<std::size_t>(state.range(0))));
+    std::shared_ptr<const std::vector<mlang::script::Token>> tokens = std::make_shared<const std::vector<mlang::script::Token>>(std::move(compiled.tokens));
+    for (auto _ : state) {
+        mlang::parser::Parser parser {};
+        mlang::ast::node_ptr root = parser.parse(tokens, compiled.source);
+        mlang::script::EnvStack env {};
+        root->execute(env);
+        benchmark::DoNotOptimize(env.get_variable("total"));
+    }
+}
+BENCHMARK(BM_FirstExecutionLazy)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+/* a 10k line script compiled from scratch, what every edit costs without incremental reload */
+static void BM_ReloadFull (benchmark::State& state) {
+    const std::string text = generate_script(10000);
+    for (auto _ : state) {
+        mlang::script::ReloadableScript script { text };
+        benchmark::DoNotOptimize(script.get_stats().compiled);
+    }
+}
+BENCHMARK(BM_ReloadFull)->Unit(benchmark::kMillisecond);
+
+/* the same script with one function edited back and forth */
+static void BM_ReloadOneFunction (benchmark::State& state) {
+    const std::string text = generate_script(10000);
+    std::string edited = text;
+    const std::size_t body = edited.find("first * 2", edited.size() / 2);
+    edited.replace(body, 9, "first * 3");
+    mlang::script::ReloadableScript script { text };
+    mlang::script::EnvStack env {};
+    script.execute(env);
+    bool flip = false;
+    for (auto _ : state) {
+        flip = !flip;
+        script.reload(flip ? edited : text, env);
+        benchmark::DoNotOptimize(script.get_stats().compiled);
+    }
+}
+BENCHMARK(BM_ReloadOneFunction)->Unit(benchmark::kMillisecond);
+
+/* source -> token vector -> node tree, the whole token stream is held while parsing */
+static void BM_LexThenCompile (benchmark::State& state) {
+    std::shared_ptr<mlang::script::Source> source = std::make_shared<mlang::script::Source>(generate_script(static_cast<std::size_t>(state.range(0))));
+    std::size_t token_bytes = 0;
+    for (auto _ : state) {
+        mlang::script::Lexer lexer { *source };
+        const std::vector<mlang::script::Token> tokens = lexer.tokenize();
+        mlang::parser::Parser parser {};
+        mlang::ast::node_ptr root = parser.parse(tokens, source);
+        token_bytes = tokens.capacity() * sizeof(mlang::script::Token);
+        benchmark::DoNotOptimize(root.get());
+    }
+    state.counters["token_bytes"] = static_cast<double>(token_bytes);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source->get_text().size()));
+}
+BENCHMARK(BM_LexThenCompile)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+/* source -> node tree, the tokens are pulled from the lexer while parsing */
+static void BM_StreamCompile (benchmark::State& state) {
+    std::shared_ptr<mlang::script::Source> source = std::make_shared<mlang::script::Source>(generate_script(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        mlang::parser::Parser parser {};
+        mlang::ast::node_ptr root = parser.parse(source);
+        benchmark::DoNotOptimize(root.get());
+    }
+    state.counters["token_bytes"] = 0;
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source->get_text().size()));
+}
+BENCHMARK(BM_StreamCompile)->Arg(20000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+#include "mlang/script/batch.hpp"
+
+#include "script_generator.hpp"
+
+namespace {
+
+/* 'count' rule files of 'lines' lines each, written once */
+const std::vector<std::string>& rule_files (std::size_t count, std::size_t lines) {
+    static std::vector<std::string> paths;
+    if (!paths.empty()) { return paths; }
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "mlang_batch_benchmark";
+    std::filesystem::create_directories(directory);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string path = (directory / ("rule_" + std::to_string(i) + ".mlang")).string();
+        std::ofstream file { path, std::ios::trunc };
+        file << generate_script(lines);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+} /* namespace */
+
+/* startup of a service with many rule files, the argument is the number of threads */
+static void BM_CompileAll (benchmark::State& state) {
+    const std::vector<std::string>& paths = rule_files(200, 500);
+    for (auto _ : state) {
+        mlang::script::CompileBatch batch = mlang::script::compile_all(paths, static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(batch.results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(paths.size()));
+}
+BENCHMARK(BM_CompileAll)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/budget.hpp"
+
+namespace {
+
+constexpr int iterations = 100000;
+
+std::shared_ptr<const mlang::script::Program> loop_program () {
+    static std::shared_ptr<const mlang::script::Program> program = mlang::script::Script {
+        "function add(a, b) { return a + b; }\nvar s = 0;\nfor (var i = 0; i < 100000; i++) { s = add(s, i); }"
+    }.get_program();
+    return program;
+}
+
+} /* namespace */
+
+/* the argument selects the budget : 0 none, 1 steps, deadline and a token */
+static void BM_BudgetLoop (benchmark::State& state) {
+    std::shared_ptr<const mlang::script::Program> program = loop_program();
+    for (auto _ : state) {
+        mlang::script::EnvStack env {};
+        if (state.range(0) != 0) {
+            mlang::script::Budget budget {};
+            budget.max_steps = 1000000000;
+            budget.deadline = std::chrono::steady_clock::now() + std::chrono::hours { 1 };
+            budget.cancel = std::make_shared<mlang::script::CancelToken>();
+            env.set_budget(budget);
+        }
+        benchmark::DoNotOptimize(program->execute(env));
+    }
+    /* one iteration and one call per element */
+    state.SetItemsProcessed(state.iterations() * iterations * 2);
+}
+BENCHMARK(BM_BudgetLoop)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <condition_variable>
+
+#include "mlang/runtime/channel.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+constexpr int messages = 100000;
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+/* the usual host-side queue : a deque behind a mutex, sleeping on condition variables */
+class LockedQueue {
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<mlang::object::Object> m_values;
+    std::size_t m_capacity;
+public:
+    explicit LockedQueue (std::size_t capacity) : m_capacity(capacity) {}
+
+    void send (const mlang::object::Object& value) {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        while (m_values.size() >= m_capacity) { m_not_full.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::seconds { 1 }); }
+        m_values.push_back(value.copy());
+        m_not_empty.notify_one();
+    }
+
+    mlang::object::Object recv () {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        while (m_values.empty()) { m_not_empty.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::seconds { 1 }); }
+        mlang::object::Object value = m_values.front();
+        m_values.pop_front();
+        m_not_full.notify_one();
+        return value;
+    }
+};
+
+/* the argument is the number of senders and of receivers */
+template <typename Queue>
+void transfer (benchmark::State& state) {
+    const int pairs = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Queue queue { 256 };
+        std::vector<std::thread> threads;
+        for (int p = 0; p < pairs; ++p) {
+            threads.emplace_back([&queue, pairs] () { for (int i = 0; i < messages / pairs; ++i) { queue.send(make_int(i)); } });
+            threads.emplace_back([&queue, pairs] () { for (int i = 0; i < messages / pairs; ++i) { benchmark::DoNotOptimize(queue.recv()); } });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+    }
+    state.SetItemsProcessed(state.iterations() * messages);
+}
+
+} /* namespace */
+
+static void BM_Channel (benchmark::State& state) { transfer<mlang::runtime::Channel>(state); }
+BENCHMARK(BM_Channel)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_LockedQueue (benchmark::State& state) { transfer<LockedQueue>(state); }
+BENCHMARK(BM_LockedQueue)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "mlang/runtime/event_bus.hpp"
+
+namespace {
+
+constexpr std::size_t subscribers = 10000;
+
+/* every subscriber observes one parameter of its own */
+void subscribe_all (mlang::runtime::EventBus& bus, std::vector<std::string>& topics) {
+    for (std::size_t i = 0; i < subscribers; ++i) {
+        topics.push_back("parameter_" + std::to_string(i));
+        bus.subscribe("observer_" + std::to_string(i), topics.back());
+    }
+}
+
+} /* namespace */
+
+/* parameter changes, every change is consumed before the next one */
+static void BM_PublishConsume (benchmark::State& state) {
+    mlang::runtime::EventBus bus {};
+    std::vector<std::string> topics;
+    subscribe_all(bus, topics);
+    std::vector<std::string> observers;
+    for (std::size_t i = 0; i < subscribers; ++i) { observers.push_back("observer_" + std::to_string(i)); }
+    std::size_t next = 0;
+    std::string topic;
+    for (auto _ : state) {
+        bus.publish(topics[next]);
+        benchmark::DoNotOptimize(bus.poll(observers[next], topic));
+        next = (next + 7919) % subscribers;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PublishConsume);
+
+/* a burst of changes nobody consumed yet, the repeated ones are coalesced */
+static void BM_PublishCoalesced (benchmark::State& state) {
+    mlang::runtime::EventBus bus {};
+    std::vector<std::string> topics;
+    subscribe_all(bus, topics);
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.publish(topics[next]));
+        next = (next + 7919) % subscribers;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PublishCoalesced);
+
+/* one parameter observed by every subscriber */
+static void BM_PublishFanOut (benchmark::State& state) {
+    mlang::runtime::EventBus bus {};
+    for (std::size_t i = 0; i < subscribers; ++i) { bus.subscribe("observer_" + std::to_string(i), "parameter"); }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.publish("parameter"));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(subscribers));
+}
+BENCHMARK(BM_PublishFanOut);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+/* a small rule, evaluated once per input */
+std::shared_ptr<const mlang::script::Program> rule () {
+    static std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { "var r = 0;\nfor (var i = 0; i < 10; i++) { r += n * i; }\nexit r;" }.get_program();
+    return program;
+}
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+constexpr int burst = 2000;
+
+} /* namespace */
+
+/* a burst of evaluations on the pool, the argument is the number of workers */
+static void BM_ExecutorBurst (benchmark::State& state) {
+    std::shared_ptr<const mlang::script::Program> program = rule();
+    mlang::runtime::Executor executor { static_cast<std::size_t>(state.range(0)) };
+    std::vector<mlang::runtime::Job> jobs;
+    jobs.reserve(burst);
+    for (auto _ : state) {
+        for (int n = 0; n < burst; ++n) { jobs.push_back(executor.submit(program, nullptr, { { "n", make_int(n) } })); }
+        for (mlang::runtime::Job& job : jobs) { benchmark::DoNotOptimize(job.get().exit_code); }
+        jobs.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_ExecutorBurst)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/* the same burst with one thread per evaluation */
+static void BM_ThreadPerEvaluation (benchmark::State& state) {
+    std::shared_ptr<const mlang::script::Program> program = rule();
+    std::vector<std::thread> threads;
+    threads.reserve(burst);
+    for (auto _ : state) {
+        for (int n = 0; n < burst; ++n) {
+            threads.emplace_back([program, n] () {
+                mlang::script::EnvStack env {};
+                env.declare_variable("n", mlang::script::builtin_types::none);
+                env.get_variable("n").assign(make_int(n));
+                mlang::object::Object result {};
+                benchmark::DoNotOptimize(program->execute(env, result));
+            });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+        threads.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_ThreadPerEvaluation)->UseRealTime()->Unit(benchmark::kMillisecond);
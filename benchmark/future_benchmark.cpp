@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/runtime/future.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+constexpr int lookups = 20;
+
+/* stands for a host call that waits on I/O, e.g. reading a parameter from a device */
+mlang::object::Object get_parameter (const std::vector<mlang::object::Object>& params) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return mlang::object::Object { std::make_shared<mlang::object::Int>(params[0].get_int()) };
+}
+
+class BlockingParameter : public mlang::func::Function {
+public:
+    mlang::object::Object call (mlang::script::EnvStack& env, std::vector<mlang::object::Object>& params) const override { return get_parameter(params); }
+};
+
+std::shared_ptr<const mlang::script::Program> lookup_program () {
+    static std::shared_ptr<const mlang::script::Program> program = mlang::script::Script {
+        "var pending = {};\n"
+        "for (var i = 0; i < 20; i++) { var v = i; pending += get_parameter(v); }\n"
+        "var values = await(pending);\n"
+        "var sum = 0;\n"
+        "for (var j = 0; j < 20; j++) { sum += values[j]; }"
+    }.get_program();
+    return program;
+}
+
+} /* namespace */
+
+/* the argument selects the host function : 0 blocks the script, 1 runs on the executor and returns a future */
+static void BM_FutureLookups (benchmark::State& state) {
+    std::shared_ptr<const mlang::script::Program> program = lookup_program();
+    mlang::runtime::Executor executor { lookups };
+    const BlockingParameter blocking {};
+    const mlang::runtime::OffloadedFunction offloaded { executor, get_parameter };
+    for (auto _ : state) {
+        mlang::script::EnvStack env {};
+        if (state.range(0) == 0) { env.declare_function("get_parameter", &blocking); }
+        else { env.declare_function("get_parameter", &offloaded); }
+        mlang::runtime::declare_future_functions(env);
+        benchmark::DoNotOptimize(program->execute(env));
+    }
+    state.SetItemsProcessed(state.iterations() * lookups);
+}
+BENCHMARK(BM_FutureLookups)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "mlang/script/lexer.hpp"
+#include "mlang/script/keywords.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/tokenizer/tokenizer.hpp"
+
+#include "script_generator.hpp"
+
+namespace {
+
+void set_throughput (benchmark::State& state, std::size_t bytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.counters["MB"] = benchmark::Counter(static_cast<double>(state.iterations() * bytes) / 1e6, benchmark::Counter::kIsRate);
+}
+
+/* every word of the source that starts like an identifier, keywords included */
+std::vector<std::string> collect_words (const std::string& source) {
+    std::vector<std::string> words;
+    std::size_t i = 0;
+    while (i < source.size()) {
+        const unsigned char c = static_cast<unsigned char>(source[i]);
+        if (!std::isalpha(c) && (c != '_')) {
+            ++i;
+            continue;
+        }
+        const std::size_t start = i;
+        while ((i < source.size()) && (std::isalnum(static_cast<unsigned char>(source[i])) || (source[i] == '_'))) { ++i; }
+        words.emplace_back(source, start, i - start);
+    }
+    return words;
+}
+
+/* the sequential comparison the lexer used before the perfect hash */
+mlang::script::token_types linear_keyword_type (std::string_view word) {
+    for (const mlang::script::Keyword& keyword : mlang::script::keyword_list) {
+        if (keyword.word == word) { return keyword.type; }
+    }
+    return mlang::script::token_types::identifier;
+}
+
+} /* namespace */
+
+/* source text -> final script tokens */
+static void BM_Lexer (benchmark::State& state) {
+    mlang::script::Source source { generate_script(static_cast<std::size_t>(state.range(0))) };
+    for (auto _ : state) {
+        mlang::script::Lexer lexer { source };
+        std::vector<mlang::script::Token> tokens = lexer.tokenize();
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    set_throughput(state, source.get_text().size());
+}
+BENCHMARK(BM_Lexer)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+/* first pass of the old two pass approach, for comparison */
+static void BM_LegacyTokenizer (benchmark::State& state) {
+    const std::string source = generate_script(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        mlang::tokenizer::Tokenizer tokenizer { source };
+        tokenizer.tokenize();
+        benchmark::DoNotOptimize(tokenizer.get_tokens().data());
+    }
+    set_throughput(state, source.size());
+}
+BENCHMARK(BM_LegacyTokenizer)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+static void BM_ScriptConstruct (benchmark::State& state) {
+    const std::string source = generate_script(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        mlang::script::Script script { source };
+        benchmark::DoNotOptimize(script.get_tokens().data());
+    }
+    set_throughput(state, source.size());
+}
+BENCHMARK(BM_ScriptConstruct)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+static std::string write_script_file (std::size_t lines) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / ("mlang_benchmark_" + std::to_string(lines) + ".mlang");
+    std::ofstream file { path, std::ios::binary };
+    file << generate_script(lines);
+    return path.string();
+}
+
+/* loading a script file the way the examples used to : ifstream -> stringstream -> std::string -> Script */
+static void BM_ScriptLoadStream (benchmark::State& state) {
+    const std::string path = write_script_file(static_cast<std::size_t>(state.range(0)));
+    const std::size_t size = std::filesystem::file_size(path);
+    for (auto _ : state) {
+        std::ifstream file { path };
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        mlang::script::Script script { buffer.str() };
+        benchmark::DoNotOptimize(script.get_tokens().data());
+    }
+    set_throughput(state, size);
+}
+BENCHMARK(BM_ScriptLoadStream)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+/* the file is mapped and lexed in place */
+static void BM_ScriptFromFile (benchmark::State& state) {
+    const std::string path = write_script_file(static_cast<std::size_t>(state.range(0)));
+    const std::size_t size = std::filesystem::file_size(path);
+    for (auto _ : state) {
+        mlang::script::Script script = mlang::script::Script::from_file(path);
+        benchmark::DoNotOptimize(script.get_tokens().data());
+    }
+    set_throughput(state, size);
+}
+BENCHMARK(BM_ScriptFromFile)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+/* per word cost of the keyword classification, the words come from the generated script */
+static void BM_KeywordPerfectHash (benchmark::State& state) {
+    const std::vector<std::string> words = collect_words(generate_script(1000));
+    for (auto _ : state) {
+        for (const std::string& word : words) {
+            mlang::script::token_types type = mlang::script::keyword_type(word);
+            benchmark::DoNotOptimize(type);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * words.size()));
+}
+BENCHMARK(BM_KeywordPerfectHash);
+
+static void BM_KeywordLinear (benchmark::State& state) {
+    const std::vector<std::string> words = collect_words(generate_script(1000));
+    for (auto _ : state) {
+        for (const std::string& word : words) {
+            mlang::script::token_types type = linear_keyword_type(word);
+            benchmark::DoNotOptimize(type);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * words.size()));
+}
+BENCHMARK(BM_KeywordLinear);
+
+/* per token cost of the whole lexer */
+static void BM_LexerPerToken (benchmark::State& state) {
+    mlang::script::Source source { generate_script(1000) };
+    std::size_t token_count = 0;
+    for (auto _ : state) {
+        mlang::script::Lexer lexer { source };
+        std::vector<mlang::script::Token> tokens = lexer.tokenize();
+        token_count = tokens.size();
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * token_count));
+}
+BENCHMARK(BM_LexerPerToken);
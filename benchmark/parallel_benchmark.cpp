@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <memory>
+
+#include "mlang/runtime/parallel.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/program.hpp"
+
+namespace {
+
+/* a function with some work per element and 10000 elements, only the map is measured */
+const std::string prelude =
+    "function work(x) { var r = 0; for (var i = 0; i < 20; i++) { r += x * i; } return r; }\n"
+    "var arr = {};\n"
+    "for (var i = 0; i < 10000; i++) { var v = i; arr += v; }\n";
+
+} /* namespace */
+
+/* parallel_map, the argument is the number of workers besides the calling thread */
+static void BM_ParallelMap (benchmark::State& state) {
+    mlang::runtime::Executor executor { static_cast<std::size_t>(state.range(0)) };
+    mlang::runtime::ParallelFunctions parallel { executor };
+    /* the functions of the setup live in its program, it has to outlive the environment */
+    std::shared_ptr<const mlang::script::Program> setup = mlang::script::Script { prelude }.get_program();
+    std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { "parallel_map(arr, \"work\");" }.get_program();
+    mlang::script::EnvStack env {};
+    parallel.declare_functions(env);
+    setup->execute(env);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(program->execute(env));
+    }
+    state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_ParallelMap)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/* the same map as a loop in the script */
+static void BM_SequentialMap (benchmark::State& state) {
+    std::shared_ptr<const mlang::script::Program> setup = mlang::script::Script { prelude + "var out = {};\nvar j = 0;\n" }.get_program();
+    std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { "out = {};\nfor (j = 0; j < 10000; j++) { out += work(arr[j]); }\n" }.get_program();
+    mlang::script::EnvStack env {};
+    setup->execute(env);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(program->execute(env));
+    }
+    state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_SequentialMap)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+/* generates a syntactically valid script of roughly 'lines' lines */
+/* functions, declarations, control flow, strings and comments, like a typical rule file */
+inline std::string generate_script (std::size_t lines) {
+    std::string script;
+    script.reserve(lines * 48);
+    std::size_t line_count = 0;
+    for (std::size_t i = 0; line_count < lines; ++i) {
+        const std::string id = std::to_string(i);
+        script += "/* rule " + id + " : running total of the parameters */\n";
+        script += "function rule_" + id + " (first, second) {\n";
+        script += "    var total_" + id + " = first * 2 + second / 3.5;\n";
+        script += "    if (total_" + id + " >= 10 && second != 0) { total_" + id + " += 1; }\n";
+        script += "    else if (total_" + id + " < 0) { total_" + id + " -= 1; }\n";
+        script += "    else { total_" + id + " = 0; }\n";
+        script += "    for (var k = 0; k < 10; ++k) { total_" + id + " = total_" + id + " + k; }\n";
+        script += "    print(\"rule %s produced %f\\n\", \"rule_" + id + "\", total_" + id + ");\n";
+        script += "    return total_" + id + ";\n";
+        script += "}\n";
+        line_count += 10;
+    }
+    return script;
+}
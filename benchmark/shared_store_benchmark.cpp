@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mlang/runtime/shared_store.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+constexpr int parameters = 256;
+/* one write for every 1000 reads */
+constexpr int reads_per_write = 1000;
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+const std::vector<std::string>& parameter_names () {
+    static const std::vector<std::string> names = [] () {
+        std::vector<std::string> list;
+        for (int i = 0; i < parameters; ++i) { list.push_back("device.parameter." + std::to_string(i)); }
+        return list;
+    }();
+    return names;
+}
+
+/* what the hosts do today, one map behind one mutex */
+class LockedMap {
+private:
+    std::mutex m_mutex;
+    std::map<std::string, mlang::object::Object, std::less<>> m_values;
+public:
+    mlang::object::Object get (const std::string& key) {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        const auto it = m_values.find(key);
+        return (it != m_values.end()) ? it->second.copy() : mlang::object::Object {};
+    }
+
+    void set (const std::string& key, const mlang::object::Object& value) {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_values.insert_or_assign(key, value.copy());
+    }
+};
+
+mlang::runtime::SharedStore& shared_store () {
+    static mlang::runtime::SharedStore store = [] () {
+        mlang::runtime::SharedStore opened { "benchmark" };
+        for (int i = 0; i < parameters; ++i) { opened.set(parameter_names()[i], make_int(i)); }
+        return opened;
+    }();
+    return store;
+}
+
+LockedMap& locked_map () {
+    static LockedMap* map = [] () {
+        LockedMap* filled = new LockedMap {};
+        for (int i = 0; i < parameters; ++i) { filled->set(parameter_names()[i], make_int(i)); }
+        return filled;
+    }();
+    return *map;
+}
+
+template <typename Store>
+void read_mostly (benchmark::State& state, Store& store) {
+    const std::vector<std::string>& names = parameter_names();
+    std::size_t index = static_cast<std::size_t>(state.thread_index()) * 7;
+    for (auto _ : state) {
+        for (int i = 0; i < reads_per_write; ++i) {
+            benchmark::DoNotOptimize(store.get(names[index % parameters]));
+            index += 13;
+        }
+        store.set(names[index % parameters], make_int(static_cast<int>(index)));
+    }
+    state.SetItemsProcessed(state.iterations() * (reads_per_write + 1));
+}
+
+} /* namespace */
+
+static void BM_SharedStoreReadMostly (benchmark::State& state) { read_mostly(state, shared_store()); }
+BENCHMARK(BM_SharedStoreReadMostly)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_LockedMapReadMostly (benchmark::State& state) { read_mostly(state, locked_map()); }
+BENCHMARK(BM_LockedMapReadMostly)->ThreadRange(1, 8)->UseRealTime();
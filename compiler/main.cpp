@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "mlang/script/script.hpp"
+#include "mlang/exception.hpp"
+
+/* precompiles scripts so that they can be loaded with Script::load without lexing and parsing */
+/* mlangc [-o output] script... : every script is written next to itself with the extension .mlangc */
+int main(int argc, char* argv[]) {
+    std::string output_path;
+    std::vector<std::string> script_paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg { argv[i] };
+        if (arg == "-o") {
+            if (i + 1 >= argc) {
+                std::cerr << "ERROR : '-o' needs an output path" << std::endl;
+                return 1;
+            }
+            output_path = argv[++i];
+        }
+        else {
+            script_paths.push_back(arg);
+        }
+    }
+    if (script_paths.empty()) {
+        std::cerr << "ERROR : usage : mlangc [-o output] script..." << std::endl;
+        return 1;
+    }
+    if (!output_path.empty() && (script_paths.size() != 1)) {
+        std::cerr << "ERROR : '-o' can only be used with a single script" << std::endl;
+        return 1;
+    }
+
+    for (const std::string& script_path : script_paths) {
+        std::string target = output_path;
+        if (target.empty()) {
+            std::filesystem::path path { script_path };
+            path.replace_extension(".mlangc");
+            target = path.string();
+        }
+        try {
+            mlang::script::Script script = mlang::script::Script::from_file(script_path);
+            script.save(target);
+        }
+        catch (const mlang::SyntaxError& e) {
+            std::cerr << "ERROR : " << script_path << " : " << e.what() << std::endl;
+            return 1;
+        }
+        catch (const mlang::RuntimeError& e) {
+            std::cerr << "ERROR : " << script_path << " : " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
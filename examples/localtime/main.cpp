@@ -1,7 +1,5 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
 #include <filesystem>
 #include <chrono>
 
@@ -10,30 +8,7 @@
 #include "mlang/script/script.hpp"
 #include "mlang/func/function.hpp"
 #include "mlang/script/environment.hpp"
-
-/**
- *  parameters:
- *     - path (String)
- **/
-class FuncReadFile : public mlang::func::Function {
-public:
-    mlang::object::Object call (mlang::script::EnvStack& env, std::vector<mlang::object::Object>& params) const override {
-        if (params.size() != 1) { throw mlang::RuntimeError{ "FuncReadFile expects 1 parameters"}; }
-        if (params[0].get_typename() != mlang::object::String::type_name) {
-            throw mlang::RuntimeError{ "FuncReadFile expects the 1st parameter to be of type " + mlang::object::String::type_name};
-        }
-        std::string path { params[0].get_string() };
-        std::ifstream file { path };
-        if (!file.is_open()) {
-            throw mlang::RuntimeError{ "FuncReadFile could not open file " + path };
-        }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        file.close();
-
-        return mlang::object::Object {std::make_shared<mlang::object::String>(buffer.str())};
-    }
-};
+#include "mlang/script/file.hpp"
 
 /**
  *  parameters:
@@ -66,17 +41,10 @@ int main(int argc, char* argv[]) {
     std::filesystem::path p { executable_path };
     p.replace_filename("script.mlang");
 
-    std::ifstream file { p };
-    if (!file.is_open()) return 1;
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
-
-    mlang::script::Script script { buffer.str() };
+    mlang::script::Script script = mlang::script::Script::from_file(p.string());
     mlang::script::EnvStack env {};
-    FuncReadFile fileReadFunc {};
     FuncSetParameter setParamFunc {};
-    env.declare_function("read_file", &fileReadFunc);
+    mlang::script::declare_file_functions(env);
     env.declare_function("set_parameter", &setParamFunc);
     script.execute(env);
 
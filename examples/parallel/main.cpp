@@ -1,75 +1,43 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
 #include <filesystem>
-#include <chrono>
-#include <thread>
 
 #include "mlang/script/script.hpp"
-#include "mlang/func/function.hpp"
 #include "mlang/script/environment.hpp"
-
-#include "helper_functions.hpp"
+#include "mlang/script/output_writer.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/runtime/event_bus.hpp"
 
 std::string executable_path;
 
-FuncObserverRegister observerRegisterFunc {};
-FuncNotificationWait notificationWaitFunc {};
-FuncSetParameter setParamFunc {};
-FuncSleep sleepFunc {};
-
-void script_1 () {
-    std::filesystem::path path { executable_path };
-    path.replace_filename("script_1.mlang");
-
-    std::ifstream file { path };
-    if (!file.is_open()) exit(1);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+/* both scripts print through their own channel, the lines of the two never interleave */
+mlang::script::OutputWriter writer { std::make_shared<mlang::script::StreamSink>(std::cout) };
 
-    mlang::script::EnvStack env {};
-
-    env.declare_function("register_observer", &observerRegisterFunc);
-    env.declare_function("wait_for_notification", &notificationWaitFunc);
-    env.declare_function("set_parameter", &setParamFunc);
-    env.declare_function("sleep", &sleepFunc);
-
-    mlang::script::Script script { buffer.str() };
-    script.execute(env);
-}
+/* script_1 publishes parameter changes, script_2 waits for them */
+mlang::runtime::EventBus bus {};
 
-void script_2 () {
+void spawn (mlang::runtime::EventLoop& loop, const std::string& file_name) {
     std::filesystem::path path { executable_path };
-    path.replace_filename("script_2.mlang");
-
-    std::ifstream file { path };
-    if (!file.is_open()) exit(1);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
-
-    mlang::script::EnvStack env {};
-
-    env.declare_function("register_observer", &observerRegisterFunc);
-    env.declare_function("wait_for_notification", &notificationWaitFunc);
-    env.declare_function("set_parameter", &setParamFunc);
-    env.declare_function("sleep", &sleepFunc);
-
-    mlang::script::Script script { buffer.str() };
-    script.execute(env);
+    path.replace_filename(file_name);
+
+    mlang::script::Script script = mlang::script::Script::from_file(path.string());
+    loop.spawn(script.get_program(), [] (mlang::script::EnvStack& env) {
+        env.set_output(writer.open_channel(), 0);
+        bus.declare_functions(env);
+        mlang::runtime::declare_event_loop_functions(env);
+    });
 }
 
-
 int main(int argc, char* argv[]) {
     executable_path = std::string{ argv[0] };
 
-    std::thread t1 ( script_1 );
-    std::thread t2 ( script_2 );
+    /* both scripts share this thread, a script that sleeps or waits is parked */
+    mlang::runtime::EventLoop loop {};
+    /* a script that loops without waiting still lets the other one run */
+    loop.set_time_slice(10000);
+    spawn(loop, "script_1.mlang");
+    spawn(loop, "script_2.mlang");
+    loop.run();
 
-    t1.join();
-    t2.join();
-    
     return 0;
-}
\ No newline at end of file
+}
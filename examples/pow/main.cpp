@@ -1,7 +1,5 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
 #include <filesystem>
 
 #include "mlang/script/script.hpp"
@@ -12,13 +10,7 @@ int main(int argc, char* argv[]) {
     std::filesystem::path p { executable_path };
     p.replace_filename("script.mlang");
 
-    std::ifstream file { p };
-    if (!file.is_open()) return 1;
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
-
-    mlang::script::Script script { buffer.str() };
+    mlang::script::Script script = mlang::script::Script::from_file(p.string());
     mlang::script::EnvStack env {};
     script.execute(env);
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "mlang/ast/node.hpp"
 
 namespace mlang {
@@ -7,10 +9,11 @@ namespace ast {
 
 class ConstructorNode : public Node {
 private:
-    std::string m_type_name;
+    std::string_view m_type_name;
+    mutable std::atomic<script::type_id> m_type { script::unknown_type };   /* resolved by the first execution */
     std::vector<node_ptr> m_arguments;
 public:
-    ConstructorNode(const std::string& type_name);
+    ConstructorNode(std::string_view type_name);
     ~ConstructorNode () = default;
     object::Object execute (script::EnvStack& env) const override;
     void add_argument (node_ptr argument);
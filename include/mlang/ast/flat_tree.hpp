@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <span>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
+#include "mlang/ast/node.hpp"
+#include "mlang/object/format.hpp"
+#include "mlang/script/source.hpp"
+#include "mlang/func/function.hpp"
+
+namespace mlang {
+namespace ast {
+
+/* index of a node in a FlatTree */
+typedef std::uint32_t node_index;
+
+inline constexpr node_index no_node { 0xFFFFFFFF };
+
+/* version of the serialized format written by FlatTree::serialize, bumped on every incompatible change */
+inline constexpr std::uint32_t program_format_version { 1 };
+
+/* 16 bytes, the meaning of a, b and c depends on the type :                                   */
+/*   value        : a = constant                    variable, declaration : a = name, b = init  */
+/*   array        : c = list                        constructor           : a = name, c = list  */
+/*   unary_not, unary_minus, return_node, exit_node : a = operand                              */
+/*   prefix, postfix : a = operand, b = 0 increment / 1 decrement                              */
+/*   binary_arith, comparison, logic, assignment : a = left, b = right, c = mode               */
+/*   subscript    : a = object, b = index           member_access : a = object, b = member      */
+/*   member_func  : a = object, b = member, c = list                                           */
+/*   func_call    : a = name, c = list              func_decl     : a = function               */
+/*   main, block  : c = list                        while_statement : a = condition, b = body   */
+/*   if_statement : a = else body, c = list of condition and body pairs                        */
+/*   for_statement : c = list of initialization, test, update and body                         */
+/*   print, format : a = format, c = list                                                      */
+struct FlatNode {
+    ast_node_types type { ast_node_types::none };
+    std::uint32_t a { 0 };
+    std::uint32_t b { 0 };
+    std::uint32_t c { 0 };
+};
+
+class FlatTree;
+
+/* function declared in a FlatTree, the tree must outlive the environments it was declared in */
+class FlatFunction : public func::Function {
+private:
+    const FlatTree* m_tree { nullptr };
+    std::uint32_t m_name { 0 };
+    std::uint32_t m_params { 0 };    /* list of names */
+    node_index m_body { no_node };
+
+    friend class FlatTree;
+public:
+    FlatFunction (const FlatTree* tree, std::uint32_t name, std::uint32_t params, node_index body);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* AST stored contiguously : every node lives in one vector, children are 32 bit indices */
+/* lists of children are stored in a second vector as a count followed by the indices */
+/* the whole tree is released with a handful of frees, independent of the number of nodes */
+/* built by parser::FlatParser, executes exactly like the node tree */
+class FlatTree {
+private:
+    std::vector<FlatNode> m_nodes;
+    std::vector<std::uint32_t> m_lines;          /* line of the statement a node starts, 0 for expressions */
+    std::vector<std::uint32_t> m_lists;
+    std::vector<object::Object> m_constants;
+    std::vector<std::string_view> m_names;       /* refer into the source */
+    std::vector<std::string> m_members;          /* owned, the object interface looks members up by std::string */
+    std::vector<object::Format> m_formats;
+    std::vector<std::string_view> m_format_rules;
+    std::deque<FlatFunction> m_functions;        /* the environments keep pointers to them */
+    std::shared_ptr<const script::Source> m_source;
+    node_index m_root { no_node };
+
+    std::span<const std::uint32_t> list (std::uint32_t offset) const;
+    void evaluate_list (std::uint32_t offset, script::EnvStack& env, std::vector<object::Object>& values) const;
+    /* the larger cases live in their own functions, it keeps the frame of the recursive evaluate small */
+    object::Object evaluate_array (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_constructor (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_arithmetic (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_comparison (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_logic (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_assignment (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_member_call (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_call (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_declaration (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_print (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_format (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_if (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_for (const FlatNode& node, script::EnvStack& env) const;
+    object::Object evaluate_while (const FlatNode& node, script::EnvStack& env) const;
+
+    friend class FlatFunction;
+public:
+    FlatTree () = default;
+    FlatTree (const FlatTree&) = delete;
+    FlatTree& operator= (const FlatTree&) = delete;
+    ~FlatTree () = default;
+
+    node_index add_node (ast_node_types type, std::uint32_t a = 0, std::uint32_t b = 0, std::uint32_t c = 0);
+    std::uint32_t add_list (std::span<const node_index> items);
+    std::uint32_t add_constant (object::Object value);
+    std::uint32_t add_name (std::string_view name);
+    std::uint32_t add_member (std::string_view member);
+    std::uint32_t add_format (std::string_view rule, object::Format format);
+    std::uint32_t add_function (std::uint32_t name, std::uint32_t params, node_index body);
+    void set_line (node_index index, std::uint32_t line);
+    void set_root (node_index root);
+    void set_source (std::shared_ptr<const script::Source> source);
+
+    const FlatNode& get_node (node_index index) const;
+    std::size_t get_node_count () const;
+    node_index get_root () const;
+    std::uint32_t get_line (node_index index) const;
+
+    /* appends the versioned binary form of the tree to 'out', the source text is not part of it */
+    void serialize (std::string& out) const;
+    /* rebuilds a tree from the output of serialize without parsing anything */
+    /* every index is checked, throws RuntimeError if the data is truncated, corrupt or of another version */
+    /* names and string constants refer into 'data', which is kept alive by the tree */
+    static std::unique_ptr<FlatTree> deserialize (std::shared_ptr<const script::Source> data);
+
+    object::Object evaluate (node_index index, script::EnvStack& env) const;
+    object::Object execute (script::EnvStack& env) const;
+};
+
+} /* namespace ast */
+} /* namespace mlang */
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "mlang/ast/node.hpp"
+#include "mlang/object/format.hpp"
+
+namespace mlang {
+namespace ast {
+
+/* format("...", args...) -> String, the rule is compiled once at parse time */
+class FormatNode : public Node {
+private:
+    std::string_view m_rule;
+    object::Format m_format;
+    std::vector<node_ptr> m_args;
+public:
+    FormatNode();
+    ~FormatNode () = default;
+    object::Object execute (script::EnvStack& env) const override;
+    void set_rule (std::string_view rule);
+    /* takes a rule the caller already compiled */
+    void set_format (std::string_view rule, object::Format format);
+    void add_argument (node_ptr arg);
+    /* true if the number of arguments matches the placeholders of the rule */
+    bool is_valid () const;
+    void print () const override;
+};
+
+} /* namespace ast */
+} /* namespace mlang */
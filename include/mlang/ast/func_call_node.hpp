@@ -7,10 +7,10 @@ namespace ast {
 
 class FunctionCallNode : public Node {
 private:
-    std::string m_name;
+    std::string_view m_name;
     std::vector<node_ptr> m_params;
 public:
-    FunctionCallNode(const std::string& name);
+    FunctionCallNode(std::string_view name);
     ~FunctionCallNode () = default;
     const std::vector<node_ptr>& get_params () const;
     object::Object execute (script::EnvStack& env) const override;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <mutex>
+#include <atomic>
+#include <functional>
+
 #include "mlang/ast/node.hpp"
 #include "mlang/func/function.hpp"
 
@@ -7,15 +11,27 @@ namespace mlang {
 namespace ast {
 
 class FunctionDeclNode : public Node, public func::Function {
+public:
+    /* builds the body from its tokens, may throw SyntaxError */
+    typedef std::function<node_ptr ()> body_compiler;
 private:
-    std::string m_name;
-    node_ptr m_body;
-    std::vector<std::string> m_params;
+    std::string_view m_name;
+    std::vector<std::string_view> m_params;
+    /* a lazy body is compiled by the first call, calls from other threads wait for it */
+    mutable node_ptr m_body;
+    mutable body_compiler m_compile;
+    mutable std::mutex m_compile_mutex;
+    mutable std::atomic<const Node*> m_compiled { nullptr };
+
+    const Node& get_body () const;
 public:
-    FunctionDeclNode (const std::string& name);
+    FunctionDeclNode (std::string_view name);
     ~FunctionDeclNode () = default;
     void set_body (node_ptr body);
-    void add_parameter (const std::string& param);
+    /* the body is compiled on the first call, a function that is never called is never compiled */
+    void set_body (body_compiler compile);
+    bool is_compiled () const;
+    void add_parameter (std::string_view param);
     object::Object execute (script::EnvStack& env) const override;
     object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
     void print () const override;
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "mlang/ast/node.hpp"
+#include "mlang/script/source.hpp"
+
+#include <memory>
 
 namespace mlang {
 namespace ast {
 
 class MainNode : public Node {
 private:
+    std::shared_ptr<const script::Source> m_source;   /* the names and literals of the tree refer into it */
     std::vector<node_ptr> m_nodes;
 public:
     MainNode();
@@ -14,6 +18,7 @@ public:
     const std::vector<node_ptr>& get_nodes () const;
     object::Object execute (script::EnvStack& env) const override;
     void add_node (node_ptr node);
+    void set_source (std::shared_ptr<const script::Source> source);
     void print () const override;
 };
 
@@ -8,9 +8,9 @@ namespace ast {
 class MemberAccessNode : public Node {
 private:
     node_ptr m_lhs;
-    std::string m_member_name;
+    std::string m_member_name;   /* owned, the object interface looks members up by std::string */
 public:
-    MemberAccessNode(node_ptr lhs, const std::string& member_name);
+    MemberAccessNode(node_ptr lhs, std::string_view member_name);
     ~MemberAccessNode () = default;
     object::Object execute (script::EnvStack& env) const override;
     void print () const override;
@@ -8,10 +8,10 @@ namespace ast {
 class MemberFunctionNode : public Node {
 private:
     node_ptr m_lhs;
-    std::string m_func_name;
+    std::string m_func_name;   /* owned, the object interface looks members up by std::string */
     std::vector<node_ptr> m_params;
 public:
-    MemberFunctionNode(node_ptr lhs, const std::string& func_name);
+    MemberFunctionNode(node_ptr lhs, std::string_view func_name);
     ~MemberFunctionNode () = default;
     const std::vector<node_ptr>& get_params () const;
     object::Object execute (script::EnvStack& env) const override;
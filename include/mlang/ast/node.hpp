@@ -30,6 +30,7 @@ enum class ast_node_types {
     while_statement,
     comparison,
     print,
+    format,
     break_node,
     continue_node,
     return_node,
@@ -1,28 +1,28 @@
 #pragma once
 
 #include "mlang/ast/node.hpp"
+#include "mlang/object/format.hpp"
 
 namespace mlang {
 namespace ast {
 
 class PrintNode : public Node {
 private:
-    std::string m_rule;
+    std::string_view m_rule;
+    object::Format m_format;
     std::vector<node_ptr> m_args;
-    mutable std::size_t m_index { 0 };
-
-    std::string get_integer (script::EnvStack& env) const;
-    std::string get_string (script::EnvStack& env) const;
-    std::string get_float (script::EnvStack& env) const;
-    std::string get_bool (script::EnvStack& env) const;
 public:
     PrintNode();
     ~PrintNode () = default;
     object::Object execute (script::EnvStack& env) const override;
-    void set_rule (const std::string& rule);
+    void set_rule (std::string_view rule);
+    /* takes a rule the caller already compiled */
+    void set_format (std::string_view rule, object::Format format);
     void add_argument (node_ptr arg);
+    /* true if the number of arguments matches the placeholders of the rule */
+    bool is_valid () const;
     void print () const override;
 };
 
 } /* namespace ast */
-} /* namespace mlang */
\ No newline at end of file
+} /* namespace mlang */
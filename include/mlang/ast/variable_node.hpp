@@ -7,11 +7,11 @@ namespace ast {
 
 class VariableNode : public Node {
 private:
-    std::string m_var_name;
+    std::string_view m_var_name;
 public:
-    VariableNode(const std::string& var_name);
+    VariableNode(std::string_view var_name);
     ~VariableNode () = default;
-    const std::string& get_var_name () const;
+    std::string_view get_var_name () const;
     object::Object execute (script::EnvStack& env) const override;
     void print () const override;
 };
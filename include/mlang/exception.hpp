@@ -36,4 +36,25 @@ public:
     RuntimeError (const std::string& message) : m_message(message) {}
 };
 
+enum class budget_limit {
+    steps,
+    deadline,
+    cancelled
+};
+
+/* the script ran out of its script::Budget, not an error of the script itself */
+class BudgetExceeded : public LangException {
+private:
+    budget_limit m_limit;
+    std::string m_message;
+public:
+    const char* what () const noexcept override {
+        return m_message.c_str();
+    }
+
+    BudgetExceeded (budget_limit limit, const std::string& message) : m_limit(limit), m_message(message) {}
+
+    budget_limit get_limit () const { return m_limit; }
+};
+
 } /* namespace mlang */
\ No newline at end of file
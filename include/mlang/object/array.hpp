@@ -16,9 +16,12 @@ private:
 public:
     Array () = default;
     Array (const std::vector<Object>& arr);
+    Array (std::vector<Object>&& arr);
     ~Array () = default;
     
     std::string get_typename () const override;
+
+    const std::vector<Object>& get_elements () const;
     
     const static inline std::string type_name { "Array" };
 
@@ -41,12 +44,14 @@ public:
     Object& operator_subscript (const std::shared_ptr<InternalObject> param) override;
 
     std::shared_ptr<InternalObject> reverse ();
+    std::shared_ptr<InternalObject> to_json ();
 
 
     std::shared_ptr<InternalObject> call (const std::string& func, const std::vector<std::shared_ptr<InternalObject>>& params) override;
     std::shared_ptr<InternalObject> access (const std::string& member) override;
 
     std::string get_string () const override;
+    void serialize (Serializer& serializer) const override;
 };
 
 class ArrayFactory : public ObjectFactory {
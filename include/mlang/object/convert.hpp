@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace mlang {
+namespace object {
+
+/* numeric <-> text conversions, built on std::from_chars / std::to_chars (no locale, no exceptions) */
+
+/* appends the decimal representation of the value */
+void append_int (std::string& str, int value);
+
+/* appends the shortest representation of the value that parses back to the same double, e.g. 0.1 -> "0.1", 5.0 -> "5.0" */
+void append_float (std::string& str, double value);
+
+/* appends the value in fixed notation with the given number of decimals (printf "%.Nf") */
+void append_float (std::string& str, double value, int precision);
+
+std::string format_int (int value);
+std::string format_float (double value);
+
+/* the whole string must be consumed, surrounding whitespace and a leading '+' are accepted */
+/* base 16 and base 2 also accept the '0x' and '0b' prefixes */
+/* returns false if the string is not a valid number or it is out of range, 'value' is left untouched in that case */
+bool parse_int (std::string_view str, int& value, int base = 10);
+bool parse_float (std::string_view str, double& value);
+
+} /* namespace object */
+} /* namespace mlang */
@@ -62,6 +62,7 @@ public:
     std::shared_ptr<InternalObject> access (const std::string& member) override;
 
     std::string get_string () const override;
+    void serialize (Serializer& serializer) const override;
     std::string get_typename () const override;
     int get_int () const override;
     double get_float () const override;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlang/object/object.hpp"
+
+namespace mlang {
+namespace object {
+
+/* format string compiled once into literal and argument segments */
+/* %d -> Int, %f -> Float, %b -> Boolean, %s -> String, %% -> '%', anything else is copied as is */
+/* an argument can have flags, a width and a precision : %[-][0][width][.precision](d|f|b|s) */
+/*   '-' aligns to the left, '0' pads numbers with zeros instead of spaces */
+/*   the precision is the number of decimals for %f (default 6) and the maximum length for %s */
+class Format {
+public:
+    enum class segment_types {
+        literal,
+        integer,
+        floating,
+        boolean,
+        string
+    };
+
+    struct Segment {
+        segment_types type { segment_types::literal };
+        std::size_t offset { 0 };   /* literal : position in the literal buffer */
+        std::size_t length { 0 };   /* literal : number of characters */
+        std::size_t width { 0 };    /* argument : minimum number of characters */
+        int precision { -1 };       /* argument : -1 if not given */
+        bool left { false };
+        bool zero { false };
+    };
+
+    static constexpr std::size_t max_width { 1024 };
+private:
+    std::string m_literals;
+    std::vector<Segment> m_segments;
+    std::size_t m_argument_count { 0 };
+    std::size_t m_size_hint { 0 };
+
+    void add_literal (char ch);
+    void add_argument (const Segment& segment);
+    /* parses the argument starting after the '%' at 'pos', returns the position of its last character or 0 */
+    std::size_t parse_argument (std::string_view rule, std::size_t pos);
+    void write_segments (std::string& out, const std::vector<Object>& args) const;
+public:
+    Format () = default;
+    Format (std::string_view rule);
+    ~Format () = default;
+
+    std::size_t get_argument_count () const;
+    const std::vector<Segment>& get_segments () const;
+
+    /* number of characters the literal segments produce, a lower bound for the output size */
+    std::size_t get_literal_length () const;
+    /* expected output size, used to size the buffer once up front */
+    std::size_t get_size_hint () const;
+
+    /* appends the formatted text to 'out', throws RuntimeError if the argument count does not match */
+    /* 'out' is left as it was if an argument fails to convert */
+    void write (std::string& out, const std::vector<Object>& args) const;
+    std::string format (const std::vector<Object>& args) const;
+};
+
+} /* namespace object */
+} /* namespace mlang */
@@ -13,6 +13,7 @@ namespace object {
 class ObjectFactory;
 class Object;
 class InternalObject;
+class Serializer;
 
 typedef std::shared_ptr<InternalObject> internal_obj_ptr;
 
@@ -35,6 +36,9 @@ public:
     virtual int get_int () const;
     virtual std::string get_string () const;
 
+    /* describes the value to the serializer, host types can override it, see object::Serializer */
+    virtual void serialize (Serializer& serializer) const;
+
     virtual const ObjectFactory& get_factory () const = 0;
 
     /* += */
@@ -29,6 +29,7 @@ public:
     std::shared_ptr<InternalObject> access (const std::string& member) override;
 
     std::string get_string () const override;
+    void serialize (Serializer& serializer) const override;
     std::string get_typename () const override;
 };
 
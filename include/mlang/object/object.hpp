@@ -33,17 +33,23 @@ public:
 
     void construct (const std::vector<Object>& params);
     void assign (const Object& param);
+    /* a new object with its own value, nothing is shared with this one */
+    Object copy () const;
     void destruct ();
     std::string get_typename () const;
     const ObjectFactory& get_factory () const;
+    /* the wrapped value, for host code that needs a specific type */
+    const internal_obj_ptr& get_internal () const;
 
     bool is_lvalue () const;
     void set_lvalue (bool lvalue);
 
     bool is_true () const;
+    bool is_none () const;
     int get_int () const;
     double get_float () const;
     std::string get_string () const;
+    void serialize (Serializer& serializer) const;
 
     /* += */
     Object& operator_add_equal (const Object& rhs);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <ostream>
+
+#include "mlang/object/internal_object.hpp"
+
+namespace mlang {
+namespace object {
+
+/* writes a value in one pass, the objects describe themselves through InternalObject::serialize */
+/* the output is either appended to a string, written to a stream in chunks, or only measured */
+/* derived classes define the format */
+class Serializer {
+private:
+    std::string* m_out { nullptr };
+    std::ostream* m_stream { nullptr };
+    std::string m_chunk;
+    std::string m_scratch;
+    std::size_t m_size { 0 };
+protected:
+    void append (std::string_view data);
+    void append (char ch);
+    void append_int (int value);
+    void append_float (double value);
+public:
+    static constexpr std::size_t stream_chunk_size { 4096 };
+
+    /* only counts the characters, see get_size() */
+    Serializer ();
+    Serializer (std::string& out);
+    Serializer (std::ostream& stream);
+    Serializer (const Serializer&) = delete;
+    Serializer& operator= (const Serializer&) = delete;
+    /* writes the rest of the chunk into the stream */
+    virtual ~Serializer ();
+
+    void value (const InternalObject& obj);
+    void value (const Object& obj);
+    void flush ();
+
+    /* number of characters produced so far */
+    std::size_t get_size () const;
+
+    virtual void write_none () = 0;
+    virtual void write_bool (bool value) = 0;
+    virtual void write_int (int value) = 0;
+    virtual void write_float (double value) = 0;
+    virtual void write_string (std::string_view value) = 0;
+    /* begin_array, then next_element before every element, then end_array */
+    virtual void begin_array (std::size_t size) = 0;
+    virtual void next_element (std::size_t index) = 0;
+    virtual void end_array (std::size_t size) = 0;
+    /* objects without their own serialize, written as their string representation by default */
+    virtual void write_opaque (const InternalObject& obj);
+};
+
+/* the form get_string() produces, e.g. Array : { 1 two 3.5 } */
+class DebugSerializer : public Serializer {
+public:
+    using Serializer::Serializer;
+
+    void write_none () override;
+    void write_bool (bool value) override;
+    void write_int (int value) override;
+    void write_float (double value) override;
+    void write_string (std::string_view value) override;
+    void begin_array (std::size_t size) override;
+    void next_element (std::size_t index) override;
+    void end_array (std::size_t size) override;
+};
+
+/* JSON, None and non finite floats become null */
+class JsonSerializer : public Serializer {
+public:
+    using Serializer::Serializer;
+
+    void write_none () override;
+    void write_bool (bool value) override;
+    void write_int (int value) override;
+    void write_float (double value) override;
+    void write_string (std::string_view value) override;
+    void begin_array (std::size_t size) override;
+    void next_element (std::size_t index) override;
+    void end_array (std::size_t size) override;
+};
+
+/* exact size of the serialized form */
+template <typename Format>
+std::size_t measure (const InternalObject& obj) {
+    Format serializer {};
+    serializer.value(obj);
+    return serializer.get_size();
+}
+
+/* measures first, so the result is allocated only once */
+template <typename Format>
+std::string serialize (const InternalObject& obj) {
+    std::string out;
+    out.reserve(measure<Format>(obj));
+    Format serializer { out };
+    serializer.value(obj);
+    return out;
+}
+
+template <typename Format>
+void serialize (const InternalObject& obj, std::ostream& stream) {
+    Format serializer { stream };
+    serializer.value(obj);
+    serializer.flush();
+}
+
+} /* namespace object */
+} /* namespace mlang */
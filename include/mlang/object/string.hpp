@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
 #include <algorithm>
 
 #include "mlang/object/internal_object.hpp"
@@ -11,15 +13,31 @@ namespace object {
 
 class String : public InternalObject {
 private:
-    std::string m_value;
+    mutable std::string m_value;
+    mutable bool m_copied { false };      /* a viewed text was copied into m_value by get */
+    /* a string can refer to text it does not own (mapped file, script source) -> no copy until it is modified */
+    std::string_view m_view;
+    std::shared_ptr<const void> m_owner;   /* keeps the viewed text alive, nullptr if the string owns its text */
+
+    void own ();
+    std::shared_ptr<String> substring_of (std::string_view part) const;
 public:
     String () = default;
     String (const std::string& value);
+    String (std::string&& value);
+    /* refers to 'value' as long as it is not modified, 'owner' must keep the text alive */
+    String (std::string_view value, std::shared_ptr<const void> owner);
     ~String () = default;
     
     const static inline std::string type_name { "String" };
 
+    /* a viewed text is copied once and the copy is kept, the string still refers to the viewed text */
+    /* not safe to call from several threads at once on the same viewed string */
     const std::string& get () const;
+    /* the current text without copying it */
+    std::string_view view () const;
+    /* true if the text is not owned by the string */
+    bool is_view () const;
 
     const ObjectFactory& get_factory () const override;
 
@@ -45,13 +63,17 @@ public:
     std::shared_ptr<InternalObject> regex_replace (const std::vector<std::shared_ptr<InternalObject>>& params);
     std::shared_ptr<InternalObject> regex_find (const std::vector<std::shared_ptr<InternalObject>>& params);
     std::shared_ptr<InternalObject> get_line (const std::vector<std::shared_ptr<InternalObject>>& params);
-    std::shared_ptr<InternalObject> to_int ();
+    std::shared_ptr<InternalObject> to_int (const std::vector<std::shared_ptr<InternalObject>>& params);
+    std::shared_ptr<InternalObject> to_float ();
     std::shared_ptr<InternalObject> substring (const std::vector<std::shared_ptr<InternalObject>>& params);
+    /* the string itself is the format rule, see object::Format */
+    std::shared_ptr<InternalObject> format (const std::vector<std::shared_ptr<InternalObject>>& params);
 
     std::shared_ptr<InternalObject> call (const std::string& func, const std::vector<std::shared_ptr<InternalObject>>& params) override;
     std::shared_ptr<InternalObject> access (const std::string& member) override;
 
     std::string get_string () const override;
+    void serialize (Serializer& serializer) const override;
     std::string get_typename () const override;
 };
 
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string_view>
+
+#include "mlang/ast/node.hpp"
+#include "mlang/ast/func_decl_node.hpp"
+#include "mlang/ast/flat_tree.hpp"
+#include "mlang/ast/binary_operations.hpp"
+#include "mlang/ast/comparison.hpp"
+#include "mlang/ast/logic_operations.hpp"
+#include "mlang/ast/assignment.hpp"
+#include "mlang/object/format.hpp"
+#include "mlang/script/source.hpp"
+
+namespace mlang {
+namespace parser {
+
+/* the parser describes what it recognized to a builder, which decides how the AST is stored */
+/* 'none ()' is an absent optional child, e.g. a missing 'for' loop test */
+/* 'at ()' records the line a statement starts on, builders without position info ignore it */
+/* 'lazy_functions' builders accept a function body as a compiler that runs on the first call */
+
+/* builds the node tree, one heap allocated node per construct */
+class TreeBuilder {
+public:
+    typedef ast::node_ptr ref;
+    typedef std::vector<ast::node_ptr> list;
+    typedef ast::node_ptr result;
+
+    static constexpr bool lazy_functions { true };
+
+    ref none () const { return nullptr; }
+    ref at (ref statement, std::size_t) { return statement; }
+
+    ref value (object::Object value);
+    ref variable (std::string_view name);
+    ref func_call (std::string_view name, list&& params);
+    ref constructor (std::string_view type_name, list&& args);
+    ref array (list&& elements);
+    ref unary_not (ref rhs);
+    ref unary_minus (ref rhs);
+    ref prefix (ref exp, bool decrement);
+    ref postfix (ref exp, bool decrement);
+    ref subscript (ref lhs, ref index);
+    ref member_access (ref lhs, std::string_view member);
+    ref member_call (ref lhs, std::string_view member, list&& params);
+    ref arithmetic (ref lhs, ref rhs, ast::arithmetic_mode mode);
+    ref comparison (ref lhs, ref rhs, ast::comparison_mode mode);
+    ref logic (ref lhs, ref rhs, ast::logic_mode mode);
+    ref assignment (ref lhs, ref rhs, ast::assignment_mode mode);
+    ref format (std::string_view rule, object::Format&& format, list&& args);
+    ref print (std::string_view rule, object::Format&& format, list&& args);
+    ref break_statement ();
+    ref continue_statement ();
+    ref return_statement (ref value);
+    ref exit_statement (ref value);
+    ref while_statement (ref condition, ref body);
+    ref for_statement (ref initialization, ref test, ref update, ref body);
+    ref if_statement (list&& conditions, list&& bodies, ref else_body);
+    ref block (list&& statements);
+    ref declaration (std::string_view name);
+    ref declaration (std::string_view name, ref value);
+    ref func_decl (std::string_view name, std::vector<std::string_view>&& params, ref body);
+    ref func_decl (std::string_view name, std::vector<std::string_view>&& params, ast::FunctionDeclNode::body_compiler compile);
+    result main (list&& statements, std::shared_ptr<const script::Source> source);
+};
+
+/* builds an ast::FlatTree, nodes are appended to one vector and refer to each other by index */
+class FlatBuilder {
+public:
+    typedef ast::node_index ref;
+    typedef std::vector<ast::node_index> list;
+    typedef std::unique_ptr<ast::FlatTree> result;
+private:
+    std::unique_ptr<ast::FlatTree> m_tree;
+public:
+    /* the tree is serialized as a whole, every body is compiled up front */
+    static constexpr bool lazy_functions { false };
+
+    FlatBuilder ();
+
+    ref none () const { return ast::no_node; }
+    ref at (ref statement, std::size_t line);
+
+    ref value (object::Object value);
+    ref variable (std::string_view name);
+    ref func_call (std::string_view name, list&& params);
+    ref constructor (std::string_view type_name, list&& args);
+    ref array (list&& elements);
+    ref unary_not (ref rhs);
+    ref unary_minus (ref rhs);
+    ref prefix (ref exp, bool decrement);
+    ref postfix (ref exp, bool decrement);
+    ref subscript (ref lhs, ref index);
+    ref member_access (ref lhs, std::string_view member);
+    ref member_call (ref lhs, std::string_view member, list&& params);
+    ref arithmetic (ref lhs, ref rhs, ast::arithmetic_mode mode);
+    ref comparison (ref lhs, ref rhs, ast::comparison_mode mode);
+    ref logic (ref lhs, ref rhs, ast::logic_mode mode);
+    ref assignment (ref lhs, ref rhs, ast::assignment_mode mode);
+    ref format (std::string_view rule, object::Format&& format, list&& args);
+    ref print (std::string_view rule, object::Format&& format, list&& args);
+    ref break_statement ();
+    ref continue_statement ();
+    ref return_statement (ref value);
+    ref exit_statement (ref value);
+    ref while_statement (ref condition, ref body);
+    ref for_statement (ref initialization, ref test, ref update, ref body);
+    ref if_statement (list&& conditions, list&& bodies, ref else_body);
+    ref block (list&& statements);
+    ref declaration (std::string_view name);
+    ref declaration (std::string_view name, ref value);
+    ref func_decl (std::string_view name, std::vector<std::string_view>&& params, ref body);
+    result main (list&& statements, std::shared_ptr<const script::Source> source);
+};
+
+} /* namespace parser */
+} /* namespace mlang */
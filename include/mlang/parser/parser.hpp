@@ -1,9 +1,14 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 
 #include "mlang/script/token.hpp"
+#include "mlang/script/source.hpp"
+#include "mlang/script/lexer.hpp"
 #include "mlang/ast/node.hpp"
+#include "mlang/parser/builder.hpp"
+#include "mlang/object/string.hpp"
 
 #define TRACE_PARSER 0
 
@@ -14,26 +19,60 @@
 namespace mlang {
 namespace parser {
 
-class Parser {
+/* recursive descent parser, 'Builder' decides how the recognized constructs are stored (see builder.hpp) */
+template <typename Builder>
+class BasicParser {
+public:
+    typedef typename Builder::ref ref;
+    typedef typename Builder::list list;
+    typedef typename Builder::result result;
 private:
-    std::vector<const script::Token*> m_tokens;
+    /* a pulled token and the index of its first character in the source */
+    struct Pulled {
+        script::Token token { script::token_types::none, 0, 0 };
+        std::size_t offset { 0 };
+    };
+    /* the grammar looks at most one token back and one ahead, the ring leaves room to spare */
+    static constexpr std::size_t ring_size { 8 };
+
+    Builder m_builder;
+    const std::vector<script::Token>* m_tokens { nullptr };
+    /* set if the tokens are shared with the tree, function bodies are then compiled lazily */
+    std::shared_ptr<const std::vector<script::Token>> m_token_owner;
+    std::shared_ptr<const script::Source> m_source;
+
+    /* set instead of 'm_tokens' if the tokens are pulled from a lexer while parsing */
+    std::shared_ptr<script::Source> m_stream_source;
+    std::unique_ptr<script::Lexer> m_lexer;
+    std::vector<Pulled> m_ring;
+    std::size_t m_pulled { 0 };   /* number of tokens pulled so far */
 
     std::size_t m_index { 0 };
 
+    void stream (std::shared_ptr<script::Source> source, std::size_t line, std::size_t offset, std::size_t column);
+    /* the token at 'index', pulled from the lexer if needed, nullptr past the end */
+    const script::Token* token (std::size_t index);
+
     void next(int num = 1);
-    bool done() const;
-    const script::Token* peek (int num = 1) const;
+    bool done();
+    const script::Token* peek (int num = 1);
     bool peekable (int num = 1);
-    const script::Token* curr() const;
-    const script::Token* prev() const;
+    const script::Token* curr();
+    const script::Token* prev();
 
     void trace (const std::string& str) const;
 
+    /* the literal refers into the source if there is one, otherwise it is copied */
+    std::shared_ptr<object::String> string_literal (std::string_view value) const;
+
     bool consume (script::token_types type);
     void consume (script::token_types type, const std::string& err_msg);
 
     // primary            -> INT | FLOAT | STRING | "true" | "false" | "none" | "(" expression ")" | IDENTIFIER | ( "new" IDENTIFIER "(" arguments? ")" ) | ( "{" arguments "}" )
-    ast::node_ptr primary ();
+    ref primary ();
+
+    // format_call        -> "format" "(" STRING ( "," logic_or )* ")"
+    ref format_call ();
 
     // post_op            -> postfix_increment | postfix_decrement | ( func_call | subscript | member_access | member_call )*
     // postfix_increment  -> primary "++"
@@ -42,83 +81,102 @@ private:
     // subscript          -> primary "[" logic_or "]"
     // member_access      -> primary "." IDENTIFIER
     // member_call        -> primary "." IDENTIFIER "(" arguments? ")"
-    ast::node_ptr post_op ();
+    ref post_op ();
 
     // pre_op             -> ( "-" | "!" | "++" | "--" )? post_op;
-    ast::node_ptr pre_op ();
+    ref pre_op ();
 
     // factor             -> pre_op ( ( "/" | "*" ) pre_op )*
-    ast::node_ptr factor ();
+    ref factor ();
 
     // term               -> factor ( ( "-" | "+" ) factor )*
-    ast::node_ptr term ();
+    ref term ();
 
     // comparison         -> term ( ( ">" | ">=" | "<" | "<=" ) term )*
-    ast::node_ptr comparison ();
+    ref comparison ();
 
     // equality           -> comparison ( ( "!=" | "==" ) comparison )*
-    ast::node_ptr equality ();
+    ref equality ();
 
     // logic_and          -> equality ( "&&" equality )*
-    ast::node_ptr logic_and ();
+    ref logic_and ();
 
     // logic_or           -> logic_and ( "||" logic_and )*
-    ast::node_ptr logic_or ();
+    ref logic_or ();
 
     // assignment         -> logic_or ( "=" | "+=" | "-=" | "*=" | "/=" logic_or )?
-    ast::node_ptr assignment ();
+    ref assignment ();
 
     // expression         -> assignment
-    ast::node_ptr expression ();
+    ref expression ();
 
     // break_statement    -> "break" ";"
-    ast::node_ptr break_statement ();
+    ref break_statement ();
 
     // continue_statement -> "continue" ";"
-    ast::node_ptr continue_statement ();
+    ref continue_statement ();
 
     // return_statement   -> "return" expression? ";"
-    ast::node_ptr return_statement ();
+    ref return_statement ();
 
     // exit_statement     -> "exit" expression ";"
-    ast::node_ptr exit_statement ();
+    ref exit_statement ();
 
     // print_statement  -> "print" "(" STRING ( "," expression )* ")" ";"
-    ast::node_ptr print_statement ();
+    ref print_statement ();
 
     // while_statement  -> "while" "(" expression ")" block
-    ast::node_ptr while_statement ();
+    ref while_statement ();
 
     // for_statement    -> "for" "(" ( var_decl | exp_statement | ";" ) expression? ";" expression? ")" block
-    ast::node_ptr for_statement ();
+    ref for_statement ();
 
     // if_statement     -> "if" "(" expression ")" block ( "else if" "(" expression ")" block )* ( "else" block )?
-    ast::node_ptr if_statement ();
+    ref if_statement ();
 
     // exp_statement    -> expression ";"
-    ast::node_ptr exp_statement ();
+    ref exp_statement ();
 
     // statement        -> exp_statement | if_statement | for_statement | while_statement | print_statement | control
-    ast::node_ptr statement ();
+    ref statement ();
 
     // block            -> "{" statement* "}"
-    ast::node_ptr block ();
+    ref block ();
+
+    /* moves past a block by matching the curly brackets, nothing is built */
+    void skip_block ();
 
     // var_decl         -> "var" IDENTIFIER ( "=" expression )? ";"
-    ast::node_ptr var_decl ();
+    ref var_decl ();
 
     // func_decl        -> "function" IDENTIFIER "(" ( IDENTIFIER ("," IDENTIFIER)* )? ")" block
-    ast::node_ptr func_decl ();
+    ref func_decl ();
 
     // declaration      -> func_decl | var_decl | statement
-    ast::node_ptr declaration ();
+    ref declaration ();
 
 public:
-    Parser () = default;
-    ~Parser () = default;
-
-    ast::node_ptr parse (const std::vector<script::Token>& tokens);
+    BasicParser () = default;
+    ~BasicParser () = default;
+
+    /* the AST refers into the source of the tokens, 'source' is kept alive by the returned root */
+    result parse (const std::vector<script::Token>& tokens, std::shared_ptr<const script::Source> source = nullptr);
+    /* the tree keeps the tokens alive, function bodies are only scanned and compiled on their first call */
+    /* a syntax error in a function body is then thrown by that call */
+    result parse (std::shared_ptr<const std::vector<script::Token>> tokens, std::shared_ptr<const script::Source> source = nullptr);
+    /* lexes while parsing, only a few tokens are held at any time and no token vector is built */
+    /* lazily compiled function bodies are lexed again from the source on their first call */
+    /* 'first_line' is the line the source starts on if it is a part of a larger script */
+    result parse (std::shared_ptr<script::Source> source, std::size_t first_line = 1);
 };
 
+/* node tree, one allocation per node */
+typedef BasicParser<TreeBuilder> Parser;
+/* ast::FlatTree, nodes stored contiguously and referenced by index */
+typedef BasicParser<FlatBuilder> FlatParser;
+
+extern template class BasicParser<TreeBuilder>;
+extern template class BasicParser<FlatBuilder>;
+
 } /* namespace parser */
 } /* namespace mlang */
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "mlang/object/internal_object.hpp"
+#include "mlang/object/object.hpp"
+#include "mlang/script/type_registry.hpp"
+
+namespace mlang {
+namespace runtime {
+
+/* a bounded queue of values between scripts, any number of threads send and receive at once */
+/* 'new Channel(capacity)' creates one, assigning a channel or passing it as a job input shares it */
+/* a value is copied deeply when it is sent, arrays are copied element by element, a channel stays shared */
+/* send and recv wait inside an EventLoop task by parking it and anywhere else by blocking the thread */
+/*
+    ch.send(value)      waits while the channel is full, throws if it is closed, none cannot be sent
+    ch.try_send(value)  Boolean, false if the channel is full or closed
+    ch.recv()           waits while the channel is empty, none once it is closed and empty
+    ch.try_recv()       none if nothing is there
+    ch.close()          wakes every waiting script, the values already sent can still be received
+    ch.is_closed()      Boolean
+    ch.length()         Int, the number of values waiting
+    ch.capacity()       Int
+*/
+class Channel : public object::InternalObject {
+public:
+    class State;
+private:
+    std::shared_ptr<State> m_state;
+
+    State& get_state () const;
+public:
+    Channel () = default;
+    explicit Channel (std::size_t capacity);
+    ~Channel () = default;
+
+    const static inline std::string type_name { "Channel" };
+
+    /* registers the type with the environment on the first call */
+    static script::type_id define_type ();
+
+    void send (const object::Object& value);
+    bool try_send (const object::Object& value);
+    object::Object recv ();
+    bool try_recv (object::Object& value);
+    /* returns false if the channel was already closed */
+    bool close ();
+    bool is_closed () const;
+    /* a snapshot, other threads may change it at any time */
+    std::size_t get_size () const;
+    std::size_t get_capacity () const;
+
+    std::string get_typename () const override;
+    const object::ObjectFactory& get_factory () const override;
+
+    void construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    void assign (const std::shared_ptr<object::InternalObject> param) override;
+
+    std::shared_ptr<object::InternalObject> call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    std::shared_ptr<object::InternalObject> access (const std::string& member) override;
+
+    std::string get_string () const override;
+};
+
+class ChannelFactory : public object::ObjectFactory {
+public:
+    std::shared_ptr<object::InternalObject> create () const override;
+};
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "mlang/func/function.hpp"
+#include "mlang/object/object.hpp"
+
+namespace mlang {
+namespace runtime {
+
+struct EventBusStats {
+    std::size_t published { 0 };
+    std::size_t delivered { 0 };    /* notifications queued for a subscriber or handed to a waiting one */
+    std::size_t coalesced { 0 };    /* notifications merged into one that was still pending */
+};
+
+class EventBus;
+
+/* subscribe(subscriber, topic) */
+class SubscribeFunction : public func::Function {
+private:
+    EventBus& m_bus;
+public:
+    explicit SubscribeFunction (EventBus& bus);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* wait_for(subscriber) -> String, the topic that was published */
+class WaitForFunction : public func::Function {
+private:
+    EventBus& m_bus;
+public:
+    explicit WaitForFunction (EventBus& bus);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* publish(topic) -> Int, the number of subscribers that were notified */
+class PublishFunction : public func::Function {
+private:
+    EventBus& m_bus;
+public:
+    explicit PublishFunction (EventBus& bus);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* named subscribers waiting for topics, shared by any number of threads and scripts */
+/* a topic published again before its subscriber consumed it is delivered once */
+/* a waiting subscriber inside an EventLoop task parks the task, anywhere else it blocks its thread */
+class EventBus {
+private:
+    class Subscriber;
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator() (std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+    template <typename T>
+    using string_map = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+    mutable std::shared_mutex m_mutex;   /* publishing only reads the maps */
+    string_map<std::shared_ptr<Subscriber>> m_subscribers;
+    string_map<std::vector<std::shared_ptr<Subscriber>>> m_topics;
+
+    std::atomic<std::size_t> m_published { 0 };
+    std::atomic<std::size_t> m_delivered { 0 };
+    std::atomic<std::size_t> m_coalesced { 0 };
+
+    SubscribeFunction m_subscribe { *this };
+    WaitForFunction m_wait_for { *this };
+    PublishFunction m_publish { *this };
+
+    std::shared_ptr<Subscriber> find (std::string_view subscriber) const;
+public:
+    EventBus ();
+    EventBus (const EventBus&) = delete;
+    EventBus& operator= (const EventBus&) = delete;
+    ~EventBus ();
+
+    /* creates the subscriber on its first subscription, subscribing twice has no effect */
+    void subscribe (std::string_view subscriber, std::string_view topic);
+    /* returns false if the subscriber did not subscribe to the topic */
+    bool unsubscribe (std::string_view subscriber, std::string_view topic);
+    /* returns the number of subscribers that were notified, coalesced notifications are not counted */
+    std::size_t publish (std::string_view topic);
+
+    /* returns the oldest topic published for the subscriber, waits until there is one */
+    /* throws RuntimeError if the subscriber never subscribed */
+    std::string wait_for (std::string_view subscriber);
+    /* like wait_for without waiting, returns false if nothing is pending */
+    bool poll (std::string_view subscriber, std::string& topic);
+
+    EventBusStats get_stats () const;
+
+    /* declares 'subscribe', 'wait_for' and 'publish' in the current scope of 'env', the bus must outlive it */
+    void declare_functions (script::EnvStack& env) const;
+};
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/func/function.hpp"
+#include "mlang/object/object.hpp"
+
+namespace mlang {
+namespace runtime {
+
+class Task;
+class LoopCore;
+class ResumeState;
+
+/* hands the result of a suspended operation back to the script that waits for it */
+/* may be called from any thread, only the first call has an effect */
+class Resumer {
+private:
+    std::shared_ptr<ResumeState> m_state;
+public:
+    explicit Resumer (std::shared_ptr<ResumeState> state);
+    /* returns false if the operation was already resumed or its task was cancelled */
+    bool resume (object::Object value = object::Object {}) const;
+};
+
+/* called by a host function that has to wait : 'start' begins the operation and keeps the resumer */
+/* inside a task the script is parked and its thread runs other tasks until the resumer is called */
+/* anywhere else the calling thread blocks until then, so the same host function works in Script::execute */
+/* returns the value passed to Resumer::resume */
+object::Object suspend (const std::function<void (Resumer)>& start);
+
+/* inside a task the tasks that are ready run before it continues, anywhere else it returns at once */
+void yield ();
+
+/* thrown out of 'suspend' when the loop of a parked task is destroyed, unwinds the script */
+class TaskCancelled : public std::exception {
+public:
+    const char* what () const noexcept override { return "task cancelled"; }
+};
+
+enum class task_status {
+    ready,      /* waits for its first turn or to continue after a resume */
+    running,
+    suspended,  /* parked in 'suspend' */
+    finished
+};
+
+typedef std::function<void (Task&)> task_callback;
+
+/* one execution of a program that can be suspended, it runs on its own small stack */
+class Task : public std::enable_shared_from_this<Task> {
+private:
+    friend class EventLoop;
+    friend class Resumer;
+    friend object::Object suspend (const std::function<void (Resumer)>& start);
+    class Fiber;
+
+    std::shared_ptr<const script::Program> m_program;
+    env_initializer m_initializer;
+    task_callback m_on_finished;
+    script::EnvStack m_env;
+    std::shared_ptr<LoopCore> m_core;
+    std::unique_ptr<Fiber> m_fiber;
+    std::atomic<task_status> m_status { task_status::ready };
+    bool m_cancel { false };
+    std::uint32_t m_time_slice { 0 };
+    int m_exit_code { -1 };
+    object::Object m_value {};
+    std::exception_ptr m_error {};
+
+    static void entry ();
+    void body ();
+public:
+    Task (std::shared_ptr<const script::Program> program, env_initializer initializer, task_callback on_finished, std::shared_ptr<LoopCore> core);
+    Task (const Task&) = delete;
+    Task& operator= (const Task&) = delete;
+    ~Task ();
+
+    task_status get_status () const;
+    bool is_finished () const;
+    /* as Program::execute, -1 if the task was cancelled or failed with an exception */
+    int get_exit_code () const;
+    /* value of a top-level 'return' or 'exit', None otherwise */
+    const object::Object& get_value () const;
+    /* set if the initializer or a host function threw something other than a script error */
+    std::exception_ptr get_error () const;
+    /* only while the task is not running */
+    script::EnvStack& get_environment ();
+};
+
+/* runs many suspendable tasks on the thread that calls 'run' */
+/* a task switches stacks when it suspends, a parked task costs its stack and no thread */
+/* spawn, post and call_after may be called from any thread, the loop is destroyed on the thread that ran it */
+class EventLoop {
+private:
+    std::shared_ptr<LoopCore> m_core;
+    std::size_t m_stack_size;
+    std::atomic<std::uint32_t> m_time_slice { 0 };
+
+    void resume (const std::shared_ptr<Task>& task);
+public:
+    /* every task reserves 'stack_size' bytes of address space, only the pages it touches use memory */
+    static constexpr std::size_t default_stack_size { 512 * 1024 };
+
+    explicit EventLoop (std::size_t stack_size = default_stack_size);
+    EventLoop (const EventLoop&) = delete;
+    EventLoop& operator= (const EventLoop&) = delete;
+    /* parked tasks are resumed with TaskCancelled and unwind */
+    ~EventLoop ();
+
+    std::shared_ptr<Task> spawn (std::shared_ptr<const script::Program> program, env_initializer initializer = nullptr, task_callback on_finished = nullptr);
+    void post (std::function<void ()> callback);
+    /* tasks spawned afterwards yield every 'steps' loop iterations and function calls, 0 (the default) never preempts them */
+    /* a script stuck in a loop then only delays the other tasks, it does not stall them */
+    void set_time_slice (std::uint32_t steps);
+    void call_after (std::chrono::steady_clock::duration delay, std::function<void ()> callback);
+
+    /* runs tasks, callbacks and timers until every task finished or stop is called */
+    void run ();
+    void stop ();
+
+    /* tasks that did not finish yet */
+    std::size_t get_task_count () const;
+    /* the loop running on the calling thread, nullptr outside of 'run' */
+    static EventLoop* current ();
+};
+
+/* sleep(milliseconds) : parks the task, blocks the thread outside of a task */
+class SleepFunction : public func::Function {
+public:
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* declares 'sleep' in the current scope of 'env' */
+void declare_event_loop_functions (script::EnvStack& env);
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <deque>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "mlang/script/program.hpp"
+#include "mlang/object/object.hpp"
+
+namespace mlang {
+namespace runtime {
+
+enum class job_priority {
+    low,
+    normal,
+    high
+};
+
+/* called on the worker thread before the program runs, declares host functions and sets the output */
+typedef std::function<void (script::EnvStack&)> env_initializer;
+/* declared as global variables of the job, in this order and after the initializer ran */
+typedef std::vector<std::pair<std::string, object::Object>> job_inputs;
+
+struct JobResult {
+    int exit_code { 0 };                        /* as Program::execute, -1 if the job was cancelled */
+    object::Object value {};                    /* value of a top-level 'return' or 'exit', None otherwise */
+    bool cancelled { false };
+    std::chrono::nanoseconds cpu_time { 0 };    /* CPU time of the worker thread while it ran the job */
+};
+
+struct ExecutorStats {
+    std::size_t submitted { 0 };
+    std::size_t completed { 0 };    /* jobs that ran, whatever their exit code */
+    std::size_t cancelled { 0 };    /* cancelled jobs the workers have dropped from their queues */
+    std::size_t steals { 0 };       /* jobs a worker took from the queue of another worker */
+    std::chrono::nanoseconds cpu_time { 0 };
+};
+
+class JobState;
+
+/* handle of a submitted job */
+class Job {
+private:
+    std::shared_ptr<JobState> m_state;
+    std::future<JobResult> m_result;
+public:
+    Job (std::shared_ptr<JobState> state, std::future<JobResult> result);
+    Job (Job&&) = default;
+    Job& operator= (Job&&) = default;
+    ~Job () = default;
+
+    /* a job that has not started yet never runs and its result reports it as cancelled */
+    /* returns false if the job already started, a running job is not interrupted */
+    bool cancel ();
+
+    /* waits for the job, exceptions other than the script errors are rethrown here */
+    JobResult get ();
+    std::future<JobResult>& get_future ();
+};
+
+/* a fixed pool of worker threads running script programs */
+/* each worker owns one deque per priority, an idle worker steals from the others, higher priorities are always taken first */
+/* jobs submitted by a running job go to the queue of its own worker, a job must not wait for them, every worker may be busy */
+class Executor {
+private:
+    /* the owner takes jobs from the front, thieves from the back, so they meet as late as possible */
+    struct WorkQueue {
+        std::mutex mutex;
+        std::array<std::deque<std::shared_ptr<JobState>>, 3> jobs;   /* indexed by job_priority */
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::array<std::atomic<std::size_t>, 3> m_queued {};    /* jobs in all the queues, indexed by job_priority, lets 'take' skip empty priorities */
+    std::atomic<std::uint32_t> m_signal { 0 };   /* bumped for every new job, idle workers wait on it */
+    std::atomic<bool> m_stopping { false };
+    std::atomic<std::size_t> m_next_queue { 0 }; /* round robin for jobs submitted from outside the pool */
+
+    std::atomic<std::size_t> m_submitted { 0 };
+    std::atomic<std::size_t> m_completed { 0 };
+    std::atomic<std::size_t> m_cancelled { 0 };
+    std::atomic<std::size_t> m_steals { 0 };
+    std::atomic<std::int64_t> m_cpu_time { 0 };  /* nanoseconds */
+
+    void work (std::size_t self);
+    bool take (std::size_t self, std::shared_ptr<JobState>& job);
+    void run (JobState& job);
+    Job push (std::shared_ptr<JobState> state);
+public:
+    /* 0 threads means one per hardware thread */
+    explicit Executor (std::size_t threads = 0);
+    Executor (const Executor&) = delete;
+    Executor& operator= (const Executor&) = delete;
+    /* runs every job that was not cancelled, then stops the workers */
+    ~Executor ();
+
+    Job submit (std::shared_ptr<const script::Program> program, env_initializer initializer = nullptr, job_inputs inputs = {}, job_priority priority = job_priority::normal);
+    /* runs host code on the pool, the exit code of the result is 0, exceptions are rethrown by Job::get */
+    Job submit_work (std::function<void ()> work, job_priority priority = job_priority::normal);
+
+    std::size_t get_thread_count () const;
+    ExecutorStats get_stats () const;
+
+    /* runs one queued job of the pool the calling thread works for, false if there is none or the thread is no worker */
+    /* a job waiting for another job of its own pool calls it instead of blocking its worker, the other job may be queued behind it */
+    static bool run_pending ();
+};
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+
+#include "mlang/func/function.hpp"
+#include "mlang/object/internal_object.hpp"
+#include "mlang/object/object.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/type_registry.hpp"
+
+namespace mlang {
+namespace runtime {
+
+class Future;
+
+/* completes a Future from any thread, only the first completion counts */
+/* the future fails with "broken promise" once the last copy is dropped without completing it */
+class Promise {
+public:
+    class Completer;
+private:
+    std::shared_ptr<Completer> m_completer;
+public:
+    explicit Promise (std::shared_ptr<Completer> completer);
+
+    /* returns false if the future was already completed */
+    bool set_value (object::Object value) const;
+    bool set_error (std::string message) const;
+};
+
+/* the result of an asynchronous host call, the script continues while it is pending */
+/* await(future) or any use of the value waits for it, a failed future throws RuntimeError there */
+/* waiting parks the task inside an EventLoop and blocks the thread anywhere else */
+/* a worker of an Executor runs the queued jobs of its pool before it blocks, the host call may be one of them */
+/*
+    future.ready()  Boolean, true once the result is there
+    future.get()    waits and returns the result, like await
+*/
+class Future : public object::InternalObject {
+public:
+    class State;
+private:
+    std::shared_ptr<State> m_state;
+
+    State& get_state () const;
+    /* the internal object of the result, waits for it */
+    object::internal_obj_ptr resolved () const;
+public:
+    Future () = default;
+    explicit Future (std::shared_ptr<State> state);
+    ~Future () = default;
+
+    const static inline std::string type_name { "Future" };
+
+    /* registers the type with the environment on the first call, scripts declare variables of this type */
+    static script::type_id define_type ();
+    /* a pending future and the promise that completes it */
+    static std::pair<object::Object, Promise> create ();
+
+    bool is_ready () const;
+    /* waits for the result, throws RuntimeError if the future failed */
+    object::Object wait () const;
+
+    std::string get_typename () const override;
+    const object::ObjectFactory& get_factory () const override;
+
+    void construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    /* both objects refer to the same result */
+    void assign (const std::shared_ptr<object::InternalObject> param) override;
+
+    std::shared_ptr<object::InternalObject> call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    std::shared_ptr<object::InternalObject> access (const std::string& member) override;
+
+    /* everything else waits for the result and uses it */
+    bool is_true () const override;
+    double get_float () const override;
+    int get_int () const override;
+    std::string get_string () const override;
+    void serialize (object::Serializer& serializer) const override;
+
+    std::shared_ptr<object::InternalObject> operator_binary_add (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_binary_sub (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_binary_mul (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_binary_div (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> unary_minus () override;
+    std::shared_ptr<object::InternalObject> unary_not () override;
+    std::shared_ptr<object::InternalObject> operator_comparison_equal (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_comparison_not_equal (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_greater (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_less (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_greater_equal (const std::shared_ptr<object::InternalObject> param) override;
+    std::shared_ptr<object::InternalObject> operator_less_equal (const std::shared_ptr<object::InternalObject> param) override;
+    object::Object& operator_subscript (const std::shared_ptr<object::InternalObject> param) override;
+};
+
+class FutureFactory : public object::ObjectFactory {
+public:
+    std::shared_ptr<object::InternalObject> create () const override;
+};
+
+/* a host function that returns at once with a Future, 'start' begins the work and completes the promise later */
+/* 'start' runs on the thread of the script, the parameters are copies the work may keep */
+class AsyncFunction : public func::Function {
+public:
+    AsyncFunction ();
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+    virtual void start (std::vector<object::Object> params, Promise promise) const = 0;
+};
+
+/* runs a blocking host call on the workers of an executor, any std::exception thrown by it fails the future with its message */
+/* a script issues several calls before it awaits the first one and they run side by side */
+class OffloadedFunction : public AsyncFunction {
+public:
+    typedef std::function<object::Object (const std::vector<object::Object>&)> host_call;
+private:
+    Executor& m_executor;
+    host_call m_call;
+public:
+    OffloadedFunction (Executor& executor, host_call call);
+    void start (std::vector<object::Object> params, Promise promise) const override;
+};
+
+/* await(value) : the result of a Future, an Array with every Future replaced by its result, any other value as it is */
+class AwaitFunction : public func::Function {
+public:
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* declares 'await' in the current scope of 'env' */
+void declare_future_functions (script::EnvStack& env);
+
+} /* namespace runtime */
+} /* namespace mlang */
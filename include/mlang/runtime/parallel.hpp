@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "mlang/func/function.hpp"
+#include "mlang/object/object.hpp"
+#include "mlang/runtime/executor.hpp"
+
+namespace mlang {
+namespace runtime {
+
+/* the function is given by name and runs on the workers of the executor and on the calling thread */
+/* it sees the functions visible to the caller but none of its variables, host functions must be thread safe */
+/* the elements are split into chunks that shrink as the work runs out, so late chunks balance the load */
+/* what the function prints is written to the output of the caller in the order of the elements */
+/* the error of the lowest failing element is rethrown on the calling thread */
+
+/* parallel_map(array, function) -> Array, function(element) for every element, in order */
+class ParallelMapFunction : public func::Function {
+private:
+    Executor& m_executor;
+public:
+    explicit ParallelMapFunction (Executor& executor);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* parallel_reduce(array, function, init) -> function(function(init, e0), e1) ..., the function must be associative */
+/* every chunk is reduced on its own, the partial results are then combined in order starting from 'init' */
+class ParallelReduceFunction : public func::Function {
+private:
+    Executor& m_executor;
+public:
+    explicit ParallelReduceFunction (Executor& executor);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* parallel_for(n, function), function(i) for i in [0, n) */
+class ParallelForFunction : public func::Function {
+private:
+    Executor& m_executor;
+public:
+    explicit ParallelForFunction (Executor& executor);
+    object::Object call (script::EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* the parallel built-ins of one executor */
+class ParallelFunctions {
+private:
+    ParallelMapFunction m_map;
+    ParallelReduceFunction m_reduce;
+    ParallelForFunction m_for;
+public:
+    explicit ParallelFunctions (Executor& executor);
+
+    /* declares 'parallel_map', 'parallel_reduce' and 'parallel_for' in the current scope of 'env', this object must outlive it */
+    void declare_functions (script::EnvStack& env) const;
+};
+
+} /* namespace runtime */
+} /* namespace mlang */
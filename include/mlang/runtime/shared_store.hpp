@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "mlang/object/internal_object.hpp"
+#include "mlang/object/object.hpp"
+#include "mlang/script/type_registry.hpp"
+
+namespace mlang {
+namespace runtime {
+
+/* a concurrent map from String keys to values, shared by every script, thread and isolate of the process */
+/* 'new SharedStore("name")' opens the store of that name, it is created on the first use and lives until the process exits */
+/* 'new SharedStore()' creates a private store, assigning it or passing it as a job input shares it */
+/* reads take no lock, writes lock one of several stripes, every write gives the key a version newer than any it had before */
+/* values are copied deeply when they are stored and when they are read, none cannot be stored */
+/*
+    store.get(key)                          the value, none if the key is not set
+    store.set(key, value)                   Int, the new version of the key
+    store.version(key)                      Int, 0 if the key is not set
+    store.compare_and_set(key, v, value)    Boolean, stores the value only if the version is still v
+    store.remove(key)                       Boolean, false if the key was not set
+    store.watch(key, v)                     waits until the version is not v anymore and returns it
+    store.has(key)                          Boolean
+    store.length()                          Int, the number of keys that are set
+    a version that no longer fits an Int is a runtime error in a script, the C++ members return the full 64 bit version
+*/
+class SharedStore : public object::InternalObject {
+public:
+    class State;
+private:
+    std::shared_ptr<State> m_state;
+
+    State& get_state () const;
+public:
+    SharedStore () = default;
+    /* the store of that name */
+    explicit SharedStore (std::string_view name);
+    ~SharedStore () = default;
+
+    const static inline std::string type_name { "SharedStore" };
+
+    /* registers the type with the environment on the first call */
+    static script::type_id define_type ();
+    /* a private store */
+    static std::shared_ptr<SharedStore> create ();
+
+    object::Object get (std::string_view key) const;
+    std::uint64_t get_version (std::string_view key) const;
+    std::uint64_t set (std::string_view key, const object::Object& value);
+    bool compare_and_set (std::string_view key, std::uint64_t version, const object::Object& value);
+    bool remove (std::string_view key);
+    /* waits inside an EventLoop task by parking it and anywhere else by blocking the thread */
+    std::uint64_t watch (std::string_view key, std::uint64_t version) const;
+    /* a snapshot, other threads may change it at any time */
+    std::size_t get_size () const;
+
+    std::string get_typename () const override;
+    const object::ObjectFactory& get_factory () const override;
+
+    void construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    void assign (const std::shared_ptr<object::InternalObject> param) override;
+
+    std::shared_ptr<object::InternalObject> call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) override;
+    std::shared_ptr<object::InternalObject> access (const std::string& member) override;
+
+    std::string get_string () const override;
+};
+
+class SharedStoreFactory : public object::ObjectFactory {
+public:
+    std::shared_ptr<object::InternalObject> create () const override;
+};
+
+} /* namespace runtime */
+} /* namespace mlang */
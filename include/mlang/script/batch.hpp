@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <functional>
+
+#include "mlang/script/script.hpp"
+
+namespace mlang {
+namespace script {
+
+/* outcome of compiling one file, 'script' is empty if it failed */
+struct CompileResult {
+    std::string path;
+    std::optional<Script> script;
+    std::string error;                           /* what() of the SyntaxError or RuntimeError */
+    std::chrono::nanoseconds duration { 0 };     /* mapping, lexing and parsing */
+};
+
+struct CompileStats {
+    std::size_t files { 0 };
+    std::size_t failed { 0 };
+    std::size_t threads { 0 };
+    std::size_t steals { 0 };                    /* files a thread took from the queue of another thread */
+    std::chrono::nanoseconds wall_time { 0 };
+    std::chrono::nanoseconds compile_time { 0 }; /* sum of the durations of all files */
+};
+
+struct CompileBatch {
+    std::vector<CompileResult> results;          /* in the order of the paths */
+    CompileStats stats;
+};
+
+/* called once per file from the thread that compiled it, the calls never overlap */
+typedef std::function<void (std::size_t done, std::size_t total, const CompileResult& result)> compile_progress;
+
+/* maps and compiles every file (see Script::compile), the files are spread over 'threads' threads */
+/* an idle thread steals files from the others, 'threads' = 0 uses one thread per core */
+/* the results do not depend on the number of threads or on the order in which the files finish */
+CompileBatch compile_all (const std::vector<std::string>& paths, std::size_t threads = 0, compile_progress progress = nullptr);
+
+} /* namespace script */
+} /* namespace mlang */
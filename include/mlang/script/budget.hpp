@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <functional>
+
+namespace mlang {
+namespace script {
+
+/* stops an execution from another thread, the script fails at its next budget check */
+class CancelToken {
+private:
+    std::atomic<bool> m_cancelled { false };
+public:
+    void cancel () { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool is_cancelled () const { return m_cancelled.load(std::memory_order_relaxed); }
+};
+
+/* the limits of one execution, every loop iteration and every function call is a step */
+/* the step counter is exact, the deadline and the token are looked at every 'check_interval' steps */
+/* a script that exceeds its budget fails with BudgetExceeded, the scopes it entered are left */
+struct Budget {
+    std::uint64_t max_steps { 0 };     /* the steps allowed, 0 for no limit */
+    std::optional<std::chrono::steady_clock::time_point> deadline {};
+    std::shared_ptr<const CancelToken> cancel {};
+    std::uint32_t check_interval { 4096 };
+    /* called at every check before the limits, a scheduler may run something else meanwhile */
+    std::function<void ()> yield {};
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -7,13 +7,19 @@
 #include "mlang/object/string.hpp"
 #include "mlang/object/boolean.hpp"
 #include "mlang/object/array.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/script/type_registry.hpp"
+#include "mlang/script/budget.hpp"
 
 //#include "mlang/func/function.hpp"
 
 #include <map>
 #include <stack>
+#include <limits>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace mlang {
 
@@ -23,16 +29,12 @@ namespace func {
 
 namespace script {
 
+/* the names are looked up with std::string_view, the AST refers into the script source without copies */
+/* the types are shared by every environment of every thread, see TypeRegistry */
 class Environment {
 private:
-    static inline std::map<std::string, std::shared_ptr<object::ObjectFactory>> m_types { { object::None::type_name, std::make_shared<object::NoneFactory>() },
-                                                                                          { object::Int::type_name, std::make_shared<object::IntFactory>() },
-                                                                                          { object::Float::type_name, std::make_shared<object::FloatFactory>() },
-                                                                                          { object::Boolean::type_name, std::make_shared<object::BooleanFactory>() },
-                                                                                          { object::Array::type_name, std::make_shared<object::ArrayFactory>() },
-                                                                                          { object::String::type_name, std::make_shared<object::StringFactory>() }   };
-    std::map<std::string, object::Object> m_variables;
-    std::map<std::string, const func::Function*> m_functions;
+    std::map<std::string, object::Object, std::less<>> m_variables;
+    std::map<std::string, const func::Function*, std::less<>> m_functions;
 
     Environment* m_parent { nullptr };
 public:
@@ -42,35 +44,80 @@ public:
 
     void reset ();
 
-    static bool has_type (const std::string& type_name);
-    static void define_type (const std::string& type_name, std::shared_ptr<object::ObjectFactory> factory);
-    static const object::ObjectFactory& get_factory (const std::string& type);
-
-    bool has_variable (const std::string& variable_name) const;
-    void declare_variable (const std::string& variable_name, const std::string& type);
-    object::Object& get_variable (const std::string& variable_name);
-
-    bool has_function (const std::string& function_name) const;
-    void declare_function (const std::string& function_name, const func::Function* function);
-    const func::Function* get_function (const std::string& function_name);
+    static bool has_type (std::string_view type_name);
+    /* may be called while scripts execute on other threads */
+    static type_id define_type (std::string_view type_name, std::shared_ptr<object::ObjectFactory> factory);
+    /* unknown_type if there is no such type */
+    static type_id find_type (std::string_view type_name);
+    static const object::ObjectFactory& get_factory (std::string_view type);
+    static const object::ObjectFactory& get_factory (type_id type);
+
+    bool has_variable (std::string_view variable_name) const;
+    void declare_variable (std::string_view variable_name, std::string_view type);
+    void declare_variable (std::string_view variable_name, type_id type);
+    object::Object& get_variable (std::string_view variable_name);
+
+    bool has_function (std::string_view function_name) const;
+    void declare_function (std::string_view function_name, const func::Function* function);
+    const func::Function* get_function (std::string_view function_name);
+    /* only this scope, returns false if the function is not declared here */
+    bool remove_function (std::string_view function_name);
+    /* adds the functions of this scope and its parents, a name already in 'functions' is kept */
+    void collect_functions (std::map<std::string, const func::Function*, std::less<>>& functions) const;
 };
 
 class EnvStack {
 private:
     std::stack<std::unique_ptr<Environment>> m_env_stack;
+    Output m_output;
+
+    Budget m_budget {};
+    std::uint64_t m_steps { 0 };        /* steps of the slices that are over */
+    std::uint32_t m_slice { std::numeric_limits<std::uint32_t>::max() };
+    std::uint32_t m_countdown { std::numeric_limits<std::uint32_t>::max() };
+
+    void check_budget ();
+    void check_steps () const;
+    void start_slice ();
 public:
     EnvStack ();
 
     void enter_scope ();
     void exit_scope ();
-
-    bool has_variable (const std::string& variable_name) const;
-    void declare_variable (const std::string& variable_name, const std::string& type);
-    object::Object& get_variable (const std::string& variable_name);
-
-    bool has_function (const std::string& function_name) const;
-    void declare_function (const std::string& function_name, const func::Function* function);
-    const func::Function* get_function (const std::string& function_name);
+    /* leaves every scope and starts over with an empty global environment, the output and the budget are kept */
+    void clear ();
+    /* the number of scopes, the global one included */
+    std::size_t get_depth () const;
+    /* leaves the scopes above 'depth', after an execution was aborted */
+    void unwind (std::size_t depth);
+
+    /* replaces the budget and starts counting the steps from 0 */
+    void set_budget (Budget budget);
+    const Budget& get_budget () const;
+    std::uint64_t get_steps () const;
+    /* counts steps made for this execution somewhere else, e.g. by parallel workers, throws BudgetExceeded */
+    void add_steps (std::uint64_t steps);
+    /* called at every loop iteration and function call, throws BudgetExceeded */
+    void step () {
+        if (--m_countdown == 0) { check_budget(); }
+    }
+
+    bool has_variable (std::string_view variable_name) const;
+    void declare_variable (std::string_view variable_name, std::string_view type);
+    void declare_variable (std::string_view variable_name, type_id type);
+    object::Object& get_variable (std::string_view variable_name);
+
+    bool has_function (std::string_view function_name) const;
+    void declare_function (std::string_view function_name, const func::Function* function);
+    const func::Function* get_function (std::string_view function_name);
+    /* removes the function from the current scope, returns false if it is not declared there */
+    bool remove_function (std::string_view function_name);
+    /* every function visible in the current scope */
+    std::map<std::string, const func::Function*, std::less<>> get_functions () const;
+
+    /* destination of 'print', std::cout by default */
+    Output& get_output ();
+    void set_output (std::shared_ptr<OutputSink> sink, std::size_t capacity = Output::default_capacity);
 };
 
 } /* namespace script */
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+#include "mlang/func/function.hpp"
+
+namespace mlang {
+namespace script {
+
+/* read-only contents of a file */
+/* regular files are mapped with mmap(2), pipes, terminals and other special files are read into memory */
+/* the file must not be truncated while it is mapped */
+class MappedFile {
+private:
+    std::string m_path;
+    void* m_mapping { nullptr };
+    std::size_t m_size { 0 };
+    std::string m_buffer;      /* fallback for everything that cannot be mapped */
+    std::string_view m_text;
+
+    MappedFile (const std::string& path);
+public:
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+    ~MappedFile ();
+
+    /* throws RuntimeError if the file cannot be opened or read */
+    static std::shared_ptr<const MappedFile> open (const std::string& path);
+
+    std::string_view get_text () const;
+    const std::string& get_path () const;
+    bool is_mapped () const;
+};
+
+/* map_file(path) -> String referring to the mapped file, the contents are not copied */
+/* the mapping is private but shares its pages with the file, a change of the file shows in the String */
+/* reading the String after the file was truncated raises SIGBUS, use read_file for files that other processes may change */
+class MapFileFunction : public func::Function {
+public:
+    object::Object call (EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* read_file(path) -> String owning a copy of the contents, the file may change afterwards */
+class ReadFileFunction : public func::Function {
+public:
+    object::Object call (EnvStack& env, std::vector<object::Object>& params) const override;
+};
+
+/* declares 'read_file' and 'map_file' in the current scope of 'env' */
+void declare_file_functions (EnvStack& env);
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+#include "mlang/script/token.hpp"
+
+namespace mlang {
+namespace script {
+
+struct Keyword {
+    std::string_view word;
+    token_types type;
+};
+
+/* every keyword of the language, add new ones here, the lookup table below is regenerated at compile time */
+/* 'else if' is not listed, the lexer merges 'else' and 'if' */
+inline constexpr Keyword keyword_list[] {
+    { "none", token_types::kw_none },
+    { "true", token_types::kw_true },
+    { "false", token_types::kw_false },
+    { "if", token_types::kw_if },
+    { "else", token_types::kw_else },
+    { "new", token_types::kw_new },
+    { "for", token_types::kw_for },
+    { "while", token_types::kw_while },
+    { "break", token_types::kw_break },
+    { "continue", token_types::kw_continue },
+    { "switch", token_types::kw_switch },
+    { "case", token_types::kw_case },
+    { "default", token_types::kw_default },
+    { "function", token_types::kw_function },
+    { "var", token_types::kw_var },
+    { "return", token_types::kw_return },
+    { "exit", token_types::kw_exit },
+    { "print", token_types::kw_print },
+    { "format", token_types::kw_format }
+};
+
+namespace keyword_detail {
+
+/* perfect hash : the length, the first two and the last character of the word, multiplied by a seed */
+/* the seed is searched at compile time so that no two keywords share a slot */
+inline constexpr std::uint32_t table_bits { 6 };
+inline constexpr std::uint32_t table_size { 1u << table_bits };
+inline constexpr std::uint32_t max_seed_tries { 1u << 16 };
+
+constexpr std::uint32_t hash (std::string_view word, std::uint32_t seed) {
+    const std::uint32_t key = static_cast<std::uint32_t>(static_cast<unsigned char>(word[0]))
+                            | (static_cast<std::uint32_t>(static_cast<unsigned char>(word[1])) << 8)
+                            | (static_cast<std::uint32_t>(static_cast<unsigned char>(word[word.size() - 1])) << 16)
+                            | (static_cast<std::uint32_t>(word.size()) << 24);
+    return (key * seed) >> (32 - table_bits);
+}
+
+constexpr bool is_perfect (std::uint32_t seed) {
+    bool used[table_size] {};
+    for (const Keyword& keyword : keyword_list) {
+        const std::uint32_t slot = hash(keyword.word, seed);
+        if (used[slot]) { return false; }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr std::uint32_t find_seed () {
+    /* odd multipliers spread the bits best */
+    for (std::uint32_t i = 0; i < max_seed_tries; ++i) {
+        const std::uint32_t seed = 0x9E3779B1u + 2 * i;
+        if (is_perfect(seed)) { return seed; }
+    }
+    return 0;
+}
+
+inline constexpr std::uint32_t seed { find_seed() };
+static_assert(seed != 0, "no perfect hash seed found for the keywords, increase table_bits");
+
+struct Table {
+    Keyword slots[table_size] {};
+};
+
+constexpr Table make_table () {
+    Table table {};
+    for (const Keyword& keyword : keyword_list) {
+        table.slots[hash(keyword.word, seed)] = keyword;
+    }
+    return table;
+}
+
+inline constexpr Table table { make_table() };
+
+} /* namespace keyword_detail */
+
+/* token type of a keyword, or token_types::identifier if 'word' is not a keyword */
+/* one hash and at most one comparison per word */
+constexpr token_types keyword_type (std::string_view word) {
+    if (word.size() < 2) { return token_types::identifier; }
+    const Keyword& candidate = keyword_detail::table.slots[keyword_detail::hash(word, keyword_detail::seed)];
+    if (candidate.word == word) { return candidate.type; }
+    return token_types::identifier;
+}
+
+static_assert(keyword_type("function") == token_types::kw_function);
+static_assert(keyword_type("functions") == token_types::identifier);
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlang/script/token.hpp"
+#include "mlang/script/source.hpp"
+
+namespace mlang {
+namespace script {
+
+/* turns the source text into the final script tokens in a single pass */
+/* multi-character operators, keywords and 'else if' are recognized in place, comments are skipped */
+/* identifiers and strings refer into the source, which has to outlive the tokens */
+/* either all tokens at once (tokenize) or one at a time (next), the latter never holds more than two tokens */
+class Lexer {
+private:
+    Source& m_owner;
+    std::string_view m_source;
+    std::size_t m_offset { 0 };
+    std::size_t m_first_line { 1 };
+    std::size_t m_first_column { 1 };
+    std::size_t m_index { 0 };
+    std::size_t m_line { 1 };
+    std::size_t m_line_start { 0 };   /* index of the first character of the current line */
+    std::vector<Token> m_tokens;
+    std::vector<std::size_t> m_offsets;   /* of the pending tokens when they are pulled with next */
+
+    void rewind ();
+    /* lexes whatever starts at the current character, adds at most one token */
+    void step ();
+    bool done () const;
+    char peek (std::size_t offset) const;
+    std::size_t column () const;
+    void new_line ();
+
+    void add (token_types type, std::size_t pos, std::size_t length);
+    void lex_number ();
+    void lex_identifier ();
+    void lex_string ();
+    void skip_comment ();
+    void lex_operator ();
+public:
+    Lexer () = delete;
+    /* 'first_line' is the line the source starts on if it is a part of a larger script */
+    /* 'offset' and 'first_column' start the lexer in the middle of the source */
+    Lexer (Source& source, std::size_t first_line = 1, std::size_t offset = 0, std::size_t first_column = 1);
+    ~Lexer () = default;
+
+    /* throws SyntaxError */
+    std::vector<Token> tokenize ();
+
+    /* the next token and the index of its first character in the source, false at the end */
+    /* throws SyntaxError */
+    bool next (Token& token, std::size_t& offset);
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <ostream>
+#include <functional>
+
+namespace mlang {
+namespace script {
+
+/* final destination of the script output */
+class OutputSink {
+public:
+    virtual ~OutputSink () = default;
+    virtual void write (std::string_view data) = 0;
+    virtual void flush ();
+};
+
+/* writes into a std::ostream, the stream must outlive the sink */
+class StreamSink : public OutputSink {
+private:
+    std::ostream& m_stream;
+public:
+    StreamSink (std::ostream& stream);
+    void write (std::string_view data) override;
+    void flush () override;
+};
+
+/* writes into a file descriptor with write(2), the descriptor is not owned */
+class FdSink : public OutputSink {
+private:
+    int m_fd { -1 };
+public:
+    FdSink (int fd);
+    void write (std::string_view data) override;
+};
+
+/* collects everything in memory */
+class StringSink : public OutputSink {
+private:
+    std::string m_str;
+public:
+    StringSink () = default;
+    void write (std::string_view data) override;
+    const std::string& get () const;
+    void clear ();
+};
+
+/* hands the data over to the host */
+class CallbackSink : public OutputSink {
+public:
+    typedef std::function<void (std::string_view)> callback_t;
+private:
+    callback_t m_callback;
+public:
+    CallbackSink (callback_t callback);
+    void write (std::string_view data) override;
+};
+
+/* buffered front end of a sink : text is appended into one buffer and handed to the sink */
+/* once the buffer reaches its capacity, on flush() and on destruction */
+/* a capacity of 0 hands every write over immediately (without flushing the sink) */
+class Output {
+private:
+    std::shared_ptr<OutputSink> m_sink;
+    std::string m_buffer;
+    std::size_t m_capacity { 0 };
+public:
+    static constexpr std::size_t default_capacity { 4096 };
+
+    /* std::cout without extra buffering, keeps the ordering with the host's own std::cout output */
+    Output ();
+    Output (std::shared_ptr<OutputSink> sink, std::size_t capacity = default_capacity);
+    Output (const Output&) = delete;
+    Output& operator= (const Output&) = delete;
+    ~Output ();
+
+    /* flushes the current sink and switches to the new one */
+    void reset (std::shared_ptr<OutputSink> sink, std::size_t capacity = default_capacity);
+
+    /* append directly into the buffer, then call commit(), an append that fails cuts the buffer back to where it started */
+    std::string& buffer ();
+    void commit ();
+
+    void write (std::string_view data);
+    void flush ();
+
+    const std::shared_ptr<OutputSink>& get_sink () const;
+    std::size_t get_capacity () const;
+};
+
+} /* namespace script */
+} /* namespace mlang */
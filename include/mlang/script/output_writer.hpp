@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#include "mlang/script/output.hpp"
+
+namespace mlang {
+namespace script {
+
+class OutputWriter;
+
+/* what a channel does when its pending output exceeds the limit */
+enum class overflow_policy {
+    block,  /* the script waits until the writer catches up */
+    drop    /* the text is discarded and counted */
+};
+
+/* per execution context output, set it on the EnvStack of one script (one producer thread) */
+/* complete lines are handed over to the writer thread, so lines of different channels never tear */
+/* the text of one channel reaches its destination in the order it was written */
+class ChannelSink : public OutputSink {
+private:
+    friend class OutputWriter;
+
+    struct State;
+    std::shared_ptr<State> m_state;
+    std::string m_partial;
+
+    ChannelSink (std::shared_ptr<State> state);
+    void hand_over (std::string&& text);
+public:
+    ~ChannelSink ();
+
+    void write (std::string_view data) override;
+    /* hands over the unfinished line and waits until everything of this channel reached the destination */
+    void flush () override;
+
+    std::size_t get_pending () const;
+    std::size_t get_dropped () const;
+};
+
+/* single writer thread draining every channel into the destination sinks */
+/* channels hand their text over through a lock-free queue, the scripts never touch the destinations */
+class OutputWriter {
+private:
+    friend class ChannelSink;
+
+    struct Chunk;
+    struct Core;
+    std::shared_ptr<Core> m_core;
+    std::shared_ptr<OutputSink> m_target;
+    std::thread m_thread;
+
+    static void run (std::shared_ptr<Core> core);
+public:
+    static constexpr std::size_t default_max_pending { 1 << 20 };
+
+    /* 'target' is the default destination of the channels */
+    OutputWriter (std::shared_ptr<OutputSink> target);
+    OutputWriter (const OutputWriter&) = delete;
+    OutputWriter& operator= (const OutputWriter&) = delete;
+    /* drains every channel, then stops the writer thread, a channel refuses the text handed over afterwards */
+    ~OutputWriter ();
+
+    std::shared_ptr<ChannelSink> open_channel (std::size_t max_pending = default_max_pending, overflow_policy policy = overflow_policy::block);
+    std::shared_ptr<ChannelSink> open_channel (std::shared_ptr<OutputSink> destination, std::size_t max_pending = default_max_pending, overflow_policy policy = overflow_policy::block);
+
+    /* number of destination writes that failed (the writer thread cannot report them otherwise) */
+    std::size_t get_errors () const;
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+
+#include "mlang/script/source.hpp"
+#include "mlang/script/environment.hpp"
+
+namespace mlang {
+
+namespace ast { class FlatTree; }
+
+namespace script {
+
+/* a compiled script that is never modified after it was built */
+/* every function body is compiled and literals are copied on use, any number of threads execute one instance at once */
+/* all mutable state of an execution (variables, functions, output) lives in the EnvStack it runs on */
+class Program {
+private:
+    std::shared_ptr<const Source> m_source;   /* the tree refers into it */
+    std::shared_ptr<const ast::FlatTree> m_tree;
+public:
+    Program (std::shared_ptr<const Source> source, std::shared_ptr<const ast::FlatTree> tree);
+    ~Program () = default;
+
+    const Source& get_source () const;
+    const ast::FlatTree& get_tree () const;
+
+    /* same results as Script::execute : 0 if the program finished, 2 after a runtime error, 3 if it exceeded its budget */
+    /* host functions declared in 'env' are shared by every thread that declares them, they have to be thread safe */
+    int execute (EnvStack& env) const;
+    /* a top-level 'return' or 'exit' ends the program, 'result' receives its value (None otherwise) */
+    int execute (EnvStack& env, object::Object& result) const;
+};
+
+/* one independent execution context of a shared program */
+/* an isolate is used by one thread at a time, different isolates of one program run in parallel */
+class Isolate {
+private:
+    std::shared_ptr<const Program> m_program;
+    EnvStack m_env;
+public:
+    explicit Isolate (std::shared_ptr<const Program> program);
+    ~Isolate () = default;
+
+    const Program& get_program () const;
+    /* declare inputs and host functions and set the output before calling run */
+    EnvStack& get_environment ();
+
+    /* executes the program, the variables it declares stay in the environment */
+    int run ();
+    /* drops every variable and function, the output is kept */
+    void reset ();
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+#include "mlang/script/token.hpp"
+#include "mlang/script/source.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/ast/node.hpp"
+
+namespace mlang {
+namespace script {
+
+/* what a top-level declaration of a script is, see ReloadableScript */
+enum class unit_kinds {
+    function,   /* function f (...) { ... } */
+    global,     /* var name ...; */
+    statement   /* everything else */
+};
+
+struct ReloadStats {
+    std::size_t units { 0 };       /* top-level declarations of the new text */
+    std::size_t reused { 0 };      /* unchanged, kept compiled */
+    std::size_t compiled { 0 };    /* new or changed, lexed and parsed */
+    std::size_t removed { 0 };     /* functions no longer in the text */
+    std::size_t executed { 0 };    /* units run against the environment */
+    std::size_t lexed_bytes { 0 };
+};
+
+/* a script compiled per top-level declaration, for scripts that are edited while they run */
+/* reload compares the new text with the previous one declaration by declaration and only compiles what changed */
+/*   - a new or changed function replaces the old one, a removed function is removed from the environment */
+/*   - a new global is declared, a global that already exists keeps its value even if its initializer changed */
+/*   - a new or changed statement runs once, unchanged statements do not run again */
+/* the functions declared in the environment refer into this object, it has to outlive their use */
+class ReloadableScript {
+private:
+    struct Unit {
+        unit_kinds kind;
+        std::string_view name;   /* function or global name, refers into 'source' */
+        std::size_t line;        /* first line in the whole script */
+        std::shared_ptr<Source> source;   /* the text of this declaration only */
+        ast::node_ptr node;
+        std::size_t reused_from;   /* index of the unchanged previous unit, its node moves over once the reload is applied */
+    };
+
+    static constexpr std::size_t not_reused { static_cast<std::size_t>(-1) };
+
+    std::vector<Unit> m_units;
+    ReloadStats m_stats;
+
+    /* splits the text and compiles every declaration that is not found in 'previous', throws SyntaxError */
+    /* 'previous' is not modified, a failed reload leaves everything as it was */
+    static std::vector<Unit> compile (std::string_view text, const std::vector<Unit>& previous, ReloadStats& stats);
+public:
+    /* throws SyntaxError */
+    ReloadableScript (std::string_view text);
+    ReloadableScript (const ReloadableScript&) = delete;
+    ReloadableScript& operator= (const ReloadableScript&) = delete;
+    ~ReloadableScript () = default;
+
+    /* runs every declaration in order, returns like Script::execute */
+    /* an error leaves the scopes it entered, the environment stays at the depth of the call */
+    int execute (EnvStack& env);
+
+    /* applies the changes of 'text' to 'env', which executed the previous text */
+    /* on a syntax error nothing changes and 1 is returned, the bodies of changed functions are compiled first */
+    /* a runtime error returns 2 and an exceeded budget 3, the new text is in place then */
+    int reload (std::string_view text, EnvStack& env);
+
+    const ReloadStats& get_stats () const;
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -2,8 +2,11 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+#include <memory>
 
 #include "mlang/script/token.hpp"
+#include "mlang/script/source.hpp"
 #include "mlang/script/environment.hpp"
 
 #define DEBUG_SCRIPT 0
@@ -13,22 +16,65 @@
 #endif
 
 namespace mlang {
+
+namespace ast { class FlatTree; }
+
 namespace script {
 
+class Program;
+
+/* how the AST is stored while the script executes, both give the same results */
+/* a syntax error in a function body is reported by the first call of the function with 'tree' and before anything runs with 'flat' */
+enum class ast_layout {
+    tree,   /* one heap allocated node per construct */
+    flat    /* ast::FlatTree, nodes stored contiguously and referenced by index */
+};
+
 class Script {
 private:
-    std::vector<Token> m_tokens;
+    /* the tokens are only materialized for get_tokens, compiling lexes while it parses */
+    struct TokenCache {
+        std::mutex mutex;
+        std::shared_ptr<const std::vector<Token>> tokens;
+    };
 
-    void debug(const std::string& debug_message);
+    std::shared_ptr<Source> m_source;   /* shared with the AST, the tokens and nodes refer into it */
+    std::shared_ptr<TokenCache> m_tokens;
+    std::shared_ptr<const ast::FlatTree> m_program;   /* set if the script was compiled or loaded precompiled */
+
+    Script (std::shared_ptr<Source> source);
+    Script (std::shared_ptr<Source> source, std::shared_ptr<const ast::FlatTree> program);
+    void debug(const std::string& debug_message) const;
 public:
     Script () = delete;
     Script (const std::string& script);
+    /* takes over the text, no copy of the script is made */
+    Script (std::string&& script);
+    /* maps the file instead of reading it, throws RuntimeError if it cannot be opened */
+    static Script from_file (const std::string& path);
+    /* maps a file written by save, nothing is lexed or parsed, throws RuntimeError if the file is invalid */
+    static Script load (const std::string& path);
     ~Script () = default;
 
-    
+    /* parses the script once into its precompiled form, later executions skip parsing */
+    /* every function body is compiled, throws SyntaxError */
+    void compile ();
+
+    /* compiles the script and shares the result, the program can be executed by many threads at once, throws SyntaxError */
+    std::shared_ptr<const Program> get_program ();
+
+    /* compiles the script and writes the versioned binary form to 'path' */
+    /* throws SyntaxError if the script does not compile and RuntimeError if the file cannot be written */
+    void save (const std::string& path) const;
+
+    /* lexes the whole script on the first call, throws SyntaxError */
     const std::vector<Token>& get_tokens () const;
+    const Source& get_source () const;
 
+    /* 0 if the script finished, 1 after a syntax error, 2 after a runtime error, 3 if it exceeded the budget of 'env' */
     int execute (EnvStack& env);
+    /* a compiled or loaded script always executes its precompiled flat tree */
+    int execute (EnvStack& env, ast_layout layout);
 };
 
 } /* namespace script */
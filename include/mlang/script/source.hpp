@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <mutex>
+#include <memory>
+
+#include "mlang/script/file.hpp"
+
+namespace mlang {
+namespace script {
+
+/* the one buffer holding the script text, tokens and AST nodes refer into it by std::string_view */
+/* string literals are copied only if escape processing changes them, those copies are kept here as well */
+/* the views stay valid as long as the source lives, the text itself is never modified */
+/* literals may be stored from several threads, function bodies compiled on their first call lex the source again */
+/* a literal is kept once per position in the text, lexing the text again reuses it */
+class Source {
+private:
+    std::string m_text;
+    std::shared_ptr<const MappedFile> m_file;   /* set instead of m_text if the script is a file */
+    std::string_view m_view;
+    std::map<std::size_t, std::string> m_literals;   /* by offset in the text, a map never moves its elements -> the views stay valid */
+    std::size_t m_literal_size { 0 };
+    mutable std::mutex m_literal_mutex;
+public:
+    Source () = delete;
+    explicit Source (std::string text);
+    explicit Source (std::shared_ptr<const MappedFile> file);
+    Source (const Source&) = delete;
+    Source& operator= (const Source&) = delete;
+    ~Source () = default;
+
+    std::string_view get_text () const;
+
+    /* keeps a literal that is not part of the text, 'offset' is where it starts in the text */
+    /* returns the literal already kept for that offset, if any */
+    std::string_view store (std::size_t offset, std::string&& literal);
+
+    /* bytes held by the source, the text plus the materialized literals */
+    std::size_t get_size () const;
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace mlang {
 namespace script {
@@ -80,19 +81,20 @@ enum class token_types {
     kw_var,                /* var */
     kw_return,             /* return */
     kw_exit,               /* exit */
-    kw_print               /* print */
+    kw_print,              /* print */
+    kw_format              /* format */
 };
 
 struct Token {
     std::size_t line { 0 };
     std::size_t pos { 0 };
     token_types type;
-    std::string value_str;         /* for strings and identifiers */
+    std::string_view value_str;    /* for strings and identifiers, refers into the script::Source */
     double value_float { 0.0 };    /* for floats */
     int value_int { 0 };           /* for integers */
     bool value_bool { false };     /* for booleans */
 
-    Token (token_types token_type, const std::string& value, std::size_t line_num, std::size_t position) : type(token_type), value_str(value), line(line_num), pos(position)  {}
+    Token (token_types token_type, std::string_view value, std::size_t line_num, std::size_t position) : type(token_type), value_str(value), line(line_num), pos(position)  {}
     Token (token_types token_type, const char* value, std::size_t line_num, std::size_t position) : type(token_type), value_str(value), line(line_num), pos(position)  {}
     Token (token_types token_type, double value, std::size_t line_num, std::size_t position) : type(token_type), value_float(value), line(line_num), pos(position)  {}
     Token (token_types token_type, int value, std::size_t line_num, std::size_t position) : type(token_type), value_int(value), line(line_num), pos(position)  {}
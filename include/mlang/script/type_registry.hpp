@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include "mlang/object/internal_object.hpp"
+
+namespace mlang {
+namespace script {
+
+/* index of a type in the registry, never changes once the type is defined, call sites may cache it */
+typedef std::uint32_t type_id;
+
+inline constexpr type_id unknown_type { 0xFFFFFFFF };
+
+/* the built-in types are defined first, their ids are fixed */
+namespace builtin_types {
+    inline constexpr type_id none { 0 };
+    inline constexpr type_id integer { 1 };
+    inline constexpr type_id floating { 2 };
+    inline constexpr type_id boolean { 3 };
+    inline constexpr type_id array { 4 };
+    inline constexpr type_id string { 5 };
+} /* namespace builtin_types */
+
+/* every type a script can create, shared by all threads */
+/* lookups never lock or wait: the names are resolved in an append-only hash table with linear probing */
+/* and the factories are read from a fixed array by id, a definition publishes its entry in a free slot */
+/* types are never removed, so an entry is never moved or freed while the registry exists */
+class TypeRegistry {
+public:
+    static constexpr std::size_t max_types { 4096 };
+private:
+    struct Entry {
+        std::string name;
+        type_id id;
+    };
+
+    /* a power of two, the table is at most half full */
+    static constexpr std::size_t slot_count { 2 * max_types };
+
+    std::array<std::atomic<const Entry*>, slot_count> m_slots {};
+    std::array<std::atomic<const object::ObjectFactory*>, max_types> m_factories {};
+    std::atomic<std::size_t> m_size { 0 };
+
+    /* writers only */
+    std::mutex m_define_mutex;
+    std::vector<std::unique_ptr<const Entry>> m_entries;
+    std::vector<std::shared_ptr<object::ObjectFactory>> m_owned;
+
+    static std::size_t slot_of (std::string_view type_name);
+
+    TypeRegistry ();
+public:
+    TypeRegistry (const TypeRegistry&) = delete;
+    TypeRegistry& operator= (const TypeRegistry&) = delete;
+    ~TypeRegistry () = default;
+
+    /* the registry of the process, the built-in types are defined */
+    static TypeRegistry& instance ();
+
+    /* throws RuntimeError if the name is taken or the registry is full */
+    type_id define (std::string_view type_name, std::shared_ptr<object::ObjectFactory> factory);
+
+    /* unknown_type if there is no such type */
+    type_id find (std::string_view type_name) const;
+    bool has (std::string_view type_name) const;
+    std::size_t size () const;
+
+    /* throws RuntimeError if the type is unknown */
+    const object::ObjectFactory& get_factory (type_id type) const;
+    const object::ObjectFactory& get_factory (std::string_view type_name) const;
+};
+
+} /* namespace script */
+} /* namespace mlang */
@@ -1,9 +1,10 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <filesystem>
 
 #include "mlang/script/script.hpp"
+#include "mlang/script/file.hpp"
+#include "mlang/exception.hpp"
 
 int main(int argc, char* argv[]) {
 
@@ -14,15 +15,22 @@ int main(int argc, char* argv[]) {
 
     std::string script_path { argv[1] };
 
-    std::ifstream file { script_path };
-    if (!file.is_open()) return 1;
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
-
-    mlang::script::Script script { buffer.str() };
     mlang::script::EnvStack env {};
-    script.execute(env);
+    mlang::script::declare_file_functions(env);
+    try {
+        /* scripts precompiled by mlangc are loaded instead of parsed */
+        const bool precompiled = std::filesystem::path { script_path }.extension() == ".mlangc";
+        mlang::script::Script script = precompiled ? mlang::script::Script::load(script_path) : mlang::script::Script::from_file(script_path);
+        script.execute(env);
+    }
+    catch (const mlang::SyntaxError& e) {
+        std::cerr << "ERROR : " << e.what() << std::endl;
+        return 1;
+    }
+    catch (const mlang::RuntimeError& e) {
+        std::cerr << "ERROR : " << e.what() << std::endl;
+        return 1;
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -3,14 +3,21 @@
 namespace mlang {
 namespace ast {
 
-ConstructorNode::ConstructorNode(const std::string& type_name) : Node(ast_node_types::constructor), m_type_name(type_name) {}
+ConstructorNode::ConstructorNode(std::string_view type_name) : Node(ast_node_types::constructor), m_type_name(type_name) {}
 
 object::Object ConstructorNode::execute (script::EnvStack& env) const {
     std::vector<object::Object> arguments;
     for (const auto& arg : m_arguments) {
         arguments.push_back(arg->execute(env));
     }
-    object::Object new_object { script::Environment::get_factory(m_type_name) };
+    /* the id of a type never changes, the first execution resolves it for every thread */
+    script::type_id type = m_type.load(std::memory_order_relaxed);
+    if (type == script::unknown_type) {
+        type = script::Environment::find_type(m_type_name);
+        if (type == script::unknown_type) { throw RuntimeError{"type '" + std::string { m_type_name } + "' is unknown"}; }
+        m_type.store(type, std::memory_order_relaxed);
+    }
+    object::Object new_object { script::Environment::get_factory(type) };
     new_object.construct(arguments);
     return new_object;
 }
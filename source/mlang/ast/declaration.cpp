@@ -5,12 +5,12 @@
 namespace mlang {
 namespace ast {
 
-DeclarationOperationNode::DeclarationOperationNode(const std::string& var_name) : Node(ast_node_types::declaration), m_var_name(var_name) {}
+DeclarationOperationNode::DeclarationOperationNode(std::string_view var_name) : Node(ast_node_types::declaration), m_var_name(var_name) {}
 
-const std::string& DeclarationOperationNode::get_var_name () const { return m_var_name; }
+std::string_view DeclarationOperationNode::get_var_name () const { return m_var_name; }
 
 object::Object DeclarationOperationNode::execute (script::EnvStack& env) const {
-    env.declare_variable(m_var_name, object::None::type_name);
+    env.declare_variable(m_var_name, script::builtin_types::none);
     return object::Object{};
 }
 
@@ -21,15 +21,15 @@ void DeclarationOperationNode::print () const {
 
 
 
-DeclAndInitOperationNode::DeclAndInitOperationNode(const std::string& var_name, node_ptr right) : Node(ast_node_types::declaration), m_var_name(var_name), m_right(std::move(right)) {}
+DeclAndInitOperationNode::DeclAndInitOperationNode(std::string_view var_name, node_ptr right) : Node(ast_node_types::declaration), m_var_name(var_name), m_right(std::move(right)) {}
 
-const std::string& DeclAndInitOperationNode::get_var_name () const { return m_var_name; }
+std::string_view DeclAndInitOperationNode::get_var_name () const { return m_var_name; }
 
 const Node* const DeclAndInitOperationNode::get_right () const { return m_right.get(); }
 
 object::Object DeclAndInitOperationNode::execute (script::EnvStack& env) const {
     object::Object rhs = m_right->execute(env);
-    env.declare_variable(m_var_name, object::None::type_name);
+    env.declare_variable(m_var_name, script::builtin_types::none);
     env.get_variable(m_var_name).assign(rhs);
     return object::Object{};
 }
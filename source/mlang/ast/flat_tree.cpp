@@ -0,0 +1,723 @@
+#include <cstring>
+#include <unordered_map>
+
+#include "mlang/ast/flat_tree.hpp"
+#include "mlang/ast/exception.hpp"
+#include "mlang/ast/binary_operations.hpp"
+#include "mlang/ast/comparison.hpp"
+#include "mlang/ast/logic_operations.hpp"
+#include "mlang/ast/assignment.hpp"
+#include "mlang/object/none.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/float.hpp"
+#include "mlang/object/boolean.hpp"
+
+namespace mlang {
+namespace ast {
+
+namespace {
+
+/* layout of the serialized tree, all values in the byte order of the host : */
+/*   header, nodes, lines, lists, constants, names, members, format rules, functions, text */
+/* strings are (offset, length) pairs into the text section, which comes last */
+constexpr char program_magic[8] { 'M', 'L', 'A', 'N', 'G', 'P', 'C', '\0' };
+constexpr std::uint32_t byte_order_mark { 0x01020304 };
+
+struct ProgramHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t node_count;
+    std::uint32_t list_size;
+    std::uint32_t constant_count;
+    std::uint32_t name_count;
+    std::uint32_t member_count;
+    std::uint32_t format_count;
+    std::uint32_t function_count;
+    std::uint32_t root;
+    std::uint32_t text_size;
+    std::uint32_t reserved;
+};
+
+struct StringRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+enum class constant_tags : std::uint32_t {
+    integer,
+    floating,
+    boolean,
+    string,
+    none      /* the 'none' literal */
+};
+
+struct SerialConstant {
+    constant_tags tag;
+    std::uint32_t length;   /* string : length of the text */
+    std::uint64_t value;    /* int, bits of the double, bool or offset of the text */
+};
+
+struct SerialFunction {
+    std::uint32_t name;
+    std::uint32_t params;
+    node_index body;
+};
+
+template <typename T>
+void append (std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/* collects the strings of the tree, repeated names are stored once */
+class TextWriter {
+private:
+    std::string m_text;
+    std::unordered_map<std::string, StringRef> m_known;
+public:
+    StringRef add (std::string_view str) {
+        auto it = m_known.find(std::string { str });
+        if (it != m_known.end()) { return it->second; }
+        const StringRef ref { static_cast<std::uint32_t>(m_text.size()), static_cast<std::uint32_t>(str.size()) };
+        m_text.append(str);
+        m_known.emplace(std::string { str }, ref);
+        return ref;
+    }
+    const std::string& get () const { return m_text; }
+};
+
+/* bounds checked sequential reads, every value is copied out so the data needs no alignment */
+class DataReader {
+private:
+    std::string_view m_data;
+    std::size_t m_pos { 0 };
+public:
+    DataReader (std::string_view data) : m_data(data) {}
+
+    template <typename T>
+    T read () {
+        if (m_data.size() - m_pos < sizeof(T)) { throw RuntimeError{ "invalid program file : unexpected end of data" }; }
+        T value;
+        std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void read (std::vector<T>& values, std::size_t count) {
+        values.resize(count);
+        if (count == 0) { return; }
+        if ((m_data.size() - m_pos) / sizeof(T) < count) { throw RuntimeError{ "invalid program file : unexpected end of data" }; }
+        std::memcpy(values.data(), m_data.data() + m_pos, count * sizeof(T));
+        m_pos += count * sizeof(T);
+    }
+
+    std::size_t get_position () const { return m_pos; }
+};
+
+} /* namespace */
+
+FlatFunction::FlatFunction (const FlatTree* tree, std::uint32_t name, std::uint32_t params, node_index body) : m_tree(tree), m_name(name), m_params(params), m_body(body) {}
+
+/* same semantics as FunctionDeclNode::call */
+object::Object FlatFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    const std::string_view name = m_tree->m_names[m_name];
+    const std::span<const std::uint32_t> param_names = m_tree->list(m_params);
+    if (params.size() != param_names.size()) {
+        throw RuntimeError{ "function " + std::string { name } + " expects " + std::to_string(param_names.size()) + " parameters but got " + std::to_string(params.size()) };
+    }
+    env.step();
+    env.enter_scope();
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        const std::string_view param_name = m_tree->m_names[param_names[i]];
+        env.declare_variable(param_name, params[i].get_typename());
+        env.get_variable(param_name).assign(params[i]);
+    }
+    try {
+        m_tree->evaluate(m_body, env);
+    }
+    catch (const Break& e) {
+        env.exit_scope();
+        throw RuntimeError{ "invalid 'break' in function " + std::string { name } };
+    }
+    catch (const Continue& e) {
+        env.exit_scope();
+        throw RuntimeError{ "invalid 'continue' in function " + std::string { name } };
+    }
+    catch (const Return& e) {
+        env.exit_scope();
+        return e.get_value();
+    }
+    env.exit_scope();
+    return object::Object {};
+}
+
+node_index FlatTree::add_node (ast_node_types type, std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+    m_nodes.push_back(FlatNode { type, a, b, c });
+    m_lines.push_back(0);
+    return static_cast<node_index>(m_nodes.size() - 1);
+}
+
+std::uint32_t FlatTree::add_list (std::span<const node_index> items) {
+    const std::uint32_t offset = static_cast<std::uint32_t>(m_lists.size());
+    m_lists.push_back(static_cast<std::uint32_t>(items.size()));
+    m_lists.insert(m_lists.end(), items.begin(), items.end());
+    return offset;
+}
+
+std::uint32_t FlatTree::add_constant (object::Object value) {
+    m_constants.push_back(std::move(value));
+    return static_cast<std::uint32_t>(m_constants.size() - 1);
+}
+
+std::uint32_t FlatTree::add_name (std::string_view name) {
+    m_names.push_back(name);
+    return static_cast<std::uint32_t>(m_names.size() - 1);
+}
+
+std::uint32_t FlatTree::add_member (std::string_view member) {
+    m_members.emplace_back(member);
+    return static_cast<std::uint32_t>(m_members.size() - 1);
+}
+
+std::uint32_t FlatTree::add_format (std::string_view rule, object::Format format) {
+    m_formats.push_back(std::move(format));
+    m_format_rules.push_back(rule);
+    return static_cast<std::uint32_t>(m_formats.size() - 1);
+}
+
+std::uint32_t FlatTree::add_function (std::uint32_t name, std::uint32_t params, node_index body) {
+    m_functions.emplace_back(this, name, params, body);
+    return static_cast<std::uint32_t>(m_functions.size() - 1);
+}
+
+void FlatTree::set_line (node_index index, std::uint32_t line) { m_lines[index] = line; }
+
+void FlatTree::set_root (node_index root) { m_root = root; }
+
+void FlatTree::set_source (std::shared_ptr<const script::Source> source) { m_source = std::move(source); }
+
+const FlatNode& FlatTree::get_node (node_index index) const { return m_nodes[index]; }
+
+std::size_t FlatTree::get_node_count () const { return m_nodes.size(); }
+
+node_index FlatTree::get_root () const { return m_root; }
+
+std::uint32_t FlatTree::get_line (node_index index) const { return m_lines[index]; }
+
+std::span<const std::uint32_t> FlatTree::list (std::uint32_t offset) const {
+    return std::span<const std::uint32_t> { m_lists.data() + offset + 1, m_lists[offset] };
+}
+
+void FlatTree::evaluate_list (std::uint32_t offset, script::EnvStack& env, std::vector<object::Object>& values) const {
+    const std::span<const std::uint32_t> items = list(offset);
+    values.reserve(items.size());
+    for (const node_index item : items) {
+        values.push_back(evaluate(item, env));
+    }
+}
+
+object::Object FlatTree::evaluate_array (const FlatNode& node, script::EnvStack& env) const {
+    std::vector<object::Object> elements;
+    evaluate_list(node.c, env, elements);
+    return object::Object{std::make_shared<object::Array>(elements)};
+}
+
+object::Object FlatTree::evaluate_arithmetic (const FlatNode& node, script::EnvStack& env) const {
+    object::Object lhs = evaluate(node.a, env);
+    object::Object rhs = evaluate(node.b, env);
+    switch (static_cast<arithmetic_mode>(node.c)) {
+        case arithmetic_mode::add : { return lhs.operator_binary_add(rhs); }
+        case arithmetic_mode::sub : { return lhs.operator_binary_sub(rhs); }
+        case arithmetic_mode::mul : { return lhs.operator_binary_mul(rhs); }
+        case arithmetic_mode::div : { return lhs.operator_binary_div(rhs); }
+        default : { break; }
+    }
+    throw RuntimeError{"invalid arithmetic operator type"};
+}
+
+object::Object FlatTree::evaluate_comparison (const FlatNode& node, script::EnvStack& env) const {
+    object::Object lhs = evaluate(node.a, env);
+    object::Object rhs = evaluate(node.b, env);
+    switch (static_cast<comparison_mode>(node.c)) {
+        case comparison_mode::equal         : { return lhs.operator_comparison_equal(rhs); }
+        case comparison_mode::not_equal     : { return lhs.operator_comparison_not_equal(rhs); }
+        case comparison_mode::greater       : { return lhs.operator_greater(rhs); }
+        case comparison_mode::less          : { return lhs.operator_less(rhs); }
+        case comparison_mode::greater_equal : { return lhs.operator_greater_equal(rhs); }
+        case comparison_mode::less_equal    : { return lhs.operator_less_equal(rhs); }
+        default : { break; }
+    }
+    throw RuntimeError{"invalid comparison operator type"};
+}
+
+object::Object FlatTree::evaluate_logic (const FlatNode& node, script::EnvStack& env) const {
+    object::Object lhs = evaluate(node.a, env);
+    object::Object rhs = evaluate(node.b, env);
+    switch (static_cast<logic_mode>(node.c)) {
+        case logic_mode::logic_and : { return lhs.operator_binary_and(rhs); }
+        case logic_mode::logic_or  : { return lhs.operator_binary_or(rhs); }
+        default : { break; }
+    }
+    throw RuntimeError{"invalid logic operator type"};
+}
+
+object::Object FlatTree::evaluate_assignment (const FlatNode& node, script::EnvStack& env) const {
+    object::Object lhs = evaluate(node.a, env);
+    object::Object rhs = evaluate(node.b, env);
+    switch (static_cast<assignment_mode>(node.c)) {
+        case assignment_mode::simple : { lhs.assign(rhs); break; }
+        case assignment_mode::add    : { lhs.operator_add_equal(rhs); break; }
+        case assignment_mode::sub    : { lhs.operator_sub_equal(rhs); break; }
+        case assignment_mode::mul    : { lhs.operator_mul_equal(rhs); break; }
+        case assignment_mode::div    : { lhs.operator_div_equal(rhs); break; }
+        default : { throw RuntimeError{"invalid assignment operator type"}; }
+    }
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_declaration (const FlatNode& node, script::EnvStack& env) const {
+    if (node.b == no_node) {
+        env.declare_variable(m_names[node.a], script::builtin_types::none);
+        return object::Object {};
+    }
+    object::Object rhs = evaluate(node.b, env);
+    env.declare_variable(m_names[node.a], script::builtin_types::none);
+    env.get_variable(m_names[node.a]).assign(rhs);
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_format (const FlatNode& node, script::EnvStack& env) const {
+    std::vector<object::Object> args;
+    evaluate_list(node.c, env, args);
+    return object::Object { std::make_shared<object::String>(m_formats[node.a].format(args)) };
+}
+
+object::Object FlatTree::evaluate_if (const FlatNode& node, script::EnvStack& env) const {
+    /* list of condition and body pairs, the else body is optional */
+    const std::span<const std::uint32_t> branches = list(node.c);
+    env.enter_scope();
+    try {
+        bool taken = false;
+        for (std::size_t i = 0; i < branches.size(); i += 2) {
+            if (evaluate(branches[i], env).is_true()) {
+                evaluate(branches[i + 1], env);
+                taken = true;
+                break;
+            }
+        }
+        if (!taken && (node.a != no_node)) { evaluate(node.a, env); }
+    }
+    catch (const Break& e) {
+        env.exit_scope();
+        throw;
+    }
+    catch (const Continue& e) {
+        env.exit_scope();
+        throw;
+    }
+    catch (const Return& e) {
+        env.exit_scope();
+        throw;
+    }
+    env.exit_scope();
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_for (const FlatNode& node, script::EnvStack& env) const {
+    /* initialization, test, update and body, the first three are optional */
+    const std::span<const std::uint32_t> parts = list(node.c);
+    env.enter_scope();
+    if (parts[0] != no_node) { evaluate(parts[0], env); }
+    while (true) {
+        env.step();
+        env.enter_scope();
+        if ((parts[1] != no_node) && !evaluate(parts[1], env).is_true()) {
+            env.exit_scope();
+            break;
+        }
+        try {
+            evaluate(parts[3], env);
+        }
+        catch (const Break& e) {
+            env.exit_scope();
+            break;
+        }
+        catch (const Continue& e) {
+            /* nothing to do, we carry on with the updates */
+        }
+        catch (const Return& e) {
+            env.exit_scope();
+            env.exit_scope();
+            throw;
+        }
+        if (parts[2] != no_node) { evaluate(parts[2], env); }
+        env.exit_scope();
+    }
+    env.exit_scope();
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_while (const FlatNode& node, script::EnvStack& env) const {
+    while (true) {
+        env.step();
+        env.enter_scope();
+        if (!evaluate(node.a, env).is_true()) {
+            env.exit_scope();
+            break;
+        }
+        try {
+            evaluate(node.b, env);
+        }
+        catch (const Break& e) {
+            env.exit_scope();
+            break;
+        }
+        catch (const Continue& e) {
+            env.exit_scope();
+            continue;
+        }
+        catch (const Return& e) {
+            env.exit_scope();
+            throw;
+        }
+        env.exit_scope();
+    }
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_print (const FlatNode& node, script::EnvStack& env) const {
+    std::vector<object::Object> args;
+    evaluate_list(node.c, env, args);
+    script::Output& output = env.get_output();
+    /* a print whose arguments fail to convert prints nothing, write leaves the buffer as it was */
+    m_formats[node.a].write(output.buffer(), args);
+    output.commit();
+    return object::Object {};
+}
+
+object::Object FlatTree::evaluate_member_call (const FlatNode& node, script::EnvStack& env) const {
+    /* the parameters are evaluated before the object, like MemberFunctionNode does */
+    std::vector<object::Object> params;
+    evaluate_list(node.c, env, params);
+    object::Object lhs = evaluate(node.a, env);
+    return lhs.call(m_members[node.b], params);
+}
+
+object::Object FlatTree::evaluate_call (const FlatNode& node, script::EnvStack& env) const {
+    std::vector<object::Object> params;
+    evaluate_list(node.c, env, params);
+    return env.get_function(m_names[node.a])->call(env, params);
+}
+
+object::Object FlatTree::evaluate_constructor (const FlatNode& node, script::EnvStack& env) const {
+    std::vector<object::Object> arguments;
+    evaluate_list(node.c, env, arguments);
+    object::Object new_object { script::Environment::get_factory(m_names[node.a]) };
+    new_object.construct(arguments);
+    return new_object;
+}
+
+/* every case mirrors the execute method of the corresponding node class */
+object::Object FlatTree::evaluate (node_index index, script::EnvStack& env) const {
+    const FlatNode& node = m_nodes[index];
+    switch (node.type) {
+        case ast_node_types::value : { return m_constants[node.a].copy(); }
+        case ast_node_types::variable : { return env.get_variable(m_names[node.a]); }
+        case ast_node_types::array : { return evaluate_array(node, env); }
+        case ast_node_types::constructor : { return evaluate_constructor(node, env); }
+        case ast_node_types::unary_not : { return evaluate(node.a, env).unary_not(); }
+        case ast_node_types::unary_minus : { return evaluate(node.a, env).unary_minus(); }
+        case ast_node_types::prefix : {
+            if (node.b == 0) { return evaluate(node.a, env).prefix_increment(); }
+            return evaluate(node.a, env).prefix_decrement();
+        }
+        case ast_node_types::postfix : {
+            if (node.b == 0) { return evaluate(node.a, env).postfix_increment(); }
+            return evaluate(node.a, env).postfix_decrement();
+        }
+        case ast_node_types::binary_arith : { return evaluate_arithmetic(node, env); }
+        case ast_node_types::comparison : { return evaluate_comparison(node, env); }
+        case ast_node_types::logic : { return evaluate_logic(node, env); }
+        case ast_node_types::assignment : { return evaluate_assignment(node, env); }
+        case ast_node_types::subscript : {
+            object::Object lhs = evaluate(node.a, env);
+            object::Object subscript_index = evaluate(node.b, env);
+            return lhs.operator_subscript(subscript_index);
+        }
+        case ast_node_types::member_access : {
+            object::Object lhs = evaluate(node.a, env);
+            return lhs.access(m_members[node.b]);
+        }
+        case ast_node_types::member_func : { return evaluate_member_call(node, env); }
+        case ast_node_types::func_call : { return evaluate_call(node, env); }
+        case ast_node_types::func_decl : {
+            const FlatFunction& function = m_functions[node.a];
+            env.declare_function(m_names[function.m_name], &function);
+            return object::Object {};
+        }
+        case ast_node_types::declaration : { return evaluate_declaration(node, env); }
+        case ast_node_types::print : { return evaluate_print(node, env); }
+        case ast_node_types::format : { return evaluate_format(node, env); }
+        case ast_node_types::main :
+        case ast_node_types::block : {
+            for (const node_index item : list(node.c)) {
+                evaluate(item, env);
+            }
+            return object::Object {};
+        }
+        case ast_node_types::break_node : { throw Break {}; }
+        case ast_node_types::continue_node : { throw Continue {}; }
+        case ast_node_types::return_node : { throw Return { evaluate(node.a, env) }; }
+        case ast_node_types::exit_node : { throw Exit { evaluate(node.a, env) }; }
+        case ast_node_types::if_statement : { return evaluate_if(node, env); }
+        case ast_node_types::for_statement : { return evaluate_for(node, env); }
+        case ast_node_types::while_statement : { return evaluate_while(node, env); }
+        default : { break; }
+    }
+    throw RuntimeError{"invalid node type in flat tree"};
+}
+
+void FlatTree::serialize (std::string& out) const {
+    TextWriter text;
+    std::vector<SerialConstant> constants;
+    constants.reserve(m_constants.size());
+    for (const object::Object& constant : m_constants) {
+        const std::string type_name = constant.get_typename();
+        SerialConstant serial { constant_tags::integer, 0, 0 };
+        if (type_name == object::Int::type_name) {
+            serial.value = static_cast<std::uint64_t>(static_cast<std::int64_t>(constant.get_int()));
+        }
+        else if (type_name == object::Float::type_name) {
+            const double value = constant.get_float();
+            serial.tag = constant_tags::floating;
+            std::memcpy(&serial.value, &value, sizeof(value));
+        }
+        else if (type_name == object::Boolean::type_name) {
+            serial.tag = constant_tags::boolean;
+            serial.value = constant.is_true() ? 1 : 0;
+        }
+        else if (type_name == object::String::type_name) {
+            const StringRef ref = text.add(constant.get_string());
+            serial.tag = constant_tags::string;
+            serial.length = ref.length;
+            serial.value = ref.offset;
+        }
+        else if (type_name == object::None::type_name) {
+            serial.tag = constant_tags::none;
+        }
+        else {
+            throw RuntimeError{ "constant of type " + type_name + " cannot be serialized" };
+        }
+        constants.push_back(serial);
+    }
+    std::vector<StringRef> names;
+    for (std::string_view name : m_names) { names.push_back(text.add(name)); }
+    std::vector<StringRef> members;
+    for (const std::string& member : m_members) { members.push_back(text.add(member)); }
+    std::vector<StringRef> rules;
+    for (std::string_view rule : m_format_rules) { rules.push_back(text.add(rule)); }
+
+    ProgramHeader header {};
+    std::memcpy(header.magic, program_magic, sizeof(program_magic));
+    header.version = program_format_version;
+    header.byte_order = byte_order_mark;
+    header.node_count = static_cast<std::uint32_t>(m_nodes.size());
+    header.list_size = static_cast<std::uint32_t>(m_lists.size());
+    header.constant_count = static_cast<std::uint32_t>(constants.size());
+    header.name_count = static_cast<std::uint32_t>(names.size());
+    header.member_count = static_cast<std::uint32_t>(members.size());
+    header.format_count = static_cast<std::uint32_t>(rules.size());
+    header.function_count = static_cast<std::uint32_t>(m_functions.size());
+    header.root = m_root;
+    header.text_size = static_cast<std::uint32_t>(text.get().size());
+
+    out.reserve(out.size() + sizeof(header) + m_nodes.size() * (sizeof(FlatNode) + 4) + m_lists.size() * 4 + text.get().size());
+    append(out, header);
+    for (const FlatNode& node : m_nodes) {
+        append(out, static_cast<std::uint32_t>(node.type));
+        append(out, node.a);
+        append(out, node.b);
+        append(out, node.c);
+    }
+    for (const std::uint32_t line : m_lines) { append(out, line); }
+    for (const std::uint32_t item : m_lists) { append(out, item); }
+    for (const SerialConstant& constant : constants) { append(out, constant); }
+    for (const StringRef& name : names) { append(out, name); }
+    for (const StringRef& member : members) { append(out, member); }
+    for (const StringRef& rule : rules) { append(out, rule); }
+    for (const FlatFunction& function : m_functions) {
+        append(out, SerialFunction { function.m_name, function.m_params, function.m_body });
+    }
+    out.append(text.get());
+}
+
+std::unique_ptr<FlatTree> FlatTree::deserialize (std::shared_ptr<const script::Source> data) {
+    const std::string_view bytes = data->get_text();
+    DataReader reader { bytes };
+    const ProgramHeader header = reader.read<ProgramHeader>();
+    if (std::memcmp(header.magic, program_magic, sizeof(program_magic)) != 0) {
+        throw RuntimeError{ "invalid program file : not a precompiled script" };
+    }
+    if (header.byte_order != byte_order_mark) {
+        throw RuntimeError{ "invalid program file : written on a machine with another byte order" };
+    }
+    if (header.version != program_format_version) {
+        throw RuntimeError{ "invalid program file : format version " + std::to_string(header.version) + ", expected " + std::to_string(program_format_version) };
+    }
+    /* the counts must add up to the size exactly before anything is allocated for them */
+    const std::uint64_t expected_size = sizeof(ProgramHeader)
+        + static_cast<std::uint64_t>(header.node_count) * (4 * sizeof(std::uint32_t) + sizeof(std::uint32_t))
+        + static_cast<std::uint64_t>(header.list_size) * sizeof(std::uint32_t)
+        + static_cast<std::uint64_t>(header.constant_count) * sizeof(SerialConstant)
+        + (static_cast<std::uint64_t>(header.name_count) + header.member_count + header.format_count) * sizeof(StringRef)
+        + static_cast<std::uint64_t>(header.function_count) * sizeof(SerialFunction)
+        + header.text_size;
+    if (expected_size != bytes.size()) {
+        throw RuntimeError{ "invalid program file : size does not match the header" };
+    }
+
+    std::unique_ptr<FlatTree> tree = std::make_unique<FlatTree>();
+    std::vector<std::uint32_t> raw_nodes;
+    reader.read(raw_nodes, static_cast<std::size_t>(header.node_count) * 4);
+    reader.read(tree->m_lines, header.node_count);
+    reader.read(tree->m_lists, header.list_size);
+    std::vector<SerialConstant> constants;
+    reader.read(constants, header.constant_count);
+    std::vector<StringRef> names;
+    reader.read(names, header.name_count);
+    std::vector<StringRef> members;
+    reader.read(members, header.member_count);
+    std::vector<StringRef> rules;
+    reader.read(rules, header.format_count);
+    std::vector<SerialFunction> functions;
+    reader.read(functions, header.function_count);
+    const std::string_view text = bytes.substr(reader.get_position());
+
+    auto text_of = [&text] (std::uint32_t offset, std::uint32_t length) {
+        if ((offset > text.size()) || (length > text.size() - offset)) {
+            throw RuntimeError{ "invalid program file : string out of range" };
+        }
+        return text.substr(offset, length);
+    };
+    tree->m_constants.reserve(constants.size());
+    for (const SerialConstant& constant : constants) {
+        switch (constant.tag) {
+            case constant_tags::integer : {
+                tree->m_constants.emplace_back(std::make_shared<object::Int>(static_cast<int>(static_cast<std::int64_t>(constant.value))));
+                break;
+            }
+            case constant_tags::floating : {
+                double value = 0.0;
+                std::memcpy(&value, &constant.value, sizeof(value));
+                tree->m_constants.emplace_back(std::make_shared<object::Float>(value));
+                break;
+            }
+            case constant_tags::boolean : {
+                tree->m_constants.emplace_back(std::make_shared<object::Boolean>(constant.value != 0));
+                break;
+            }
+            case constant_tags::string : {
+                if (constant.value > text.size()) { throw RuntimeError{ "invalid program file : string out of range" }; }
+                tree->m_constants.emplace_back(std::make_shared<object::String>(text_of(static_cast<std::uint32_t>(constant.value), constant.length), data));
+                break;
+            }
+            case constant_tags::none : {
+                tree->m_constants.emplace_back(std::make_shared<object::None>());
+                break;
+            }
+            default : { throw RuntimeError{ "invalid program file : unknown constant type" }; }
+        }
+    }
+    for (const StringRef& name : names) { tree->m_names.push_back(text_of(name.offset, name.length)); }
+    for (const StringRef& member : members) { tree->m_members.emplace_back(text_of(member.offset, member.length)); }
+    for (const StringRef& rule : rules) {
+        tree->m_format_rules.push_back(text_of(rule.offset, rule.length));
+        tree->m_formats.emplace_back(tree->m_format_rules.back());
+    }
+
+    /* a list is valid if it lies in the list section and every item satisfies 'valid' */
+    auto check_list = [&tree] (std::uint32_t offset, auto valid) {
+        if (offset >= tree->m_lists.size()) { return false; }
+        if (tree->m_lists[offset] > tree->m_lists.size() - offset - 1) { return false; }
+        for (const std::uint32_t item : tree->list(offset)) {
+            if (!valid(item)) { return false; }
+        }
+        return true;
+    };
+    for (const SerialFunction& function : functions) {
+        const bool valid = (function.name < names.size()) && (function.body < header.node_count)
+                        && check_list(function.params, [&names] (std::uint32_t item) { return item < names.size(); });
+        if (!valid) { throw RuntimeError{ "invalid program file : corrupt function" }; }
+        tree->add_function(function.name, function.params, function.body);
+    }
+
+    /* children always come before their parent, which also rules out cycles */
+    tree->m_nodes.reserve(header.node_count);
+    for (node_index i = 0; i < header.node_count; ++i) {
+        const FlatNode node { static_cast<ast_node_types>(raw_nodes[i * 4]), raw_nodes[i * 4 + 1], raw_nodes[i * 4 + 2], raw_nodes[i * 4 + 3] };
+        auto child = [i] (std::uint32_t index) { return index < i; };
+        auto optional = [i] (std::uint32_t index) { return (index == no_node) || (index < i); };
+        bool valid = false;
+        switch (node.type) {
+            case ast_node_types::value : { valid = node.a < tree->m_constants.size(); break; }
+            case ast_node_types::variable : { valid = node.a < names.size(); break; }
+            case ast_node_types::array :
+            case ast_node_types::main :
+            case ast_node_types::block : { valid = check_list(node.c, child); break; }
+            case ast_node_types::constructor :
+            case ast_node_types::func_call : { valid = (node.a < names.size()) && check_list(node.c, child); break; }
+            case ast_node_types::unary_not :
+            case ast_node_types::unary_minus :
+            case ast_node_types::return_node :
+            case ast_node_types::exit_node : { valid = child(node.a); break; }
+            case ast_node_types::prefix :
+            case ast_node_types::postfix : { valid = child(node.a) && (node.b <= 1); break; }
+            case ast_node_types::binary_arith :
+            case ast_node_types::comparison :
+            case ast_node_types::logic :
+            case ast_node_types::assignment :
+            case ast_node_types::subscript :
+            case ast_node_types::while_statement : { valid = child(node.a) && child(node.b); break; }
+            case ast_node_types::member_access : { valid = child(node.a) && (node.b < members.size()); break; }
+            case ast_node_types::member_func : { valid = child(node.a) && (node.b < members.size()) && check_list(node.c, child); break; }
+            case ast_node_types::func_decl : { valid = (node.a < functions.size()) && child(functions[node.a].body); break; }
+            case ast_node_types::declaration : { valid = (node.a < names.size()) && optional(node.b); break; }
+            case ast_node_types::print :
+            case ast_node_types::format : {
+                valid = (node.a < rules.size()) && check_list(node.c, child)
+                     && (tree->m_formats[node.a].get_argument_count() == tree->m_lists[node.c]);
+                break;
+            }
+            case ast_node_types::if_statement : {
+                valid = optional(node.a) && check_list(node.c, child) && (tree->m_lists[node.c] >= 2) && (tree->m_lists[node.c] % 2 == 0);
+                break;
+            }
+            case ast_node_types::for_statement : {
+                valid = check_list(node.c, optional) && (tree->m_lists[node.c] == 4) && (tree->list(node.c)[3] != no_node);
+                break;
+            }
+            case ast_node_types::break_node :
+            case ast_node_types::continue_node : { valid = true; break; }
+            default : { valid = false; break; }
+        }
+        if (!valid) { throw RuntimeError{ "invalid program file : corrupt node " + std::to_string(i) }; }
+        tree->m_nodes.push_back(node);
+    }
+    if ((header.node_count == 0) || (header.root != header.node_count - 1) || (tree->m_nodes.back().type != ast_node_types::main)) {
+        throw RuntimeError{ "invalid program file : missing main node" };
+    }
+    tree->m_root = header.root;
+    tree->m_source = std::move(data);
+    return tree;
+}
+
+object::Object FlatTree::execute (script::EnvStack& env) const {
+    if (m_root == no_node) { return object::Object {}; }
+    return evaluate(m_root, env);
+}
+
+} /* namespace ast */
+} /* namespace mlang */
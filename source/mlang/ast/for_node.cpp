@@ -11,6 +11,7 @@ object::Object ForStatementNode::execute (script::EnvStack& env) const {
     /* assignments */
     if (m_initialization) { m_initialization->execute(env); }
     while (true) {
+        env.step();
         env.enter_scope();
         /* check tests */
         object::Object test_val = m_test->execute(env);
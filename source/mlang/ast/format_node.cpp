@@ -0,0 +1,43 @@
+#include "mlang/ast/format_node.hpp"
+#include "mlang/object/string.hpp"
+
+namespace mlang {
+namespace ast {
+
+FormatNode::FormatNode() : Node(ast_node_types::format) {}
+
+object::Object FormatNode::execute (script::EnvStack& env) const {
+    std::vector<object::Object> args;
+    args.reserve(m_args.size());
+    for (const node_ptr& arg : m_args) {
+        args.push_back(arg->execute(env));
+    }
+    /* one buffer sized up front instead of a new String for every '+' */
+    return object::Object { std::make_shared<object::String>(m_format.format(args)) };
+}
+
+void FormatNode::set_rule (std::string_view rule) {
+    m_rule = rule;
+    m_format = object::Format { m_rule };
+}
+
+void FormatNode::set_format (std::string_view rule, object::Format format) {
+    m_rule = rule;
+    m_format = std::move(format);
+}
+
+void FormatNode::add_argument (node_ptr arg) { m_args.push_back(std::move(arg)); }
+
+bool FormatNode::is_valid () const { return m_format.get_argument_count() == m_args.size(); }
+
+void FormatNode::print () const {
+    std::cout << "format(" << m_rule;
+    for (const node_ptr& arg : m_args) {
+        std::cout << ", ";
+        arg->print();
+    }
+    std::cout << ")";
+}
+
+} /* namespace ast */
+} /* namespace mlang */
@@ -4,7 +4,7 @@
 namespace mlang {
 namespace ast {
     
-FunctionCallNode::FunctionCallNode(const std::string& name) : Node(ast_node_types::func_call), m_name(name) {}
+FunctionCallNode::FunctionCallNode(std::string_view name) : Node(ast_node_types::func_call), m_name(name) {}
 
 const std::vector<node_ptr>& FunctionCallNode::get_params () const { return m_params; }
 
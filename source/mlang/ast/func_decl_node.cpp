@@ -4,11 +4,32 @@
 namespace mlang {
 namespace ast {
 
-FunctionDeclNode::FunctionDeclNode (const std::string& name) : Node(ast_node_types::func_decl), m_name(name) {}
+FunctionDeclNode::FunctionDeclNode (std::string_view name) : Node(ast_node_types::func_decl), m_name(name) {}
 
-void FunctionDeclNode::set_body (node_ptr body) { m_body = std::move(body); }
+void FunctionDeclNode::set_body (node_ptr body) {
+    m_body = std::move(body);
+    m_compiled.store(m_body.get(), std::memory_order_release);
+}
+
+void FunctionDeclNode::set_body (body_compiler compile) { m_compile = std::move(compile); }
+
+bool FunctionDeclNode::is_compiled () const { return m_compiled.load(std::memory_order_acquire) != nullptr; }
+
+const Node& FunctionDeclNode::get_body () const {
+    const Node* body = m_compiled.load(std::memory_order_acquire);
+    if (body != nullptr) { return *body; }
+    std::lock_guard<std::mutex> lock { m_compile_mutex };
+    if (!m_body) {
+        /* a failed compilation leaves the function uncompiled, the next call reports the error again */
+        m_body = m_compile();
+        /* the compiler holds the tokens, they are not needed anymore */
+        m_compile = nullptr;
+    }
+    m_compiled.store(m_body.get(), std::memory_order_release);
+    return *m_body;
+}
 
-void FunctionDeclNode::add_parameter (const std::string& param) { m_params.push_back(param); }
+void FunctionDeclNode::add_parameter (std::string_view param) { m_params.push_back(param); }
 
 object::Object FunctionDeclNode::execute (script::EnvStack& env) const {
     env.declare_function(m_name, this);
@@ -20,26 +41,28 @@ object::Object FunctionDeclNode::call (script::EnvStack& env, std::vector<object
     /* check if the parameters have the same length, none of them are nullptr and have the same type */
     /* same with the return value */
     if (params.size() != m_params.size()) {
-        throw RuntimeError{ "function " + m_name + " expects " + std::to_string(m_params.size()) + " parameters but got " + std::to_string(params.size()) };
+        throw RuntimeError{ "function " + std::string { m_name } + " expects " + std::to_string(m_params.size()) + " parameters but got " + std::to_string(params.size()) };
     }
+    const Node& body = get_body();
+    env.step();
     env.enter_scope();
     for (std::size_t i = 0; i < params.size(); ++i) {
         env.declare_variable(m_params[i], params[i].get_typename());
         env.get_variable(m_params[i]).assign(params[i]);
     }
     try {
-        m_body->execute(env);
+        body.execute(env);
     }
     catch (const Break& e) {
         /* handle break */
         /* should not have gotten a break exception */
         env.exit_scope();
-        throw RuntimeError{ "invalid 'break' in function " + m_name };
+        throw RuntimeError{ "invalid 'break' in function " + std::string { m_name } };
     }
     catch (const Continue& e) {
         /* should not have gotten a continue exception */
         env.exit_scope();
-        throw RuntimeError{ "invalid 'continue' in function " + m_name };
+        throw RuntimeError{ "invalid 'continue' in function " + std::string { m_name } };
     }
     catch (const Return& e) {
         /* handle  return */
@@ -58,7 +81,7 @@ void FunctionDeclNode::print () const {
         if (i < m_params.size() - 1) { std::cout << ", "; }
     }
     std::cout << " )" << std::endl;
-    m_body->print();
+    get_body().print();
 }
 
 } /* namespace ast */
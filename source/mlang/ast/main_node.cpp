@@ -19,6 +19,8 @@ void MainNode::add_node (node_ptr node) {
     m_nodes.push_back(std::move(node));
 }
 
+void MainNode::set_source (std::shared_ptr<const script::Source> source) { m_source = std::move(source); }
+
 void MainNode::print () const {
     for (auto& node : m_nodes) {
         node->print();
@@ -3,7 +3,7 @@
 namespace mlang {
 namespace ast {
 
-MemberAccessNode::MemberAccessNode(node_ptr lhs, const std::string& member_name) : Node(ast_node_types::member_access), m_lhs(std::move(lhs)), m_member_name(member_name) {}
+MemberAccessNode::MemberAccessNode(node_ptr lhs, std::string_view member_name) : Node(ast_node_types::member_access), m_lhs(std::move(lhs)), m_member_name(member_name) {}
 
 object::Object MemberAccessNode::execute (script::EnvStack& env) const {
     object::Object lhs = m_lhs->execute(env);
@@ -3,7 +3,7 @@
 namespace mlang {
 namespace ast {
 
-MemberFunctionNode::MemberFunctionNode(node_ptr lhs, const std::string& func_name) : Node(ast_node_types::member_func), m_lhs(std::move(lhs)), m_func_name(func_name) {}
+MemberFunctionNode::MemberFunctionNode(node_ptr lhs, std::string_view func_name) : Node(ast_node_types::member_func), m_lhs(std::move(lhs)), m_func_name(func_name) {}
 
 const std::vector<node_ptr>& MemberFunctionNode::get_params () const { return m_params; }
 
@@ -3,92 +3,38 @@
 namespace mlang {
 namespace ast {
 
-std::string PrintNode::get_integer (script::EnvStack& env) const {
-    if (m_index >= m_args.size()) { throw SyntaxError{"mismatch in print arguments"}; }
-    object::Object res = m_args[m_index]->execute(env);
-    ++m_index;
-    return std::to_string(res.get_int());
-}
-
-std::string PrintNode::get_string (script::EnvStack& env) const {
-    if (m_index >= m_args.size()) { throw SyntaxError{"mismatch in print arguments"}; }
-    object::Object res = m_args[m_index]->execute(env);
-    ++m_index;
-    return res.get_string();
-}
-
-std::string PrintNode::get_float (script::EnvStack& env) const {
-    if (m_index >= m_args.size()) { throw SyntaxError{"mismatch in print arguments"}; }
-    object::Object res = m_args[m_index]->execute(env);
-    ++m_index;
-    return std::to_string(res.get_float());
-}
-
-std::string PrintNode::get_bool (script::EnvStack& env) const {
-    if (m_index >= m_args.size()) { throw SyntaxError{"mismatch in print arguments"}; }
-    object::Object res = m_args[m_index]->execute(env);
-    ++m_index;
-    return (res.is_true() ? "true" : "false");
-}
-
 PrintNode::PrintNode() : Node(ast_node_types::print) {}
 
 object::Object PrintNode::execute (script::EnvStack& env) const {
-    m_index = 0;
-    std::string result;
-    for  (std::size_t i = 0; i < m_rule.length(); ++i) {
-        if (i == m_rule.length() - 1) {
-            result.push_back(m_rule[i]);
-            break;
-        }
-        if (m_rule[i] == '%') {
-            switch (m_rule[i + 1]) {
-                case 'd' : {
-                    result += get_integer(env);
-                    ++i;
-                    break;
-                }
-                case 'f' : {
-                    result += get_float(env);
-                    ++i;
-                    break;
-                }
-                case 'b' : {
-                    result += get_bool(env);
-                    ++i;
-                    break;
-                }
-                case 's' : {
-                    result += get_string(env);
-                    ++i;
-                    break;
-                }
-                case '%' : {
-                    result.push_back(m_rule[i]);
-                    ++i;
-                    break;
-                }
-                default : {
-                    result.push_back(m_rule[i]);
-                    break;
-                }
-            }
-        }
-        else {
-            result.push_back(m_rule[i]);
-        }
+    /* arguments are evaluated into locals, the node itself is never modified -> it can be shared between threads */
+    std::vector<object::Object> args;
+    args.reserve(m_args.size());
+    for (const node_ptr& arg : m_args) {
+        args.push_back(arg->execute(env));
     }
-    std::cout << result;
-    std::cout << std::flush;
+    script::Output& output = env.get_output();
+    /* a print whose arguments fail to convert prints nothing, write leaves the buffer as it was */
+    m_format.write(output.buffer(), args);
+    output.commit();
     return object::Object {};
 }
 
-void PrintNode::set_rule (const std::string& rule) { m_rule = rule; }
+void PrintNode::set_rule (std::string_view rule) {
+    m_rule = rule;
+    m_format = object::Format { m_rule };
+}
+
+void PrintNode::set_format (std::string_view rule, object::Format format) {
+    m_rule = rule;
+    m_format = std::move(format);
+}
 
 void PrintNode::add_argument (node_ptr arg) { m_args.push_back(std::move(arg)); }
 
+bool PrintNode::is_valid () const { return m_format.get_argument_count() == m_args.size(); }
+
 void PrintNode::print () const {
-    std::cout << "print(" + m_rule;
+    std::cout << "print(" << m_rule;
     for (const node_ptr& arg : m_args) {
         std::cout << ", ";
         arg->print();
@@ -97,4 +43,4 @@ void PrintNode::print () const {
 }
 
 } /* namespace ast */
-} /* namespace mlang */
\ No newline at end of file
+} /* namespace mlang */
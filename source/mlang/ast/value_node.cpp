@@ -8,7 +8,8 @@ ValueNode::ValueNode(object::Object value) : Node(ast_node_types::value), m_valu
 const object::Object& ValueNode::get_value () const { return m_value; }
 
 object::Object ValueNode::execute (script::EnvStack& env) const {
-    return m_value;
+    /* the literal belongs to the shared program, an execution that modifies the result must not change it */
+    return m_value.copy();
 }
 
 void ValueNode::print () const { std::cout << m_value.get_string(); }
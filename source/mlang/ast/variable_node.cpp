@@ -3,9 +3,9 @@
 namespace mlang {
 namespace ast {
 
-VariableNode::VariableNode(const std::string& var_name) : Node(ast_node_types::variable), m_var_name(var_name) {}
+VariableNode::VariableNode(std::string_view var_name) : Node(ast_node_types::variable), m_var_name(var_name) {}
 
-const std::string& VariableNode::get_var_name () const { return m_var_name; }
+std::string_view VariableNode::get_var_name () const { return m_var_name; }
 
 object::Object VariableNode::execute (script::EnvStack& env) const {
     return env.get_variable(m_var_name);
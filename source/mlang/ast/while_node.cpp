@@ -8,9 +8,13 @@ WhileStatementNode::WhileStatementNode() : Node(ast_node_types::while_statement)
 
 object::Object WhileStatementNode::execute (script::EnvStack& env) const {
     while (true) {
+        env.step();
         env.enter_scope();
         object::Object cond_val = m_condition->execute(env);
-        if (!cond_val.is_true()) { break; }
+        if (!cond_val.is_true()) {
+            env.exit_scope();
+            break;
+        }
         try {
             /* execute scope */
             m_body->execute(env);
@@ -1,15 +1,20 @@
 #include "mlang/object/object.hpp"
 #include "mlang/object/array.hpp"
 #include "mlang/object/boolean.hpp"
+#include "mlang/object/string.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
 
 Array::Array (const std::vector<Object>& arr) : m_arr(arr) {}
+Array::Array (std::vector<Object>&& arr) : m_arr(std::move(arr)) {}
 
 std::string Array::get_typename () const { return type_name; }
 
+const std::vector<Object>& Array::get_elements () const { return m_arr; }
+
 const ObjectFactory& Array::get_factory () const {
     static ArrayFactory factory{};
     return factory;
@@ -105,10 +110,17 @@ void concatenate (const std::shared_ptr<InternalObject> param) {
 */
 
 
+std::shared_ptr<InternalObject> Array::to_json () {
+    return std::make_shared<String>(object::serialize<JsonSerializer>(*this));
+}
+
 std::shared_ptr<InternalObject> Array::call (const std::string& func, const std::vector<std::shared_ptr<InternalObject>>& params) {
     if (func.compare("reverse") == 0) {
         return reverse();
     }
+    else if (func.compare("to_json") == 0) {
+        return to_json();
+    }
     else {
         throw RuntimeError { "object of type '" + type_name + "' has no '" + func + "' member function" };
     }
@@ -120,15 +132,15 @@ std::shared_ptr<InternalObject> Array::access (const std::string& member) {
     return nullptr;
 }
 
-std::string Array::get_string () const {
-    std::string str = type_name;
-    str += " : { ";
-    for (const auto& elem : m_arr) {
-        str += elem.get_string();
-        str += " ";
+std::string Array::get_string () const { return object::serialize<DebugSerializer>(*this); }
+
+void Array::serialize (Serializer& serializer) const {
+    serializer.begin_array(m_arr.size());
+    for (std::size_t i = 0; i < m_arr.size(); ++i) {
+        serializer.next_element(i);
+        serializer.value(m_arr[i]);
     }
-    str += "}";
-    return str;
+    serializer.end_array(m_arr.size());
 }
 
 std::shared_ptr<InternalObject> ArrayFactory::create () const {
@@ -1,5 +1,6 @@
 #include "mlang/object/boolean.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
@@ -56,6 +57,7 @@ std::shared_ptr<InternalObject> Boolean::access (const std::string& member) {
 }
 
 std::string Boolean::get_string () const { return (m_value ? "true" : "false"); }
+void Boolean::serialize (Serializer& serializer) const { serializer.write_bool(m_value); }
 std::string Boolean::get_typename () const { return type_name; }
 int Boolean::get_int () const { return (m_value ? 1 : 0); }
 double Boolean::get_float () const { return (m_value ? 1.0 : 0.0); }
@@ -0,0 +1,108 @@
+#include "mlang/object/convert.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace mlang {
+namespace object {
+
+namespace {
+
+/* large enough for any int and for the shortest representation of any double */
+constexpr std::size_t number_buffer_size { 32 };
+constexpr int max_fixed_precision { 64 };
+
+bool is_space (char ch) {
+    return (ch == ' ') || (ch == '\t') || (ch == '\n') || (ch == '\r') || (ch == '\v') || (ch == '\f');
+}
+
+std::string_view trim (std::string_view str) {
+    while (!str.empty() && is_space(str.front())) { str.remove_prefix(1); }
+    while (!str.empty() && is_space(str.back())) { str.remove_suffix(1); }
+    return str;
+}
+
+bool has_prefix (std::string_view str, char lower) {
+    return (str.size() > 2) && (str[0] == '0') && ((str[1] == lower) || (str[1] == lower - ('a' - 'A')));
+}
+
+} /* namespace */
+
+void append_int (std::string& str, int value) {
+    char buffer[number_buffer_size];
+    const std::to_chars_result res = std::to_chars(buffer, buffer + number_buffer_size, value);
+    str.append(buffer, res.ptr);
+}
+
+void append_float (std::string& str, double value) {
+    char buffer[number_buffer_size];
+    const std::to_chars_result res = std::to_chars(buffer, buffer + number_buffer_size, value);
+    str.append(buffer, res.ptr);
+    /* keep floats distinguishable from ints -> 5.0 instead of 5 */
+    if (std::isfinite(value) && (std::string_view{buffer, static_cast<std::size_t>(res.ptr - buffer)}.find_first_of(".e") == std::string_view::npos)) {
+        str += ".0";
+    }
+}
+
+void append_float (std::string& str, double value, int precision) {
+    if (precision < 0) { precision = 0; }
+    if (precision > max_fixed_precision) { precision = max_fixed_precision; }
+    /* 309 integer digits is the worst case for a finite double in fixed notation */
+    char buffer[number_buffer_size + 309 + max_fixed_precision];
+    const std::to_chars_result res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, precision);
+    str.append(buffer, res.ptr);
+}
+
+std::string format_int (int value) {
+    std::string str;
+    append_int(str, value);
+    return str;
+}
+
+std::string format_float (double value) {
+    std::string str;
+    append_float(str, value);
+    return str;
+}
+
+bool parse_int (std::string_view str, int& value, int base) {
+    if ((base < 2) || (base > 36)) { return false; }
+    str = trim(str);
+    bool negative = false;
+    if (!str.empty() && ((str.front() == '+') || (str.front() == '-'))) {
+        negative = (str.front() == '-');
+        str.remove_prefix(1);
+    }
+    if ((base == 16) && has_prefix(str, 'x')) { str.remove_prefix(2); }
+    else if ((base == 2) && has_prefix(str, 'b')) { str.remove_prefix(2); }
+    if (str.empty() || (str.front() == '+') || (str.front() == '-')) { return false; }
+    /* parse the magnitude as unsigned so that INT_MIN is accepted */
+    unsigned int magnitude = 0;
+    const std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), magnitude, base);
+    if ((res.ec != std::errc{}) || (res.ptr != str.data() + str.size())) { return false; }
+    constexpr unsigned int int_max = static_cast<unsigned int>(std::numeric_limits<int>::max());
+    if (negative) {
+        if (magnitude > int_max + 1u) { return false; }
+        value = static_cast<int>(0u - magnitude);
+    }
+    else {
+        if (magnitude > int_max) { return false; }
+        value = static_cast<int>(magnitude);
+    }
+    return true;
+}
+
+bool parse_float (std::string_view str, double& value) {
+    str = trim(str);
+    if (!str.empty() && (str.front() == '+')) { str.remove_prefix(1); }
+    if (str.empty()) { return false; }
+    double result = 0.0;
+    const std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), result);
+    if ((res.ec != std::errc{}) || (res.ptr != str.data() + str.size())) { return false; }
+    value = result;
+    return true;
+}
+
+} /* namespace object */
+} /* namespace mlang */
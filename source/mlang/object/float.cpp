@@ -4,6 +4,8 @@
 #include "mlang/object/int.hpp"
 #include "mlang/object/string.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/convert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
@@ -120,7 +122,7 @@ void Float::increment () { ++m_value; }
 void Float::decrement () { --m_value; }
 
 std::shared_ptr<InternalObject> Float::to_string () {
-    return std::make_shared<String>(std::to_string(m_value));
+    return std::make_shared<String>(format_float(m_value));
 }
 
 std::shared_ptr<InternalObject> Float::to_int () {
@@ -151,7 +153,8 @@ std::shared_ptr<InternalObject> Float::access (const std::string& member) {
     throw RuntimeError { "object of type '" + type_name + "' has no '" + member + "' member" };
 }
 
-std::string Float::get_string () const { return std::to_string(m_value); }
+std::string Float::get_string () const { return format_float(m_value); }
+void Float::serialize (Serializer& serializer) const { serializer.write_float(m_value); }
 std::string Float::get_typename () const { return type_name; }
 int Float::get_int () const { return static_cast<int>(m_value); }
 double Float::get_float () const { return m_value; }
@@ -0,0 +1,175 @@
+#include "mlang/object/format.hpp"
+#include "mlang/object/convert.hpp"
+#include "mlang/object/serializer.hpp"
+
+#include <algorithm>
+
+namespace mlang {
+namespace object {
+
+namespace {
+
+/* rough size of one formatted argument without width */
+constexpr std::size_t argument_size_hint { 8 };
+constexpr int default_float_precision { 6 };
+
+bool is_digit (char ch) { return (ch >= '0') && (ch <= '9'); }
+
+/* pads the argument that was appended to 'out' from 'start' on */
+void pad (std::string& out, std::size_t start, const Format::Segment& segment) {
+    const std::size_t length = out.length() - start;
+    if (length >= segment.width) { return; }
+    const std::size_t fill = segment.width - length;
+    if (segment.left) {
+        out.append(fill, ' ');
+        return;
+    }
+    const bool numeric = (segment.type == Format::segment_types::integer) || (segment.type == Format::segment_types::floating);
+    if (segment.zero && numeric) {
+        /* zeros go between the sign and the digits */
+        const std::size_t digits = ((length != 0) && (out[start] == '-')) ? start + 1 : start;
+        out.insert(digits, fill, '0');
+        return;
+    }
+    out.insert(start, fill, ' ');
+}
+
+} /* namespace */
+
+Format::Format (std::string_view rule) {
+    for (std::size_t i = 0; i < rule.length(); ++i) {
+        /* a '%' at the very end has nothing to refer to, it is taken literally */
+        if ((rule[i] != '%') || (i == rule.length() - 1)) {
+            add_literal(rule[i]);
+            continue;
+        }
+        if (rule[i + 1] == '%') {
+            add_literal('%');
+            ++i;
+            continue;
+        }
+        const std::size_t end = parse_argument(rule, i + 1);
+        if (end == 0) {
+            add_literal('%');
+            continue;
+        }
+        i = end;
+    }
+}
+
+std::size_t Format::parse_argument (std::string_view rule, std::size_t pos) {
+    Segment segment {};
+    for (; pos < rule.length(); ++pos) {
+        if (rule[pos] == '-') { segment.left = true; }
+        else if (rule[pos] == '0') { segment.zero = true; }
+        else { break; }
+    }
+    for (; (pos < rule.length()) && is_digit(rule[pos]); ++pos) {
+        segment.width = segment.width * 10 + static_cast<std::size_t>(rule[pos] - '0');
+        if (segment.width > max_width) { return 0; }
+    }
+    if ((pos < rule.length()) && (rule[pos] == '.')) {
+        ++pos;
+        segment.precision = 0;
+        for (; (pos < rule.length()) && is_digit(rule[pos]); ++pos) {
+            segment.precision = segment.precision * 10 + (rule[pos] - '0');
+            if (segment.precision > static_cast<int>(max_width)) { return 0; }
+        }
+    }
+    if (pos >= rule.length()) { return 0; }
+    switch (rule[pos]) {
+        case 'd' : { segment.type = segment_types::integer; break; }
+        case 'f' : { segment.type = segment_types::floating; break; }
+        case 'b' : { segment.type = segment_types::boolean; break; }
+        case 's' : { segment.type = segment_types::string; break; }
+        default : { return 0; }
+    }
+    add_argument(segment);
+    return pos;
+}
+
+void Format::add_literal (char ch) {
+    /* consecutive literal characters are merged into one segment */
+    if (m_segments.empty() || (m_segments.back().type != segment_types::literal)) {
+        m_segments.push_back(Segment{ segment_types::literal, m_literals.length(), 0 });
+    }
+    m_literals.push_back(ch);
+    ++m_segments.back().length;
+    ++m_size_hint;
+}
+
+void Format::add_argument (const Segment& segment) {
+    m_segments.push_back(segment);
+    ++m_argument_count;
+    m_size_hint += std::max(segment.width, argument_size_hint);
+}
+
+std::size_t Format::get_argument_count () const { return m_argument_count; }
+
+const std::vector<Format::Segment>& Format::get_segments () const { return m_segments; }
+
+std::size_t Format::get_literal_length () const { return m_literals.length(); }
+
+std::size_t Format::get_size_hint () const { return m_size_hint; }
+
+void Format::write (std::string& out, const std::vector<Object>& args) const {
+    if (args.size() != m_argument_count) {
+        throw RuntimeError { "format expects " + format_int(static_cast<int>(m_argument_count)) + " arguments but got " + format_int(static_cast<int>(args.size())) };
+    }
+    /* an argument that fails to convert takes back what was already appended */
+    const std::size_t length = out.length();
+    try {
+        write_segments(out, args);
+    }
+    catch (...) {
+        out.resize(length);
+        throw;
+    }
+}
+
+void Format::write_segments (std::string& out, const std::vector<Object>& args) const {
+    std::size_t arg_index = 0;
+    for (const Segment& segment : m_segments) {
+        const std::size_t start = out.length();
+        switch (segment.type) {
+            case segment_types::literal : {
+                out.append(m_literals, segment.offset, segment.length);
+                continue;
+            }
+            case segment_types::integer : {
+                append_int(out, args[arg_index++].get_int());
+                break;
+            }
+            case segment_types::floating : {
+                append_float(out, args[arg_index++].get_float(), (segment.precision < 0) ? default_float_precision : segment.precision);
+                break;
+            }
+            case segment_types::boolean : {
+                out += (args[arg_index++].is_true() ? "true" : "false");
+                break;
+            }
+            case segment_types::string : {
+                if (segment.precision < 0) {
+                    /* written in place, no temporary string even for nested arrays */
+                    DebugSerializer serializer { out };
+                    serializer.value(args[arg_index++]);
+                    break;
+                }
+                const std::string str = args[arg_index++].get_string();
+                out.append(str, 0, std::min(str.length(), static_cast<std::size_t>(segment.precision)));
+                break;
+            }
+        }
+        pad(out, start, segment);
+    }
+}
+
+std::string Format::format (const std::vector<Object>& args) const {
+    std::string out;
+    out.reserve(m_size_hint);
+    write(out, args);
+    return out;
+}
+
+} /* namespace object */
+} /* namespace mlang */
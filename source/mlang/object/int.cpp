@@ -4,6 +4,8 @@
 #include "mlang/object/float.hpp"
 #include "mlang/object/string.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/convert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
@@ -120,7 +122,7 @@ void Int::increment () { ++m_value; }
 void Int::decrement () { --m_value; }
 
 std::shared_ptr<InternalObject> Int::to_string () {
-    return std::make_shared<String>(std::to_string(m_value));
+    return std::make_shared<String>(format_int(m_value));
 }
 
 std::shared_ptr<InternalObject> Int::to_int () {
@@ -151,7 +153,8 @@ std::shared_ptr<InternalObject> Int::access (const std::string& member) {
     throw RuntimeError { "object of type '" + type_name + "' has no '" + member + "' member" };
 }
 
-std::string Int::get_string () const { return std::to_string(m_value); }
+std::string Int::get_string () const { return format_int(m_value); }
+void Int::serialize (Serializer& serializer) const { serializer.write_int(m_value); }
 std::string Int::get_typename () const { return type_name; }
 int Int::get_int () const { return m_value; }
 double Int::get_float () const { return static_cast<double>(m_value); }
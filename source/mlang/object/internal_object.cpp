@@ -1,5 +1,6 @@
 #include "mlang/object/internal_object.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
@@ -17,6 +18,8 @@ std::string InternalObject::get_string () const {
     throw RuntimeError { "object of type '" + get_typename() + "' cannot be interpreted as string" };
 }
 
+void InternalObject::serialize (Serializer& serializer) const { serializer.write_opaque(*this); }
+
 /* += */
 void InternalObject::operator_add_equal (const std::shared_ptr<InternalObject> param) {
     throw RuntimeError { "object of type '" + get_typename() + "' has no '+=' operator" };
@@ -2,6 +2,7 @@
 
 #include "mlang/object/none.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
@@ -30,6 +31,7 @@ std::shared_ptr<InternalObject> None::access (const std::string& member) {
 }
 
 std::string None::get_string () const { return type_name; }
+void None::serialize (Serializer& serializer) const { serializer.write_none(); }
 std::string None::get_typename () const { return type_name; }
 
 std::shared_ptr<InternalObject> NoneFactory::create () const {
@@ -28,6 +28,14 @@ const ObjectFactory& Object::get_factory () const {
     return m_object->obj->get_factory();
 }
 
+bool Object::is_none () const {
+    return dynamic_cast<const None*>(m_object->obj.get()) != nullptr;
+}
+
+const internal_obj_ptr& Object::get_internal () const {
+    return m_object->obj;
+}
+
 Object Object::call (const std::string& func, const std::vector<Object>& params) {
     std::vector<std::shared_ptr<InternalObject>> internal_params;
     for (const Object& o : params) {
@@ -51,6 +59,11 @@ void Object::assign (const Object& param) {
     m_object->obj = param.get_factory().create();
     m_object->obj->assign(param.m_object->obj);
 }
+Object Object::copy () const {
+    Object ret { get_factory().create() };
+    ret.m_object->obj->assign(m_object->obj);
+    return ret;
+}
 void Object::destruct () {} /* reallocate to None */
 std::string Object::get_typename () const { return m_object->obj->get_typename(); }
 
@@ -61,6 +74,7 @@ bool Object::is_true () const { return m_object->obj->is_true(); }
 int Object::get_int () const { return m_object->obj->get_int(); }
 double Object::get_float () const { return m_object->obj->get_float(); }
 std::string Object::get_string () const { return m_object->obj->get_string(); }
+void Object::serialize (Serializer& serializer) const { m_object->obj->serialize(serializer); }
 
 /* += */
 Object& Object::operator_add_equal (const Object& rhs) {
@@ -182,14 +196,17 @@ bool operator==(const Object& lhs, const Object& rhs) {
 }
 Object Object::operator_comparison_equal (const Object& rhs) {
     Object ret { false };
-    ret.m_object->obj = m_object->obj->operator_comparison_equal(rhs.m_object->obj);
+    /* any value can be compared with none */
+    if (is_none() || rhs.is_none()) { ret.m_object->obj = std::make_shared<Boolean>(is_none() && rhs.is_none()); }
+    else { ret.m_object->obj = m_object->obj->operator_comparison_equal(rhs.m_object->obj); }
     return ret;
 }
 
 /* != */
 Object Object::operator_comparison_not_equal (const Object& rhs) {
     Object ret { false };
-    ret.m_object->obj = m_object->obj->operator_comparison_not_equal(rhs.m_object->obj);
+    if (is_none() || rhs.is_none()) { ret.m_object->obj = std::make_shared<Boolean>(!(is_none() && rhs.is_none())); }
+    else { ret.m_object->obj = m_object->obj->operator_comparison_not_equal(rhs.m_object->obj); }
     return ret;
 }
 
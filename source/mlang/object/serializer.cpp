@@ -0,0 +1,143 @@
+#include "mlang/object/serializer.hpp"
+#include "mlang/object/object.hpp"
+#include "mlang/object/none.hpp"
+#include "mlang/object/convert.hpp"
+
+#include <cmath>
+
+namespace mlang {
+namespace object {
+
+Serializer::Serializer () {}
+
+Serializer::Serializer (std::string& out) : m_out(&out) {}
+
+Serializer::Serializer (std::ostream& stream) : m_stream(&stream) {
+    m_chunk.reserve(stream_chunk_size);
+}
+
+Serializer::~Serializer () {
+    try {
+        flush();
+    }
+    catch (...) {
+        /* nowhere to report it anymore */
+    }
+}
+
+void Serializer::append (std::string_view data) {
+    m_size += data.size();
+    if (m_out != nullptr) {
+        m_out->append(data);
+    }
+    else if (m_stream != nullptr) {
+        m_chunk.append(data);
+        if (m_chunk.size() >= stream_chunk_size) { flush(); }
+    }
+}
+
+void Serializer::append (char ch) { append(std::string_view { &ch, 1 }); }
+
+void Serializer::append_int (int value) {
+    m_scratch.clear();
+    object::append_int(m_scratch, value);
+    append(m_scratch);
+}
+
+void Serializer::append_float (double value) {
+    m_scratch.clear();
+    object::append_float(m_scratch, value);
+    append(m_scratch);
+}
+
+void Serializer::value (const InternalObject& obj) { obj.serialize(*this); }
+
+void Serializer::value (const Object& obj) { obj.serialize(*this); }
+
+void Serializer::flush () {
+    if ((m_stream == nullptr) || m_chunk.empty()) { return; }
+    m_stream->write(m_chunk.data(), static_cast<std::streamsize>(m_chunk.size()));
+    m_chunk.clear();
+}
+
+std::size_t Serializer::get_size () const { return m_size; }
+
+void Serializer::write_opaque (const InternalObject& obj) { write_string(obj.get_string()); }
+
+
+
+
+void DebugSerializer::write_none () { append(None::type_name); }
+
+void DebugSerializer::write_bool (bool value) { append(value ? "true" : "false"); }
+
+void DebugSerializer::write_int (int value) { append_int(value); }
+
+void DebugSerializer::write_float (double value) { append_float(value); }
+
+void DebugSerializer::write_string (std::string_view value) { append(value); }
+
+void DebugSerializer::begin_array (std::size_t size) { append("Array : { "); }
+
+void DebugSerializer::next_element (std::size_t index) {
+    if (index != 0) { append(' '); }
+}
+
+void DebugSerializer::end_array (std::size_t size) { append((size == 0) ? "}" : " }"); }
+
+
+
+
+void JsonSerializer::write_none () { append("null"); }
+
+void JsonSerializer::write_bool (bool value) { append(value ? "true" : "false"); }
+
+void JsonSerializer::write_int (int value) { append_int(value); }
+
+void JsonSerializer::write_float (double value) {
+    if (!std::isfinite(value)) {
+        append("null");
+        return;
+    }
+    append_float(value);
+}
+
+void JsonSerializer::write_string (std::string_view value) {
+    static constexpr char hex_digits[] = "0123456789abcdef";
+    append('"');
+    /* unescaped runs are appended in one piece */
+    std::size_t run_start = 0;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const unsigned char ch = static_cast<unsigned char>(value[i]);
+        if ((ch >= 0x20) && (ch != '"') && (ch != '\\')) { continue; }
+        append(value.substr(run_start, i - run_start));
+        run_start = i + 1;
+        switch (ch) {
+            case '"' : { append("\\\""); break; }
+            case '\\' : { append("\\\\"); break; }
+            case '\n' : { append("\\n"); break; }
+            case '\r' : { append("\\r"); break; }
+            case '\t' : { append("\\t"); break; }
+            case '\b' : { append("\\b"); break; }
+            case '\f' : { append("\\f"); break; }
+            default : {
+                const char escaped[] = { '\\', 'u', '0', '0', hex_digits[ch >> 4], hex_digits[ch & 0x0F] };
+                append(std::string_view { escaped, sizeof(escaped) });
+                break;
+            }
+        }
+    }
+    append(value.substr(run_start));
+    append('"');
+}
+
+void JsonSerializer::begin_array (std::size_t size) { append('['); }
+
+void JsonSerializer::next_element (std::size_t index) {
+    if (index != 0) { append(','); }
+}
+
+void JsonSerializer::end_array (std::size_t size) { append(']'); }
+
+} /* namespace object */
+} /* namespace mlang */
@@ -2,15 +2,41 @@
 #include "mlang/object/int.hpp"
 #include "mlang/object/float.hpp"
 #include "mlang/object/assert.hpp"
+#include "mlang/object/convert.hpp"
+#include "mlang/object/format.hpp"
 
 #include <regex>
+#include <iterator>
+#include "mlang/object/serializer.hpp"
 
 namespace mlang {
 namespace object {
 
 String::String (const std::string& value) : m_value(value) {}
 
-const std::string& String::get () const { return m_value; }
+String::String (std::string&& value) : m_value(std::move(value)) {}
+
+String::String (std::string_view value, std::shared_ptr<const void> owner) : m_view(value), m_owner(std::move(owner)) {}
+
+void String::own () {
+    if (m_owner == nullptr) { return; }
+    if (!m_copied) { m_value.assign(m_view); }
+    m_copied = false;
+    m_view = std::string_view {};
+    m_owner.reset();
+}
+
+const std::string& String::get () const {
+    if ((m_owner != nullptr) && !m_copied) {
+        m_value.assign(m_view);
+        m_copied = true;
+    }
+    return m_value;
+}
+
+std::string_view String::view () const { return (m_owner != nullptr) ? m_view : std::string_view { m_value }; }
+
+bool String::is_view () const { return m_owner != nullptr; }
 
 const ObjectFactory& String::get_factory () const {
     static StringFactory factory{};
@@ -19,62 +45,93 @@ const ObjectFactory& String::get_factory () const {
 
 /* construct */
 void String::construct (const std::vector<std::shared_ptr<InternalObject>>& params) {
-    if (params.size() == 0) { m_value = ""; }
+    if (params.size() == 0) { m_owner.reset(); m_value = ""; }
     assert_params(params, 1, type_name, "constructor");
     assert_parameter(params[0], type_name, "constructor");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(params[0], type_name);
-    m_value = str_ptr->get();
+    assign(str_ptr);
 }
 
 /* assign */
 void String::assign (const std::shared_ptr<InternalObject> param) {
     const std::shared_ptr<String> str_ptr = assert_cast<String>(param, type_name);
-    m_value = str_ptr->get();
+    if (str_ptr.get() == this) { return; }
+    /* a view is shared, not copied */
+    if (str_ptr->m_owner != nullptr) {
+        m_value.clear();
+        m_copied = false;
+        m_view = str_ptr->m_view;
+        m_owner = str_ptr->m_owner;
+        return;
+    }
+    m_owner.reset();
+    m_value = str_ptr->m_value;
 }
 
 std::shared_ptr<InternalObject> String::operator_binary_add (const std::shared_ptr<InternalObject> param) {
     assert_parameter(param, type_name, "+");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(param, type_name);
-    return std::make_shared<String>(m_value + str_ptr->get());
+    const std::string_view lhs = view();
+    const std::string_view rhs = str_ptr->view();
+    std::string result;
+    result.reserve(lhs.size() + rhs.size());
+    result.append(lhs);
+    result.append(rhs);
+    return std::make_shared<String>(std::move(result));
 }
 
 void String::operator_add_equal (const std::shared_ptr<InternalObject> param) {
     assert_parameter(param, type_name, "+=");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(param, type_name);
-    m_value += str_ptr->get();
+    const std::string_view rhs = str_ptr->view();
+    if (str_ptr.get() == this) {
+        /* the text may go away in own() */
+        const std::string copy { rhs };
+        own();
+        m_value.append(copy);
+        return;
+    }
+    own();
+    m_value.append(rhs);
 }
 
 std::shared_ptr<InternalObject> String::operator_comparison_equal (const std::shared_ptr<InternalObject> param) {
     assert_parameter(param, type_name, "==");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(param, type_name);
-    return std::make_shared<Boolean>(m_value == str_ptr->get());
+    return std::make_shared<Boolean>(view() == str_ptr->view());
 }
 
 std::shared_ptr<InternalObject> String::operator_comparison_not_equal (const std::shared_ptr<InternalObject> param) {
     assert_parameter(param, type_name, "!=");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(param, type_name);
-    return std::make_shared<Boolean>(m_value != str_ptr->get());
+    return std::make_shared<Boolean>(view() != str_ptr->view());
+}
+
+/* a part of a viewed text is a view of the same owner */
+std::shared_ptr<String> String::substring_of (std::string_view part) const {
+    if (m_owner != nullptr) { return std::make_shared<String>(part, m_owner); }
+    return std::make_shared<String>(std::string { part });
 }
 
 std::shared_ptr<InternalObject> String::reverse () {
-    std::string reversed = m_value;
+    std::string reversed { view() };
     std::reverse(reversed.begin(), reversed.end());
     return std::make_shared<String>(reversed);
 }
 
 std::shared_ptr<InternalObject> String::length () {
-    return std::make_shared<Int>(m_value.length());
+    return std::make_shared<Int>(view().length());
 }
 
 std::shared_ptr<InternalObject> String::is_empty () {
-    return std::make_shared<Boolean>(m_value.empty());
+    return std::make_shared<Boolean>(view().empty());
 }
 
 std::shared_ptr<InternalObject> String::contains (const std::vector<std::shared_ptr<InternalObject>>& params) {
     assert_params(params, 1, type_name, "contains");
     assert_parameter(params[0], type_name, "contains");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(params[0], type_name);
-    if (m_value.find(str_ptr->get_string()) != std::string::npos) {
+    if (view().find(str_ptr->view()) != std::string_view::npos) {
         return std::make_shared<Boolean>(true);
     }
     return std::make_shared<Boolean>(false);
@@ -85,7 +142,8 @@ std::shared_ptr<InternalObject> String::contains_regex (const std::vector<std::s
     assert_parameter(params[0], type_name, "contains_regex");
     const std::shared_ptr<String> str_ptr = assert_cast<String>(params[0], type_name);
     std::regex m_regex (str_ptr->get_string());
-    if (std::regex_search(m_value, m_regex)) {
+    const std::string_view text = view();
+    if (std::regex_search(text.data(), text.data() + text.size(), m_regex)) {
         return std::make_shared<Boolean>(true);
     }
     return std::make_shared<Boolean>(false);
@@ -98,7 +156,10 @@ std::shared_ptr<InternalObject> String::regex_replace (const std::vector<std::sh
     const std::shared_ptr<String> param_regex = assert_cast<String>(params[0], type_name);
     const std::shared_ptr<String> param_replace = assert_cast<String>(params[1], type_name);
     std::regex m_regex (param_regex->get_string());
-    return std::make_shared<String>(std::regex_replace(m_value, m_regex, param_replace->get_string()));
+    const std::string_view text = view();
+    std::string result;
+    std::regex_replace(std::back_inserter(result), text.data(), text.data() + text.size(), m_regex, param_replace->get_string());
+    return std::make_shared<String>(std::move(result));
 }
 
 std::shared_ptr<InternalObject> String::regex_find (const std::vector<std::shared_ptr<InternalObject>>& params) {
@@ -109,9 +170,9 @@ std::shared_ptr<InternalObject> String::regex_find (const std::vector<std::share
     const std::shared_ptr<String> param_format = assert_cast<String>(params[1], type_name);
     std::regex m_regex { param_regex->get_string() };
     std::string m_format { param_format->get_string() };
-    if (std::regex_search(m_value, m_regex)) {
-        std::sregex_iterator match_begin = std::sregex_iterator(m_value.begin(), m_value.end(), m_regex);
-        std::smatch first_match = *match_begin;
+    const std::string_view text = view();
+    std::cmatch first_match;
+    if (std::regex_search(text.data(), text.data() + text.size(), first_match, m_regex)) {
         std::string value = std::regex_replace (first_match.str(), m_regex, m_format, std::regex_constants::format_no_copy);
         return std::make_shared<String>(value);
     }
@@ -127,16 +188,17 @@ std::shared_ptr<InternalObject> String::get_line (const std::vector<std::shared_
     if (line_index < 0) {
         throw RuntimeError { "line index cannot be negative in function 'get_line'" };
     }
+    const std::string_view text = view();
     std::size_t m_line_index = 0;
     std::size_t m_start_pos = 0;
     while (true) {
-        std::size_t found = m_value.find(delimiter, m_start_pos);
-        if (found == std::string::npos) {
+        std::size_t found = text.find(delimiter, m_start_pos);
+        if (found == std::string_view::npos) {
             if (m_line_index != line_index) { return std::make_shared<String>(""); }
-            return std::make_shared<String>(m_value.substr(m_start_pos, m_value.length() - m_start_pos));
+            return substring_of(text.substr(m_start_pos));
         }
         if (m_line_index == line_index) {
-            return std::make_shared<String>(m_value.substr(m_start_pos, found - m_start_pos));
+            return substring_of(text.substr(m_start_pos, found - m_start_pos));
         }
         ++m_line_index;
         m_start_pos = found + delimiter.length();
@@ -144,17 +206,31 @@ std::shared_ptr<InternalObject> String::get_line (const std::vector<std::shared_
     return std::make_shared<String>("");
 }
 
-std::shared_ptr<InternalObject> String::to_int () {
-    int num;
-    try {
-        num = std::stoi(m_value);
+std::shared_ptr<InternalObject> String::to_int (const std::vector<std::shared_ptr<InternalObject>>& params) {
+    int base = 10;
+    if (params.size() != 0) {
+        assert_params(params, 1, type_name, "to_int");
+        assert_parameter(params[0], type_name, "to_int");
+        base = params[0]->get_int();
+        if ((base < 2) || (base > 36)) {
+            throw RuntimeError { "base must be between 2 and 36 in function 'to_int'" };
+        }
     }
-    catch (...) {
-        throw RuntimeError { "error while converting '" + m_value + "' to integer" };
+    int num = 0;
+    if (!parse_int(view(), num, base)) {
+        throw RuntimeError { "error while converting '" + std::string { view() } + "' to integer" };
     }
     return std::make_shared<Int>(num);
 }
 
+std::shared_ptr<InternalObject> String::to_float () {
+    double num = 0.0;
+    if (!parse_float(view(), num)) {
+        throw RuntimeError { "error while converting '" + std::string { view() } + "' to float" };
+    }
+    return std::make_shared<Float>(num);
+}
+
 std::shared_ptr<InternalObject> String::substring (const std::vector<std::shared_ptr<InternalObject>>& params) {
     assert_params(params, 2, type_name, "substring");
     assert_parameter(params[0], type_name, "substring");
@@ -164,16 +240,27 @@ std::shared_ptr<InternalObject> String::substring (const std::vector<std::shared
     if (start_index < 0) {
         throw RuntimeError { "start index cannot be negative in function 'substring'" };
     }
-    if (start_index >= m_value.length()) {
+    const std::string_view text = view();
+    if (start_index >= text.length()) {
         throw RuntimeError { "start index is out of range in function 'substring'" };
     }
     if (length <= 0) {
         throw RuntimeError { "length must be positive in function 'substring'" };
     }
-    if (start_index + length >= m_value.length()) {
+    if (start_index + length >= text.length()) {
         throw RuntimeError { "end of substring is out of range in function 'substring'" };
     }
-    return std::make_shared<String>(m_value.substr(start_index, length));
+    return substring_of(text.substr(start_index, length));
+}
+
+std::shared_ptr<InternalObject> String::format (const std::vector<std::shared_ptr<InternalObject>>& params) {
+    const Format rule { view() };
+    std::vector<Object> args;
+    args.reserve(params.size());
+    for (const std::shared_ptr<InternalObject>& param : params) {
+        args.emplace_back(param);
+    }
+    return std::make_shared<String>(rule.format(args));
 }
 
 
@@ -203,11 +290,17 @@ std::shared_ptr<InternalObject> String::call (const std::string& func, const std
         return get_line(params);
     }
     else if (func.compare("to_int") == 0) {
-        return to_int();
+        return to_int(params);
+    }
+    else if (func.compare("to_float") == 0) {
+        return to_float();
     }
     else if (func.compare("substring") == 0) {
         return substring(params);
     }
+    else if (func.compare("format") == 0) {
+        return format(params);
+    }
     else {
         throw RuntimeError { "object of type '" + type_name + "' has no '" + func + "' member function" };
     }
@@ -218,7 +311,8 @@ std::shared_ptr<InternalObject> String::access (const std::string& member) {
     throw RuntimeError { "object of type '" + type_name + "' has no '" + member + "' member" };
 }
 
-std::string String::get_string () const { return m_value; }
+std::string String::get_string () const { return std::string { view() }; }
+void String::serialize (Serializer& serializer) const { serializer.write_string(view()); }
 std::string String::get_typename () const { return type_name; }
 
 
@@ -0,0 +1,276 @@
+#include "mlang/parser/builder.hpp"
+
+#include "mlang/ast/main_node.hpp"
+#include "mlang/ast/block_node.hpp"
+#include "mlang/ast/declaration.hpp"
+#include "mlang/ast/array_node.hpp"
+#include "mlang/ast/value_node.hpp"
+#include "mlang/ast/variable_node.hpp"
+#include "mlang/ast/subscript_node.hpp"
+#include "mlang/ast/unary_operations.hpp"
+#include "mlang/ast/print_node.hpp"
+#include "mlang/ast/format_node.hpp"
+#include "mlang/ast/func_decl_node.hpp"
+#include "mlang/ast/func_call_node.hpp"
+#include "mlang/ast/member_access.hpp"
+#include "mlang/ast/member_function.hpp"
+#include "mlang/ast/if_node.hpp"
+#include "mlang/ast/for_node.hpp"
+#include "mlang/ast/while_node.hpp"
+#include "mlang/ast/break_node.hpp"
+#include "mlang/ast/continue_node.hpp"
+#include "mlang/ast/return_node.hpp"
+#include "mlang/ast/exit_node.hpp"
+#include "mlang/ast/constructor_node.hpp"
+
+namespace mlang {
+namespace parser {
+
+/* TreeBuilder */
+
+TreeBuilder::ref TreeBuilder::value (object::Object value) { return std::make_unique<ast::ValueNode>(std::move(value)); }
+
+TreeBuilder::ref TreeBuilder::variable (std::string_view name) { return std::make_unique<ast::VariableNode>(name); }
+
+TreeBuilder::ref TreeBuilder::func_call (std::string_view name, list&& params) {
+    std::unique_ptr<ast::FunctionCallNode> node = std::make_unique<ast::FunctionCallNode>(name);
+    for (ref& param : params) { node->add_parameter(std::move(param)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::constructor (std::string_view type_name, list&& args) {
+    std::unique_ptr<ast::ConstructorNode> node = std::make_unique<ast::ConstructorNode>(type_name);
+    for (ref& arg : args) { node->add_argument(std::move(arg)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::array (list&& elements) {
+    std::unique_ptr<ast::ArrayNode> node = std::make_unique<ast::ArrayNode>();
+    for (ref& element : elements) { node->add_element(std::move(element)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::unary_not (ref rhs) { return std::make_unique<ast::UnaryNotOperationNode>(std::move(rhs)); }
+
+TreeBuilder::ref TreeBuilder::unary_minus (ref rhs) { return std::make_unique<ast::UnaryMinusOperationNode>(std::move(rhs)); }
+
+TreeBuilder::ref TreeBuilder::prefix (ref exp, bool decrement) {
+    if (decrement) { return std::make_unique<ast::PrefixDecrementNode>(std::move(exp)); }
+    return std::make_unique<ast::PrefixIncrementNode>(std::move(exp));
+}
+
+TreeBuilder::ref TreeBuilder::postfix (ref exp, bool decrement) {
+    if (decrement) { return std::make_unique<ast::PostfixDecrementNode>(std::move(exp)); }
+    return std::make_unique<ast::PostfixIncrementNode>(std::move(exp));
+}
+
+TreeBuilder::ref TreeBuilder::subscript (ref lhs, ref index) {
+    std::unique_ptr<ast::SubscriptNode> node = std::make_unique<ast::SubscriptNode>(std::move(lhs));
+    node->set_index(std::move(index));
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::member_access (ref lhs, std::string_view member) { return std::make_unique<ast::MemberAccessNode>(std::move(lhs), member); }
+
+TreeBuilder::ref TreeBuilder::member_call (ref lhs, std::string_view member, list&& params) {
+    std::unique_ptr<ast::MemberFunctionNode> node = std::make_unique<ast::MemberFunctionNode>(std::move(lhs), member);
+    for (ref& param : params) { node->add_parameter(std::move(param)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::arithmetic (ref lhs, ref rhs, ast::arithmetic_mode mode) { return std::make_unique<ast::BinaryArithmeticNode>(std::move(lhs), std::move(rhs), mode); }
+
+TreeBuilder::ref TreeBuilder::comparison (ref lhs, ref rhs, ast::comparison_mode mode) { return std::make_unique<ast::BinaryComparisonNode>(std::move(lhs), std::move(rhs), mode); }
+
+TreeBuilder::ref TreeBuilder::logic (ref lhs, ref rhs, ast::logic_mode mode) { return std::make_unique<ast::BinaryLogicNode>(std::move(lhs), std::move(rhs), mode); }
+
+TreeBuilder::ref TreeBuilder::assignment (ref lhs, ref rhs, ast::assignment_mode mode) { return std::make_unique<ast::AssignmentNode>(std::move(lhs), std::move(rhs), mode); }
+
+TreeBuilder::ref TreeBuilder::format (std::string_view rule, object::Format&& format, list&& args) {
+    std::unique_ptr<ast::FormatNode> node = std::make_unique<ast::FormatNode>();
+    node->set_format(rule, std::move(format));
+    for (ref& arg : args) { node->add_argument(std::move(arg)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::print (std::string_view rule, object::Format&& format, list&& args) {
+    std::unique_ptr<ast::PrintNode> node = std::make_unique<ast::PrintNode>();
+    node->set_format(rule, std::move(format));
+    for (ref& arg : args) { node->add_argument(std::move(arg)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::break_statement () { return std::make_unique<ast::BreakNode>(); }
+
+TreeBuilder::ref TreeBuilder::continue_statement () { return std::make_unique<ast::ContinueNode>(); }
+
+TreeBuilder::ref TreeBuilder::return_statement (ref value) { return std::make_unique<ast::ReturnNode>(std::move(value)); }
+
+TreeBuilder::ref TreeBuilder::exit_statement (ref value) { return std::make_unique<ast::ExitNode>(std::move(value)); }
+
+TreeBuilder::ref TreeBuilder::while_statement (ref condition, ref body) {
+    std::unique_ptr<ast::WhileStatementNode> node = std::make_unique<ast::WhileStatementNode>();
+    node->set_condition(std::move(condition));
+    node->set_body(std::move(body));
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::for_statement (ref initialization, ref test, ref update, ref body) {
+    std::unique_ptr<ast::ForStatementNode> node = std::make_unique<ast::ForStatementNode>();
+    if (initialization) { node->set_initialization(std::move(initialization)); }
+    if (test) { node->set_test(std::move(test)); }
+    if (update) { node->set_update(std::move(update)); }
+    node->set_body(std::move(body));
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::if_statement (list&& conditions, list&& bodies, ref else_body) {
+    std::unique_ptr<ast::IfStatementNode> node = std::make_unique<ast::IfStatementNode>();
+    node->set_if_condition(std::move(conditions[0]));
+    node->add_block(std::move(bodies[0]));
+    for (std::size_t i = 1; i < conditions.size(); ++i) {
+        node->add_elif_condition(std::move(conditions[i]));
+        node->add_block(std::move(bodies[i]));
+    }
+    if (else_body) {
+        node->add_else();
+        node->add_block(std::move(else_body));
+    }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::block (list&& statements) {
+    std::unique_ptr<ast::BlockNode> node = std::make_unique<ast::BlockNode>();
+    for (ref& statement : statements) { node->add_node(std::move(statement)); }
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::declaration (std::string_view name) { return std::make_unique<ast::DeclarationOperationNode>(name); }
+
+TreeBuilder::ref TreeBuilder::declaration (std::string_view name, ref value) { return std::make_unique<ast::DeclAndInitOperationNode>(name, std::move(value)); }
+
+TreeBuilder::ref TreeBuilder::func_decl (std::string_view name, std::vector<std::string_view>&& params, ref body) {
+    std::unique_ptr<ast::FunctionDeclNode> node = std::make_unique<ast::FunctionDeclNode>(name);
+    for (std::string_view param : params) { node->add_parameter(param); }
+    node->set_body(std::move(body));
+    return node;
+}
+
+TreeBuilder::ref TreeBuilder::func_decl (std::string_view name, std::vector<std::string_view>&& params, ast::FunctionDeclNode::body_compiler compile) {
+    std::unique_ptr<ast::FunctionDeclNode> node = std::make_unique<ast::FunctionDeclNode>(name);
+    for (std::string_view param : params) { node->add_parameter(param); }
+    node->set_body(std::move(compile));
+    return node;
+}
+
+TreeBuilder::result TreeBuilder::main (list&& statements, std::shared_ptr<const script::Source> source) {
+    std::unique_ptr<ast::MainNode> node = std::make_unique<ast::MainNode>();
+    node->set_source(std::move(source));
+    for (ref& statement : statements) { node->add_node(std::move(statement)); }
+    return node;
+}
+
+/* FlatBuilder */
+
+FlatBuilder::FlatBuilder () : m_tree(std::make_unique<ast::FlatTree>()) {}
+
+FlatBuilder::ref FlatBuilder::at (ref statement, std::size_t line) {
+    m_tree->set_line(statement, static_cast<std::uint32_t>(line));
+    return statement;
+}
+
+FlatBuilder::ref FlatBuilder::value (object::Object value) { return m_tree->add_node(ast::ast_node_types::value, m_tree->add_constant(std::move(value))); }
+
+FlatBuilder::ref FlatBuilder::variable (std::string_view name) { return m_tree->add_node(ast::ast_node_types::variable, m_tree->add_name(name)); }
+
+FlatBuilder::ref FlatBuilder::func_call (std::string_view name, list&& params) {
+    return m_tree->add_node(ast::ast_node_types::func_call, m_tree->add_name(name), 0, m_tree->add_list(params));
+}
+
+FlatBuilder::ref FlatBuilder::constructor (std::string_view type_name, list&& args) {
+    return m_tree->add_node(ast::ast_node_types::constructor, m_tree->add_name(type_name), 0, m_tree->add_list(args));
+}
+
+FlatBuilder::ref FlatBuilder::array (list&& elements) { return m_tree->add_node(ast::ast_node_types::array, 0, 0, m_tree->add_list(elements)); }
+
+FlatBuilder::ref FlatBuilder::unary_not (ref rhs) { return m_tree->add_node(ast::ast_node_types::unary_not, rhs); }
+
+FlatBuilder::ref FlatBuilder::unary_minus (ref rhs) { return m_tree->add_node(ast::ast_node_types::unary_minus, rhs); }
+
+FlatBuilder::ref FlatBuilder::prefix (ref exp, bool decrement) { return m_tree->add_node(ast::ast_node_types::prefix, exp, decrement ? 1 : 0); }
+
+FlatBuilder::ref FlatBuilder::postfix (ref exp, bool decrement) { return m_tree->add_node(ast::ast_node_types::postfix, exp, decrement ? 1 : 0); }
+
+FlatBuilder::ref FlatBuilder::subscript (ref lhs, ref index) { return m_tree->add_node(ast::ast_node_types::subscript, lhs, index); }
+
+FlatBuilder::ref FlatBuilder::member_access (ref lhs, std::string_view member) { return m_tree->add_node(ast::ast_node_types::member_access, lhs, m_tree->add_member(member)); }
+
+FlatBuilder::ref FlatBuilder::member_call (ref lhs, std::string_view member, list&& params) {
+    return m_tree->add_node(ast::ast_node_types::member_func, lhs, m_tree->add_member(member), m_tree->add_list(params));
+}
+
+FlatBuilder::ref FlatBuilder::arithmetic (ref lhs, ref rhs, ast::arithmetic_mode mode) { return m_tree->add_node(ast::ast_node_types::binary_arith, lhs, rhs, static_cast<std::uint32_t>(mode)); }
+
+FlatBuilder::ref FlatBuilder::comparison (ref lhs, ref rhs, ast::comparison_mode mode) { return m_tree->add_node(ast::ast_node_types::comparison, lhs, rhs, static_cast<std::uint32_t>(mode)); }
+
+FlatBuilder::ref FlatBuilder::logic (ref lhs, ref rhs, ast::logic_mode mode) { return m_tree->add_node(ast::ast_node_types::logic, lhs, rhs, static_cast<std::uint32_t>(mode)); }
+
+FlatBuilder::ref FlatBuilder::assignment (ref lhs, ref rhs, ast::assignment_mode mode) { return m_tree->add_node(ast::ast_node_types::assignment, lhs, rhs, static_cast<std::uint32_t>(mode)); }
+
+FlatBuilder::ref FlatBuilder::format (std::string_view rule, object::Format&& format, list&& args) {
+    return m_tree->add_node(ast::ast_node_types::format, m_tree->add_format(rule, std::move(format)), 0, m_tree->add_list(args));
+}
+
+FlatBuilder::ref FlatBuilder::print (std::string_view rule, object::Format&& format, list&& args) {
+    return m_tree->add_node(ast::ast_node_types::print, m_tree->add_format(rule, std::move(format)), 0, m_tree->add_list(args));
+}
+
+FlatBuilder::ref FlatBuilder::break_statement () { return m_tree->add_node(ast::ast_node_types::break_node); }
+
+FlatBuilder::ref FlatBuilder::continue_statement () { return m_tree->add_node(ast::ast_node_types::continue_node); }
+
+FlatBuilder::ref FlatBuilder::return_statement (ref value) { return m_tree->add_node(ast::ast_node_types::return_node, value); }
+
+FlatBuilder::ref FlatBuilder::exit_statement (ref value) { return m_tree->add_node(ast::ast_node_types::exit_node, value); }
+
+FlatBuilder::ref FlatBuilder::while_statement (ref condition, ref body) { return m_tree->add_node(ast::ast_node_types::while_statement, condition, body); }
+
+FlatBuilder::ref FlatBuilder::for_statement (ref initialization, ref test, ref update, ref body) {
+    const ref parts[] { initialization, test, update, body };
+    return m_tree->add_node(ast::ast_node_types::for_statement, 0, 0, m_tree->add_list(parts));
+}
+
+FlatBuilder::ref FlatBuilder::if_statement (list&& conditions, list&& bodies, ref else_body) {
+    list branches;
+    branches.reserve(conditions.size() * 2);
+    for (std::size_t i = 0; i < conditions.size(); ++i) {
+        branches.push_back(conditions[i]);
+        branches.push_back(bodies[i]);
+    }
+    return m_tree->add_node(ast::ast_node_types::if_statement, else_body, 0, m_tree->add_list(branches));
+}
+
+FlatBuilder::ref FlatBuilder::block (list&& statements) { return m_tree->add_node(ast::ast_node_types::block, 0, 0, m_tree->add_list(statements)); }
+
+FlatBuilder::ref FlatBuilder::declaration (std::string_view name) { return m_tree->add_node(ast::ast_node_types::declaration, m_tree->add_name(name), ast::no_node); }
+
+FlatBuilder::ref FlatBuilder::declaration (std::string_view name, ref value) { return m_tree->add_node(ast::ast_node_types::declaration, m_tree->add_name(name), value); }
+
+FlatBuilder::ref FlatBuilder::func_decl (std::string_view name, std::vector<std::string_view>&& params, ref body) {
+    list names;
+    names.reserve(params.size());
+    for (std::string_view param : params) { names.push_back(m_tree->add_name(param)); }
+    const std::uint32_t function = m_tree->add_function(m_tree->add_name(name), m_tree->add_list(names), body);
+    return m_tree->add_node(ast::ast_node_types::func_decl, function);
+}
+
+FlatBuilder::result FlatBuilder::main (list&& statements, std::shared_ptr<const script::Source> source) {
+    m_tree->set_root(m_tree->add_node(ast::ast_node_types::main, 0, 0, m_tree->add_list(statements)));
+    m_tree->set_source(std::move(source));
+    result tree = std::move(m_tree);
+    m_tree = std::make_unique<ast::FlatTree>();
+    return tree;
+}
+
+} /* namespace parser */
+} /* namespace mlang */
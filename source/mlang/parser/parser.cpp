@@ -3,33 +3,8 @@
 #include "mlang/parser/parser.hpp"
 #include "mlang/exception.hpp"
 
-#include "mlang/ast/main_node.hpp"
-#include "mlang/ast/block_node.hpp"
-#include "mlang/ast/declaration.hpp"
-#include "mlang/ast/array_node.hpp"
-#include "mlang/ast/assignment.hpp"
-#include "mlang/ast/value_node.hpp"
-#include "mlang/ast/variable_node.hpp"
-#include "mlang/ast/subscript_node.hpp"
-#include "mlang/ast/binary_operations.hpp"
-#include "mlang/ast/unary_operations.hpp"
-#include "mlang/ast/comparison.hpp"
-#include "mlang/ast/print_node.hpp"
-#include "mlang/ast/func_decl_node.hpp"
-#include "mlang/ast/func_call_node.hpp"
-#include "mlang/ast/member_access.hpp"
-#include "mlang/ast/member_function.hpp"
-#include "mlang/ast/if_node.hpp"
-#include "mlang/ast/logic_operations.hpp"
-#include "mlang/ast/for_node.hpp"
-#include "mlang/ast/while_node.hpp"
-#include "mlang/ast/break_node.hpp"
-#include "mlang/ast/continue_node.hpp"
-#include "mlang/ast/return_node.hpp"
-#include "mlang/ast/exit_node.hpp"
-#include "mlang/ast/constructor_node.hpp"
-
 #include "mlang/object/object.hpp"
+#include "mlang/object/format.hpp"
 #include "mlang/object/string.hpp"
 #include "mlang/object/int.hpp"
 #include "mlang/object/float.hpp"
@@ -39,32 +14,65 @@
 namespace mlang {
 namespace parser {
 
-void Parser::next(int num) { m_index = std::min(m_index + num, m_tokens.size()); }
-bool Parser::done() const { return m_index >= m_tokens.size(); }
-const script::Token* Parser::peek (int num) const {
-    if ((m_index + num >= 0) && (m_index + num < m_tokens.size())) {
-        return m_tokens[m_index + num];
-    }
-    return nullptr;
-}
-bool Parser::peekable (int num) {
-    if ((m_index + num) < 0) return false;
-    if ((m_index + num) >= m_tokens.size()) return false;
-    return true;
-}
-const script::Token* Parser::curr() const { return m_tokens[m_index]; }
-const script::Token* Parser::prev() const {
+template <typename Builder>
+void BasicParser<Builder>::stream (std::shared_ptr<script::Source> source, std::size_t line, std::size_t offset, std::size_t column) {
+    m_lexer = std::make_unique<script::Lexer>(*source, line, offset, column);
+    m_ring.resize(ring_size);
+    m_pulled = 0;
+    m_index = 0;
+    m_source = source;
+    m_stream_source = std::move(source);
+}
+
+template <typename Builder>
+const script::Token* BasicParser<Builder>::token (std::size_t index) {
+    if (m_tokens != nullptr) {
+        return (index < m_tokens->size()) ? &(*m_tokens)[index] : nullptr;
+    }
+    while (m_pulled <= index) {
+        Pulled& slot = m_ring[m_pulled % ring_size];
+        if (!m_lexer->next(slot.token, slot.offset)) { return nullptr; }
+        ++m_pulled;
+    }
+    return &m_ring[index % ring_size].token;
+}
+
+template <typename Builder>
+void BasicParser<Builder>::next(int num) {
+    for (int i = 0; (i < num) && (token(m_index) != nullptr); ++i) { ++m_index; }
+}
+template <typename Builder>
+bool BasicParser<Builder>::done() { return token(m_index) == nullptr; }
+template <typename Builder>
+const script::Token* BasicParser<Builder>::peek (int num) {
+    if ((num < 0) && (m_index < static_cast<std::size_t>(-num))) { return nullptr; }
+    return token(m_index + num);
+}
+template <typename Builder>
+bool BasicParser<Builder>::peekable (int num) { return peek(num) != nullptr; }
+template <typename Builder>
+const script::Token* BasicParser<Builder>::curr() { return token(m_index); }
+template <typename Builder>
+const script::Token* BasicParser<Builder>::prev() {
     if (m_index == 0) return nullptr;
-    return m_tokens[m_index - 1];
+    return token(m_index - 1);
 }
 
-void Parser::trace (const std::string& str) const {
+template <typename Builder>
+void BasicParser<Builder>::trace (const std::string& str) const {
     #if TRACE_PARSER == 1
     std::cout << str << std::endl;
     #endif
 }
 
-bool Parser::consume (script::token_types type) {
+template <typename Builder>
+std::shared_ptr<object::String> BasicParser<Builder>::string_literal (std::string_view value) const {
+    if (m_source != nullptr) { return std::make_shared<object::String>(value, m_source); }
+    return std::make_shared<object::String>(std::string { value });
+}
+
+template <typename Builder>
+bool BasicParser<Builder>::consume (script::token_types type) {
     if (done()) { return false; }
     if (curr()->type == type) {
         next();
@@ -73,7 +81,8 @@ bool Parser::consume (script::token_types type) {
     return false;
 }
 
-void Parser::consume (script::token_types type, const std::string& err_msg) {
+template <typename Builder>
+void BasicParser<Builder>::consume (script::token_types type, const std::string& err_msg) {
     if (done()) { throw SyntaxError{ err_msg, prev()->line, prev()->pos}; }
     if (curr()->type != type) {
         throw SyntaxError{ err_msg, curr()->line, curr()->pos};
@@ -83,59 +92,65 @@ void Parser::consume (script::token_types type, const std::string& err_msg) {
 
 // primary            -> INT | FLOAT | STRING | "true" | "false" | "none" | "(" expression ")" | func_call | IDENTIFIER | ( "new" IDENTIFIER "(" arguments? ")" ) | ( "{" arguments "}" )
 // func_call          -> IDENTIFIER "(" arguments? ")"
-ast::node_ptr Parser::primary () {
+// format_call        -> "format" "(" STRING ( "," logic_or )* ")"
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::primary () {
     trace("primary");
-    if (consume(script::token_types::integer)) { return std::make_unique<ast::ValueNode>(object::Object{std::make_shared<object::Int>(prev()->value_int)}); }
-    if (consume(script::token_types::floating)) { return std::make_unique<ast::ValueNode>(object::Object{std::make_shared<object::Float>(prev()->value_float)}); }
-    if (consume(script::token_types::string)) { return std::make_unique<ast::ValueNode>(object::Object{std::make_shared<object::String>(prev()->value_str)}); }
-    if (consume(script::token_types::kw_true)) { return std::make_unique<ast::ValueNode>(object::Object{std::make_shared<object::Boolean>(true)}); }
-    if (consume(script::token_types::kw_false)) { return std::make_unique<ast::ValueNode>(object::Object{std::make_shared<object::Boolean>(false)}); }
+    if (consume(script::token_types::integer)) { return m_builder.value(object::Object{std::make_shared<object::Int>(prev()->value_int)}); }
+    if (consume(script::token_types::floating)) { return m_builder.value(object::Object{std::make_shared<object::Float>(prev()->value_float)}); }
+    if (consume(script::token_types::string)) { return m_builder.value(object::Object{string_literal(prev()->value_str)}); }
+    if (consume(script::token_types::kw_true)) { return m_builder.value(object::Object{std::make_shared<object::Boolean>(true)}); }
+    if (consume(script::token_types::kw_false)) { return m_builder.value(object::Object{std::make_shared<object::Boolean>(false)}); }
+    if (consume(script::token_types::kw_none)) { return m_builder.value(object::Object{std::make_shared<object::None>()}); }
     if (consume(script::token_types::round_bracket_open)) {
-        ast::node_ptr expr = expression();
+        ref expr = expression();
         consume(script::token_types::round_bracket_close, "missing ')'");
         return expr;
     }
     if (consume(script::token_types::identifier)) {
-        std::string identifier_str = prev()->value_str;
+        std::string_view identifier_str = prev()->value_str;
         if (consume(script::token_types::round_bracket_open)) {
-            std::unique_ptr<ast::FunctionCallNode> func_call_ptr = std::make_unique<ast::FunctionCallNode>(identifier_str);
+            list params;
             while (!consume(script::token_types::round_bracket_close)) {
-                func_call_ptr->add_parameter(logic_or());
+                params.push_back(logic_or());
                 consume(script::token_types::comma);
             }
-            return func_call_ptr;
+            return m_builder.func_call(identifier_str, std::move(params));
         }
-        return std::make_unique<ast::VariableNode>(identifier_str);
+        return m_builder.variable(identifier_str);
+    }
+    if (consume(script::token_types::kw_format)) {
+        consume(script::token_types::round_bracket_open, "missing '(' in 'format' call");
+        return format_call();
     }
     if (consume(script::token_types::kw_new)) {
         consume(script::token_types::identifier, "missing identifier in 'new' expression");
-        std::string type_name = prev()->value_str;
+        std::string_view type_name = prev()->value_str;
         consume(script::token_types::round_bracket_open, "missing identifier '(' in 'new' expression");
-        std::unique_ptr<ast::ConstructorNode> constructor_ptr = std::make_unique<ast::ConstructorNode>(type_name);
+        list args;
         while (!consume(script::token_types::round_bracket_close)) {
-            constructor_ptr->add_argument(logic_or());
+            args.push_back(logic_or());
             if (consume(script::token_types::comma)) {
                 if (consume(script::token_types::curly_bracket_close)) {
                     throw SyntaxError{ "',' is followed by '}', which is invalid", prev()->line, prev()->pos};
                 }
             }
         }
-        return constructor_ptr;
+        return m_builder.constructor(type_name, std::move(args));
     }
     if (consume(script::token_types::curly_bracket_open)) {
-        std::unique_ptr<ast::ArrayNode> arr_ptr = std::make_unique<ast::ArrayNode>();
+        list elements;
         while (!consume(script::token_types::curly_bracket_close)) {
-            arr_ptr->add_element(logic_or());
+            elements.push_back(logic_or());
             if (consume(script::token_types::comma)) {
                 if (consume(script::token_types::curly_bracket_close)) {
                     throw SyntaxError{ "',' is followed by '}', which is invalid", prev()->line, prev()->pos};
                 }
             }
         }
-        return arr_ptr;
+        return m_builder.array(std::move(elements));
     }
     throw SyntaxError{ "unexpected primary token", curr()->line, curr()->pos};
-    return nullptr;
 }
 
 // post_op            -> postfix_increment | postfix_decrement | ( subscript | member_access | member_call )*
@@ -144,42 +159,41 @@ ast::node_ptr Parser::primary () {
 // subscript          -> primary "[" logic_or "]"
 // member_access      -> primary "." IDENTIFIER
 // member_call        -> primary "." IDENTIFIER "(" arguments? ")"
-ast::node_ptr Parser::post_op () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::post_op () {
     trace("post_op");
-    ast::node_ptr expr = primary();
+    ref expr = primary();
     while (true) {
         if (consume(script::token_types::plus_plus)) {
-            expr = std::make_unique<ast::PostfixIncrementNode>(std::move(expr));
+            expr = m_builder.postfix(std::move(expr), false);
             break;
         }
         else if (consume(script::token_types::dash_dash)) {
-            expr = std::make_unique<ast::PostfixDecrementNode>(std::move(expr));
+            expr = m_builder.postfix(std::move(expr), true);
             break;
         }
         else if (consume(script::token_types::square_bracket_open)) {
-            std::unique_ptr<ast::SubscriptNode> subscript_ptr = std::make_unique<ast::SubscriptNode>(std::move(expr));
-            subscript_ptr->set_index(logic_or());
+            ref index = logic_or();
             consume(script::token_types::square_bracket_close, "missing ']' as subscript termination");
-            expr = std::move(subscript_ptr);
+            expr = m_builder.subscript(std::move(expr), std::move(index));
         }
         else if (consume(script::token_types::dot)) {
             consume(script::token_types::identifier, "missing identifier in member access");
-            std::string member_name = prev()->value_str;
+            std::string_view member_name = prev()->value_str;
             if (consume(script::token_types::round_bracket_open)) {
-                std::unique_ptr<ast::MemberFunctionNode> member_func_ptr = std::make_unique<ast::MemberFunctionNode>(std::move(expr), member_name);
+                list params;
                 while (!consume(script::token_types::round_bracket_close)) {
-                    member_func_ptr->add_parameter(logic_or());
+                    params.push_back(logic_or());
                     if (consume(script::token_types::comma)) {
                         if (consume(script::token_types::round_bracket_close)) {
                             throw SyntaxError{ "',' is followed by ')', which is invalid", prev()->line, prev()->pos};
                         }
                     }
                 }
-                expr = std::move(member_func_ptr);
+                expr = m_builder.member_call(std::move(expr), member_name, std::move(params));
             }
             else {
-                std::unique_ptr<ast::MemberAccessNode> member_access_ptr = std::make_unique<ast::MemberAccessNode>(std::move(expr), member_name);
-                expr = std::move(member_access_ptr);
+                expr = m_builder.member_access(std::move(expr), member_name);
             }
         }
         else {
@@ -190,39 +204,41 @@ ast::node_ptr Parser::post_op () {
 }
 
 // pre_op             -> ( "-" | "!" | "++" | "--" )? post_op;
-ast::node_ptr Parser::pre_op () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::pre_op () {
     trace("pre_op");
     if (consume(script::token_types::dash)) {
-        ast::node_ptr rhs = post_op();
-        return std::make_unique<ast::UnaryMinusOperationNode>(std::move(rhs));
+        ref rhs = post_op();
+        return m_builder.unary_minus(std::move(rhs));
     }
     else if (consume(script::token_types::exclamation_mark)) {
-        ast::node_ptr rhs = post_op();
-        return std::make_unique<ast::UnaryNotOperationNode>(std::move(rhs));
+        ref rhs = post_op();
+        return m_builder.unary_not(std::move(rhs));
     }
     else if (consume(script::token_types::plus_plus)) {
-        ast::node_ptr rhs = post_op();
-        return std::make_unique<ast::PrefixIncrementNode>(std::move(rhs));
+        ref rhs = post_op();
+        return m_builder.prefix(std::move(rhs), false);
     }
     else if (consume(script::token_types::dash_dash)) {
-        ast::node_ptr rhs = post_op();
-        return std::make_unique<ast::PrefixDecrementNode>(std::move(rhs));
+        ref rhs = post_op();
+        return m_builder.prefix(std::move(rhs), true);
     }
     return post_op();
 }
 
 // factor             -> pre_op ( ( "/" | "*" ) pre_op )*
-ast::node_ptr Parser::factor () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::factor () {
     trace("factor");
-    ast::node_ptr expr = pre_op();
+    ref expr = pre_op();
     while (true) {
         if (consume(script::token_types::asterisk)) {
-            ast::node_ptr rhs = pre_op();
-            expr = std::make_unique<ast::BinaryArithmeticNode>(std::move(expr), std::move(rhs), ast::arithmetic_mode::mul);
+            ref rhs = pre_op();
+            expr = m_builder.arithmetic(std::move(expr), std::move(rhs), ast::arithmetic_mode::mul);
         }
         else if (consume(script::token_types::slash)) {
-            ast::node_ptr rhs = pre_op();
-            expr = std::make_unique<ast::BinaryArithmeticNode>(std::move(expr), std::move(rhs), ast::arithmetic_mode::div);
+            ref rhs = pre_op();
+            expr = m_builder.arithmetic(std::move(expr), std::move(rhs), ast::arithmetic_mode::div);
         }
         else {
             break;
@@ -232,17 +248,18 @@ ast::node_ptr Parser::factor () {
 }
 
 // term               -> factor ( ( "-" | "+" ) factor )*
-ast::node_ptr Parser::term () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::term () {
     trace("term");
-    ast::node_ptr expr = factor();
+    ref expr = factor();
     while (true) {
         if (consume(script::token_types::plus)) {
-            ast::node_ptr rhs = comparison();
-            expr = std::make_unique<ast::BinaryArithmeticNode>(std::move(expr), std::move(rhs), ast::arithmetic_mode::add);
+            ref rhs = comparison();
+            expr = m_builder.arithmetic(std::move(expr), std::move(rhs), ast::arithmetic_mode::add);
         }
         else if (consume(script::token_types::dash)) {
-            ast::node_ptr rhs = comparison();
-            expr = std::make_unique<ast::BinaryArithmeticNode>(std::move(expr), std::move(rhs), ast::arithmetic_mode::sub);
+            ref rhs = comparison();
+            expr = m_builder.arithmetic(std::move(expr), std::move(rhs), ast::arithmetic_mode::sub);
         }
         else {
             break;
@@ -252,25 +269,26 @@ ast::node_ptr Parser::term () {
 }
 
 // comparison         -> term ( ( ">" | ">=" | "<" | "<=" ) term )*
-ast::node_ptr Parser::comparison () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::comparison () {
     trace("comparison");
-    ast::node_ptr expr = term();
+    ref expr = term();
     while (true) {
         if (consume(script::token_types::greater)) {
-            ast::node_ptr rhs = term();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::greater);
+            ref rhs = term();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::greater);
         }
         else if (consume(script::token_types::less)) {
-            ast::node_ptr rhs = term();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::less);
+            ref rhs = term();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::less);
         }
         else if (consume(script::token_types::greater_equal)) {
-            ast::node_ptr rhs = term();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::greater_equal);
+            ref rhs = term();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::greater_equal);
         }
         else if (consume(script::token_types::less_equal)) {
-            ast::node_ptr rhs = term();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::less_equal);
+            ref rhs = term();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::less_equal);
         }
         else {
             break;
@@ -280,17 +298,18 @@ ast::node_ptr Parser::comparison () {
 }
 
 // equality           -> comparison ( ( "!=" | "==" ) comparison )*
-ast::node_ptr Parser::equality () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::equality () {
     trace("equality");
-    ast::node_ptr expr = comparison();
+    ref expr = comparison();
     while (true) {
         if (consume(script::token_types::exclamation_equal)) {
-            ast::node_ptr rhs = comparison();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::not_equal);
+            ref rhs = comparison();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::not_equal);
         }
         else if (consume(script::token_types::double_equal)) {
-            ast::node_ptr rhs = comparison();
-            expr = std::make_unique<ast::BinaryComparisonNode>(std::move(expr), std::move(rhs), ast::comparison_mode::equal);
+            ref rhs = comparison();
+            expr = m_builder.comparison(std::move(expr), std::move(rhs), ast::comparison_mode::equal);
         }
         else {
             break;
@@ -300,169 +319,208 @@ ast::node_ptr Parser::equality () {
 }
 
 // logic_and          -> equality ( "&&" equality )*
-ast::node_ptr Parser::logic_and () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::logic_and () {
     trace("logic_and");
-    ast::node_ptr expr = equality();
+    ref expr = equality();
     while (consume(script::token_types::double_ampersand)) {
-        ast::node_ptr rhs = equality();
-        expr = std::make_unique<ast::BinaryLogicNode>(std::move(expr), std::move(rhs), ast::logic_mode::logic_and);
+        ref rhs = equality();
+        expr = m_builder.logic(std::move(expr), std::move(rhs), ast::logic_mode::logic_and);
     }
     return expr;
 }
 
 // logic_or           -> logic_and ( "||" logic_and )*
-ast::node_ptr Parser::logic_or () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::logic_or () {
     trace("logic_or");
-    ast::node_ptr expr = logic_and();
+    ref expr = logic_and();
     while (consume(script::token_types::double_pipe)) {
-        ast::node_ptr rhs = logic_and();
-        expr = std::make_unique<ast::BinaryLogicNode>(std::move(expr), std::move(rhs), ast::logic_mode::logic_or);
+        ref rhs = logic_and();
+        expr = m_builder.logic(std::move(expr), std::move(rhs), ast::logic_mode::logic_or);
     }
     return expr;
 }
 
 // assignment         -> logic_or ( "=" | "+=" | "-=" | "*=" | "/=" logic_or )?
-ast::node_ptr Parser::assignment () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::assignment () {
     trace("assignment");
-    ast::node_ptr expr = logic_or();
+    ref expr = logic_or();
     if (consume(script::token_types::equal_sign)) {
-        ast::node_ptr rhs = logic_or();
-        return std::make_unique<ast::AssignmentNode>(std::move(expr), std::move(rhs), ast::assignment_mode::simple);
+        ref rhs = logic_or();
+        return m_builder.assignment(std::move(expr), std::move(rhs), ast::assignment_mode::simple);
     }
     if (consume(script::token_types::plus_equal)) {
-        ast::node_ptr rhs = logic_or();
-        return std::make_unique<ast::AssignmentNode>(std::move(expr), std::move(rhs), ast::assignment_mode::add);
+        ref rhs = logic_or();
+        return m_builder.assignment(std::move(expr), std::move(rhs), ast::assignment_mode::add);
     }
     if (consume(script::token_types::dash_equal)) {
-        ast::node_ptr rhs = logic_or();
-        return std::make_unique<ast::AssignmentNode>(std::move(expr), std::move(rhs), ast::assignment_mode::sub);
+        ref rhs = logic_or();
+        return m_builder.assignment(std::move(expr), std::move(rhs), ast::assignment_mode::sub);
     }
     if (consume(script::token_types::asterisk_equal)) {
-        ast::node_ptr rhs = logic_or();
-        return std::make_unique<ast::AssignmentNode>(std::move(expr), std::move(rhs), ast::assignment_mode::mul);
+        ref rhs = logic_or();
+        return m_builder.assignment(std::move(expr), std::move(rhs), ast::assignment_mode::mul);
     }
     if (consume(script::token_types::slash_equal)) {
-        ast::node_ptr rhs = logic_or();
-        return std::make_unique<ast::AssignmentNode>(std::move(expr), std::move(rhs), ast::assignment_mode::div);
+        ref rhs = logic_or();
+        return m_builder.assignment(std::move(expr), std::move(rhs), ast::assignment_mode::div);
     }
     return expr;
 }
 
 // expression         -> assignment
-ast::node_ptr Parser::expression () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::expression () {
     trace("expression");
     return assignment();
 }
 
+// format_call        -> "format" "(" STRING ( "," logic_or )* ")"
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::format_call () {
+    trace("format_call");
+    consume(script::token_types::string, "first parameter of 'format' must be a string");
+    /* copied, a pulled token does not outlive the arguments */
+    const script::Token rule_token = *prev();
+    object::Format format { rule_token.value_str };
+    list args;
+    while (!consume(script::token_types::round_bracket_close)) {
+        consume(script::token_types::comma, "missing ',' delimiter in 'format' call");
+        args.push_back(logic_or());
+    }
+    if (format.get_argument_count() != args.size()) {
+        throw SyntaxError{ "mismatch in format arguments", rule_token.line, rule_token.pos };
+    }
+    return m_builder.format(rule_token.value_str, std::move(format), std::move(args));
+}
+
 // break_statement    -> "break" ";"
-ast::node_ptr Parser::break_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::break_statement () {
     trace("break_statement");
     consume(script::token_types::semicolon, "missing ';' as 'break' statement termination");
-    return std::make_unique<ast::BreakNode>();
+    return m_builder.break_statement();
 }
 
 // continue_statement -> "continue" ";"
-ast::node_ptr Parser::continue_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::continue_statement () {
     trace("continue_statement");
     consume(script::token_types::semicolon, "missing ';' as 'continue' statement termination");
-    return std::make_unique<ast::ContinueNode>();
+    return m_builder.continue_statement();
 }
 
 // return_statement   -> "return" expression? ";"
-ast::node_ptr Parser::return_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::return_statement () {
     trace("return_statement");
-    ast::node_ptr value = expression();
+    ref value = expression();
     /* TODO : optional return value */
     consume(script::token_types::semicolon, "missing ';' as 'return' statement termination");
-    return std::make_unique<ast::ReturnNode>(std::move(value));
+    return m_builder.return_statement(std::move(value));
 }
 
 // exit_statement     -> "exit" expression ";"
-ast::node_ptr Parser::exit_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::exit_statement () {
     trace("exit_statement");
-    ast::node_ptr value = expression();
+    ref value = expression();
     consume(script::token_types::semicolon, "missing ';' as 'exit' statement termination");
-    return std::make_unique<ast::ExitNode>(std::move(value));
+    return m_builder.exit_statement(std::move(value));
 }
 
 // print_statement  -> "print" "(" STRING ( "," expression )* ")" ";"
-ast::node_ptr Parser::print_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::print_statement () {
     trace("print_statement");
-    std::unique_ptr<ast::PrintNode> print_node_ptr = std::make_unique<ast::PrintNode>();
     consume(script::token_types::round_bracket_open, "missing '(' after 'print'");
     consume(script::token_types::string, "first parameter of 'print' must be a string");
-    print_node_ptr->set_rule(prev()->value_str);
+    const script::Token rule_token = *prev();
+    object::Format format { rule_token.value_str };
+    list args;
     while (!consume(script::token_types::round_bracket_close)) {
         consume(script::token_types::comma, "missing ',' delimiter in 'print' statement");
-        print_node_ptr->add_argument(expression());
+        args.push_back(expression());
+    }
+    if (format.get_argument_count() != args.size()) {
+        throw SyntaxError{ "mismatch in print arguments", rule_token.line, rule_token.pos };
     }
     consume(script::token_types::semicolon, "missing ';' as 'print' statement termination");
-    return print_node_ptr;
+    return m_builder.print(rule_token.value_str, std::move(format), std::move(args));
 }
 
 // while_statement  -> "while" "(" expression ")" block
-ast::node_ptr Parser::while_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::while_statement () {
     trace("while_statement");
-    std::unique_ptr<ast::WhileStatementNode> while_node_ptr = std::make_unique<ast::WhileStatementNode>();
     consume(script::token_types::round_bracket_open, "missing '(' after 'while'");
-    while_node_ptr->set_condition(expression());
+    ref condition = expression();
     consume(script::token_types::round_bracket_close, "missing ')' after 'while' statement condition");
-    while_node_ptr->set_body(block());
-    return while_node_ptr;
+    ref body = block();
+    return m_builder.while_statement(std::move(condition), std::move(body));
 }
 
 // for_statement    -> "for" "(" ( var_decl | exp_statement | ";" ) expression? ";" expression? ")" block
-ast::node_ptr Parser::for_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::for_statement () {
     trace("for_statement");
-    std::unique_ptr<ast::ForStatementNode> for_node_ptr = std::make_unique<ast::ForStatementNode>();
+    ref initialization = m_builder.none();
+    ref test = m_builder.none();
+    ref update = m_builder.none();
     consume(script::token_types::round_bracket_open, "missing '(' after 'for'");
     /* processing initialization (no multiple initializations supported) */
-    if (consume(script::token_types::kw_var)) { for_node_ptr->set_initialization(var_decl()); }
+    if (consume(script::token_types::kw_var)) { initialization = var_decl(); }
     else if (consume(script::token_types::semicolon)) { /* nothing to do, no initialization found */ }
-    else { for_node_ptr->set_initialization(exp_statement()); }
+    else { initialization = exp_statement(); }
     /* processing tests (again, && and || are OK, but ',' is not) */
     if (consume(script::token_types::semicolon)) { /* nothing to do, no test found */ }
-    else { for_node_ptr->set_test(expression()); }
+    else { test = expression(); }
     consume(script::token_types::semicolon, "missing ';' after 'for' loop test");
     /* processing update (again, no multiple updates supported) */
     if (consume(script::token_types::semicolon)) { /* nothing to do, no update found */ }
-    else { for_node_ptr->set_update(expression()); }
+    else { update = expression(); }
     consume(script::token_types::round_bracket_close, "missing ')' after 'for' loop specification");
-    for_node_ptr->set_body(block());
-    return for_node_ptr;
+    ref body = block();
+    return m_builder.for_statement(std::move(initialization), std::move(test), std::move(update), std::move(body));
 }
 
 // if_statement     -> "if" "(" expression ")" block ( "else if" "(" expression ")" block )* ( "else" block )?
-ast::node_ptr Parser::if_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::if_statement () {
     trace("if_statement");
-    std::unique_ptr<ast::IfStatementNode> if_node_ptr = std::make_unique<ast::IfStatementNode>();
+    list conditions;
+    list bodies;
+    ref else_body = m_builder.none();
     consume(script::token_types::round_bracket_open, "missing '(' after 'if'");
-    if_node_ptr->set_if_condition(expression());
+    conditions.push_back(expression());
     consume(script::token_types::round_bracket_close, "missing ')' after 'if' statement condition");
-    if_node_ptr->add_block(block());
+    bodies.push_back(block());
     while (consume(script::token_types::kw_elif)) {
         consume(script::token_types::round_bracket_open, "missing '(' after 'else if'");
-        if_node_ptr->add_elif_condition(expression());
+        conditions.push_back(expression());
         consume(script::token_types::round_bracket_close, "missing ')' after 'else if' statement condition");
-        if_node_ptr->add_block(block());
+        bodies.push_back(block());
     }
     if (consume(script::token_types::kw_else)) {
-        if_node_ptr->add_else();
-        if_node_ptr->add_block(block());
+        else_body = block();
     }
-    return if_node_ptr;
+    return m_builder.if_statement(std::move(conditions), std::move(bodies), std::move(else_body));
 }
 
 // exp_statement    -> expression ";"
-ast::node_ptr Parser::exp_statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::exp_statement () {
     trace("exp_statement");
-    ast::node_ptr exp = expression();
+    ref exp = expression();
     consume(script::token_types::semicolon, "missing ';' at expression termination");
     return exp;
 }
 
 // statement        -> exp_statement | if_statement | for_statement | while_statement | print_statement | control
-ast::node_ptr Parser::statement () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::statement () {
     trace("statement");
     if (consume(script::token_types::kw_if)) { return if_statement(); }
     if (consume(script::token_types::kw_for)) { return for_statement(); }
@@ -477,48 +535,93 @@ ast::node_ptr Parser::statement () {
 }
 
 // block            -> "{" statement* "}"
-ast::node_ptr Parser::block () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::block () {
     trace("block");
     consume(script::token_types::curly_bracket_open, "missing scope opening '{' token");
-    std::unique_ptr<ast::BlockNode> block_ptr = std::make_unique<ast::BlockNode>();
+    list statements;
     while (!consume(script::token_types::curly_bracket_close)) {
-        block_ptr->add_node(statement());
+        const std::size_t line = done() ? prev()->line : curr()->line;
+        statements.push_back(m_builder.at(statement(), line));
+    }
+    return m_builder.block(std::move(statements));
+}
+
+template <typename Builder>
+void BasicParser<Builder>::skip_block () {
+    trace("skip_block");
+    consume(script::token_types::curly_bracket_open, "missing scope opening '{' token");
+    const script::Token open = *prev();
+    std::size_t depth = 1;
+    while (depth > 0) {
+        if (done()) { throw SyntaxError{ "missing scope closing '}' token", open.line, open.pos }; }
+        if (curr()->type == script::token_types::curly_bracket_open) { ++depth; }
+        else if (curr()->type == script::token_types::curly_bracket_close) { --depth; }
+        next();
     }
-    return block_ptr;
 }
 
 // var_decl         -> "var" IDENTIFIER ( "=" expression )? ";"
-ast::node_ptr Parser::var_decl () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::var_decl () {
     trace("var_decl");
     consume(script::token_types::identifier, "missing variable name in declaration");
-    std::string variable_name = prev()->value_str;
+    std::string_view variable_name = prev()->value_str;
     if (consume(script::token_types::equal_sign)) {
-        ast::node_ptr exp = expression();
+        ref exp = expression();
         consume(script::token_types::semicolon, "missing ';' declaration termination");
-        return std::make_unique<ast::DeclAndInitOperationNode>(variable_name, std::move(exp));
+        return m_builder.declaration(variable_name, std::move(exp));
     }
     consume(script::token_types::semicolon, "missing ';' declaration termination");
-    return std::make_unique<ast::DeclarationOperationNode>(variable_name);
+    return m_builder.declaration(variable_name);
 }
 
 // func_decl        -> "function" IDENTIFIER "(" ( IDENTIFIER ("," IDENTIFIER)* )? ")" block
-ast::node_ptr Parser::func_decl () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::func_decl () {
     trace("func_decl");
     consume(script::token_types::identifier, "missing function name");
-    std::unique_ptr<ast::FunctionDeclNode> func_ptr = std::make_unique<ast::FunctionDeclNode>(prev()->value_str);
+    std::string_view name = prev()->value_str;
+    std::vector<std::string_view> params;
     consume(script::token_types::round_bracket_open, "missing '(' after function name in function declaration");
     while (consume(script::token_types::identifier)) {
-        func_ptr->add_parameter(prev()->value_str);
+        params.push_back(prev()->value_str);
         if (consume(script::token_types::comma)) { continue; }
         break;
     }
     consume(script::token_types::round_bracket_close, "missing ')' after function parameters");
-    func_ptr->set_body(block());
-    return func_ptr;
+    if constexpr (Builder::lazy_functions) {
+        if (m_stream_source && !done()) {
+            /* the body is lexed again from its opening bracket when it is compiled */
+            const script::Token open = *curr();
+            const std::size_t offset = m_ring[m_index % ring_size].offset;
+            skip_block();
+            return m_builder.func_decl(name, std::move(params), [source = m_stream_source, open, offset] () {
+                BasicParser<Builder> parser {};
+                parser.stream(source, open.line, offset, open.pos);
+                return parser.block();
+            });
+        }
+        if (m_token_owner) {
+            const std::size_t body_start = m_index;
+            skip_block();
+            return m_builder.func_decl(name, std::move(params), [tokens = m_token_owner, source = m_source, body_start] () {
+                BasicParser<Builder> parser {};
+                parser.m_tokens = tokens.get();
+                parser.m_token_owner = tokens;
+                parser.m_source = source;
+                parser.m_index = body_start;
+                return parser.block();
+            });
+        }
+    }
+    ref body = block();
+    return m_builder.func_decl(name, std::move(params), std::move(body));
 }
 
 // declaration      -> func_decl | var_decl | statement
-ast::node_ptr Parser::declaration () {
+template <typename Builder>
+typename BasicParser<Builder>::ref BasicParser<Builder>::declaration () {
     trace("declaration");
     /* comment must be the first one checked so that the others can be checked when the comment is ignored */
     if (consume(script::token_types::comment_start)) {
@@ -534,16 +637,37 @@ ast::node_ptr Parser::declaration () {
 }
 
 
-ast::node_ptr Parser::parse (const std::vector<script::Token>& tokens) {
-    for (const script::Token& token : tokens) {
-        m_tokens.push_back(&token);
+template <typename Builder>
+typename BasicParser<Builder>::result BasicParser<Builder>::parse (const std::vector<script::Token>& tokens, std::shared_ptr<const script::Source> source) {
+    m_tokens = &tokens;
+    m_source = source;
+    list statements;
+    while (!done()) {
+        const std::size_t line = curr()->line;
+        statements.push_back(m_builder.at(declaration(), line));
     }
-    std::unique_ptr<ast::MainNode> main_node = std::make_unique<ast::MainNode>();
-    while (m_index < m_tokens.size()) {
-        main_node->add_node(declaration());
+    return m_builder.main(std::move(statements), std::move(source));
+}
+
+template <typename Builder>
+typename BasicParser<Builder>::result BasicParser<Builder>::parse (std::shared_ptr<script::Source> source, std::size_t first_line) {
+    stream(source, first_line, 0, 1);
+    list statements;
+    while (!done()) {
+        const std::size_t line = curr()->line;
+        statements.push_back(m_builder.at(declaration(), line));
     }
-    return main_node;
+    return m_builder.main(std::move(statements), std::move(source));
 }
 
+template <typename Builder>
+typename BasicParser<Builder>::result BasicParser<Builder>::parse (std::shared_ptr<const std::vector<script::Token>> tokens, std::shared_ptr<const script::Source> source) {
+    m_token_owner = tokens;
+    return parse(*tokens, std::move(source));
+}
+
+template class BasicParser<TreeBuilder>;
+template class BasicParser<FlatBuilder>;
+
 } /* namespace parser */
 } /* namespace mlang */
\ No newline at end of file
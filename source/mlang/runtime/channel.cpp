@@ -0,0 +1,313 @@
+#include "mlang/runtime/channel.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/boolean.hpp"
+#include "mlang/object/assert.hpp"
+#include "mlang/exception.hpp"
+
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace mlang {
+namespace runtime {
+
+/* the ring of Dmitry Vyukov's bounded MPMC queue, every cell carries a sequence number */
+/* a cell at position p is free for the sender of p when its sequence is 2p, and full for the receiver of p when it is 2p + 1 */
+/* the original p and p + 1 cannot tell a full cell from a free one when the capacity is 1 */
+/* senders and receivers only meet on the mutex when one of them has to wait */
+/* the closed flag is the lowest bit of the tail, a send either takes its position before the close or sees the flag */
+class Channel::State {
+public:
+    enum class push_status { pushed, full, closed };
+
+    struct Cell {
+        std::atomic<std::size_t> sequence { 0 };
+        object::Object value {};    /* a received value is released when the cell is reused */
+    };
+
+    const std::size_t capacity;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::size_t> head { 0 };    /* position of the next receive */
+    alignas(64) std::atomic<std::size_t> tail { 0 };    /* 2 * position of the next send, + 1 once the channel is closed */
+    std::atomic<std::size_t> waiting { 0 };             /* senders and receivers parked below */
+    std::mutex mutex;
+    std::deque<Resumer> senders;
+    std::deque<Resumer> receivers;
+
+    explicit State (std::size_t size) : capacity(size), cells(std::make_unique<Cell[]>(size)) {
+        for (std::size_t i = 0; i < capacity; ++i) { cells[i].sequence.store(2 * i, std::memory_order_relaxed); }
+    }
+
+    push_status push (const object::Object& value) {
+        std::size_t last = tail.load(std::memory_order_relaxed);
+        while (true) {
+            if ((last & 1) != 0) { return push_status::closed; }
+            const std::size_t pos = last >> 1;
+            Cell& cell = cells[pos % capacity];
+            const std::intptr_t diff = static_cast<std::intptr_t>(cell.sequence.load(std::memory_order_acquire) - 2 * pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(last, last + 2, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(2 * pos + 1, std::memory_order_release);
+                    return push_status::pushed;
+                }
+            }
+            else if (diff < 0) { return push_status::full; }
+            else { last = tail.load(std::memory_order_relaxed); }
+        }
+    }
+
+    bool pop (object::Object& value) {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos % capacity];
+            const std::intptr_t diff = static_cast<std::intptr_t>(cell.sequence.load(std::memory_order_acquire) - (2 * pos + 1));
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(2 * (pos + capacity), std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) { return false; }
+            else { pos = head.load(std::memory_order_relaxed); }
+        }
+    }
+
+    bool is_closed () const { return (tail.load() & 1) != 0; }
+
+    /* closed and every value sent before the close was received, the tail does not move after the close */
+    bool is_drained () const {
+        const std::size_t last = tail.load();
+        return ((last & 1) != 0) && (head.load() >= (last >> 1));
+    }
+
+    bool can_push () const {
+        const std::size_t pos = tail.load(std::memory_order_acquire) >> 1;
+        return static_cast<std::intptr_t>(cells[pos % capacity].sequence.load(std::memory_order_acquire) - 2 * pos) >= 0;
+    }
+
+    bool can_pop () const {
+        const std::size_t pos = head.load(std::memory_order_acquire);
+        return static_cast<std::intptr_t>(cells[pos % capacity].sequence.load(std::memory_order_acquire) - (2 * pos + 1)) >= 0;
+    }
+
+    /* parks the caller until 'ready' may have changed, it is checked again after the waiter is queued */
+    template <typename Ready>
+    void wait (std::deque<Resumer>& queue, Ready ready) {
+        suspend([&] (Resumer resumer) {
+            std::unique_lock<std::mutex> lock { mutex };
+            waiting.fetch_add(1);
+            /* pairs with the fence in 'wake', either the waker sees this waiter or this check sees its change */
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready()) {
+                waiting.fetch_sub(1);
+                lock.unlock();
+                resumer.resume();
+                return;
+            }
+            queue.push_back(std::move(resumer));
+        });
+    }
+
+    /* resumes one waiter of 'queue', a waiter whose task is gone does not count */
+    void wake (std::deque<Resumer>& queue) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0) { return; }
+        std::unique_lock<std::mutex> lock { mutex };
+        while (!queue.empty()) {
+            Resumer resumer = std::move(queue.front());
+            queue.pop_front();
+            waiting.fetch_sub(1);
+            if (resumer.resume()) { return; }
+        }
+    }
+
+    void wake_all () {
+        std::deque<Resumer> parked;
+        {
+            std::lock_guard<std::mutex> lock { mutex };
+            parked.swap(senders);
+            for (Resumer& resumer : receivers) { parked.push_back(std::move(resumer)); }
+            receivers.clear();
+            waiting.store(0);
+        }
+        for (const Resumer& resumer : parked) { resumer.resume(); }
+    }
+};
+
+namespace {
+
+/* the receiver gets a value that shares nothing with the sender, except for channels */
+object::Object transfer (const object::Object& value) {
+    const std::shared_ptr<object::Array> array = std::dynamic_pointer_cast<object::Array>(value.get_internal());
+    if (!array) { return value.copy(); }
+    std::vector<object::Object> elements;
+    elements.reserve(array->get_elements().size());
+    for (const object::Object& element : array->get_elements()) { elements.push_back(transfer(element)); }
+    return object::Object { std::make_shared<object::Array>(std::move(elements)) };
+}
+
+} /* namespace */
+
+Channel::Channel (std::size_t capacity) {
+    if (capacity == 0) { throw RuntimeError{"the capacity of a channel must be positive"}; }
+    m_state = std::make_shared<State>(capacity);
+}
+
+Channel::State& Channel::get_state () const {
+    if (!m_state) { throw RuntimeError{"channel is not constructed"}; }
+    return *m_state;
+}
+
+script::type_id Channel::define_type () {
+    static const script::type_id id = script::Environment::define_type(type_name, std::make_shared<ChannelFactory>());
+    return id;
+}
+
+void Channel::send (const object::Object& value) {
+    State& state = get_state();
+    if (value.is_none()) { throw RuntimeError{"none cannot be sent, it marks the end of a closed channel"}; }
+    const object::Object copy = transfer(value);
+    while (true) {
+        const State::push_status status = state.push(copy);
+        if (status == State::push_status::pushed) {
+            state.wake(state.receivers);
+            return;
+        }
+        if (status == State::push_status::closed) { throw RuntimeError{"send on a closed channel"}; }
+        state.wait(state.senders, [&state] () { return state.is_closed() || state.can_push(); });
+    }
+}
+
+bool Channel::try_send (const object::Object& value) {
+    State& state = get_state();
+    if (value.is_none()) { throw RuntimeError{"none cannot be sent, it marks the end of a closed channel"}; }
+    if (state.push(transfer(value)) != State::push_status::pushed) { return false; }
+    state.wake(state.receivers);
+    return true;
+}
+
+object::Object Channel::recv () {
+    State& state = get_state();
+    object::Object value {};
+    while (true) {
+        if (state.pop(value)) {
+            state.wake(state.senders);
+            /* the other receivers waited for the last value of a closed channel */
+            if (state.is_drained()) { state.wake_all(); }
+            return value;
+        }
+        /* the values sent before the channel was closed are still delivered, a sender may still be writing one of them */
+        if (state.is_drained()) { return object::Object {}; }
+        state.wait(state.receivers, [&state] () { return state.can_pop() || state.is_drained(); });
+    }
+}
+
+bool Channel::try_recv (object::Object& value) {
+    State& state = get_state();
+    if (!state.pop(value)) { return false; }
+    state.wake(state.senders);
+    if (state.is_drained()) { state.wake_all(); }
+    return true;
+}
+
+bool Channel::close () {
+    State& state = get_state();
+    if ((state.tail.fetch_or(1) & 1) != 0) { return false; }
+    state.wake_all();
+    return true;
+}
+
+bool Channel::is_closed () const { return get_state().is_closed(); }
+
+std::size_t Channel::get_size () const {
+    const State& state = get_state();
+    const std::size_t head = state.head.load();
+    const std::size_t tail = state.tail.load() >> 1;
+    return (tail > head) ? std::min(tail - head, state.capacity) : 0;
+}
+
+std::size_t Channel::get_capacity () const { return get_state().capacity; }
+
+std::string Channel::get_typename () const { return type_name; }
+
+const object::ObjectFactory& Channel::get_factory () const {
+    static ChannelFactory factory{};
+    return factory;
+}
+
+/* construct */
+void Channel::construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    object::assert_params(params, 1, type_name, "constructor");
+    object::assert_parameter(params[0], type_name, "constructor");
+    const int capacity = params[0]->get_int();
+    if (capacity <= 0) { throw RuntimeError{"the capacity of a channel must be positive"}; }
+    m_state = std::make_shared<State>(static_cast<std::size_t>(capacity));
+}
+
+/* assign, both objects refer to the same channel */
+void Channel::assign (const std::shared_ptr<object::InternalObject> param) {
+    const std::shared_ptr<Channel> channel = object::assert_cast<Channel>(param, type_name);
+    m_state = channel->m_state;
+}
+
+std::shared_ptr<object::InternalObject> Channel::call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    if (func.compare("send") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        send(object::Object { params[0] });
+        return std::make_shared<object::None>();
+    }
+    else if (func.compare("try_send") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        return std::make_shared<object::Boolean>(try_send(object::Object { params[0] }));
+    }
+    else if (func.compare("recv") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return recv().get_internal();
+    }
+    else if (func.compare("try_recv") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        object::Object value {};
+        try_recv(value);
+        return value.get_internal();
+    }
+    else if (func.compare("close") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        close();
+        return std::make_shared<object::None>();
+    }
+    else if (func.compare("is_closed") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return std::make_shared<object::Boolean>(is_closed());
+    }
+    else if (func.compare("length") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return std::make_shared<object::Int>(static_cast<int>(get_size()));
+    }
+    else if (func.compare("capacity") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return std::make_shared<object::Int>(static_cast<int>(get_capacity()));
+    }
+    else {
+        throw RuntimeError { "object of type '" + type_name + "' has no '" + func + "' member function" };
+    }
+}
+
+std::shared_ptr<object::InternalObject> Channel::access (const std::string& member) {
+    throw RuntimeError { "object of type '" + type_name + "' has no '" + member + "' member" };
+}
+
+std::string Channel::get_string () const { return type_name; }
+
+std::shared_ptr<object::InternalObject> ChannelFactory::create () const {
+    return std::make_shared<Channel>();
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,177 @@
+#include "mlang/runtime/event_bus.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/exception.hpp"
+
+#include <mutex>
+#include <deque>
+#include <unordered_set>
+#include <algorithm>
+
+namespace mlang {
+namespace runtime {
+
+class EventBus::Subscriber {
+public:
+    std::mutex mutex;
+    std::deque<std::string> pending;    /* oldest first, every topic at most once */
+    std::unordered_set<std::string, StringHash, std::equal_to<>> pending_topics;    /* the topics of 'pending' */
+    std::deque<Resumer> waiting;        /* scripts waiting for the next topic, oldest first */
+
+    /* returns false if the topic was still pending */
+    /* a waiter whose task is gone does not take the topic, it stays pending if no waiter takes it */
+    bool notify (std::string_view topic) {
+        std::lock_guard<std::mutex> lock { mutex };
+        if (pending_topics.find(topic) != pending_topics.end()) { return false; }
+        while (!waiting.empty()) {
+            Resumer resumer = std::move(waiting.front());
+            waiting.pop_front();
+            if (resumer.resume(object::Object { std::make_shared<object::String>(std::string { topic }) })) { return true; }
+        }
+        pending.emplace_back(topic);
+        pending_topics.emplace(topic);
+        return true;
+    }
+
+    bool take (std::string& topic) {
+        std::lock_guard<std::mutex> lock { mutex };
+        if (pending.empty()) { return false; }
+        topic = pop_pending();
+        return true;
+    }
+
+    /* the oldest pending topic, the mutex is held and 'pending' is not empty */
+    std::string pop_pending () {
+        std::string topic = std::move(pending.front());
+        pending.pop_front();
+        pending_topics.erase(topic);
+        return topic;
+    }
+};
+
+EventBus::EventBus () = default;
+
+EventBus::~EventBus () = default;
+
+std::shared_ptr<EventBus::Subscriber> EventBus::find (std::string_view subscriber) const {
+    std::shared_lock<std::shared_mutex> lock { m_mutex };
+    auto it = m_subscribers.find(subscriber);
+    if (it == m_subscribers.end()) { throw RuntimeError{"subscriber '" + std::string { subscriber } + "' does not exist"}; }
+    return it->second;
+}
+
+void EventBus::subscribe (std::string_view subscriber, std::string_view topic) {
+    std::unique_lock<std::shared_mutex> lock { m_mutex };
+    auto it = m_subscribers.find(subscriber);
+    if (it == m_subscribers.end()) { it = m_subscribers.emplace(std::string { subscriber }, std::make_shared<Subscriber>()).first; }
+    auto topic_it = m_topics.find(topic);
+    if (topic_it == m_topics.end()) { topic_it = m_topics.emplace(std::string { topic }, std::vector<std::shared_ptr<Subscriber>> {}).first; }
+    std::vector<std::shared_ptr<Subscriber>>& subscribers = topic_it->second;
+    if (std::find(subscribers.begin(), subscribers.end(), it->second) == subscribers.end()) { subscribers.push_back(it->second); }
+}
+
+bool EventBus::unsubscribe (std::string_view subscriber, std::string_view topic) {
+    std::unique_lock<std::shared_mutex> lock { m_mutex };
+    auto it = m_subscribers.find(subscriber);
+    auto topic_it = m_topics.find(topic);
+    if ((it == m_subscribers.end()) || (topic_it == m_topics.end())) { return false; }
+    std::vector<std::shared_ptr<Subscriber>>& subscribers = topic_it->second;
+    auto position = std::find(subscribers.begin(), subscribers.end(), it->second);
+    if (position == subscribers.end()) { return false; }
+    subscribers.erase(position);
+    if (subscribers.empty()) { m_topics.erase(topic_it); }
+    return true;
+}
+
+std::size_t EventBus::publish (std::string_view topic) {
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    std::size_t notified = 0;
+    std::size_t coalesced = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock { m_mutex };
+        auto it = m_topics.find(topic);
+        if (it == m_topics.end()) { return 0; }
+        for (const std::shared_ptr<Subscriber>& subscriber : it->second) {
+            if (subscriber->notify(topic)) { ++notified; }
+            else { ++coalesced; }
+        }
+    }
+    if (notified > 0) { m_delivered.fetch_add(notified, std::memory_order_relaxed); }
+    if (coalesced > 0) { m_coalesced.fetch_add(coalesced, std::memory_order_relaxed); }
+    return notified;
+}
+
+std::string EventBus::wait_for (std::string_view subscriber) {
+    std::shared_ptr<Subscriber> state = find(subscriber);
+    std::string topic;
+    if (state->take(topic)) { return topic; }
+    object::Object result = suspend([&state] (Resumer resumer) {
+        std::unique_lock<std::mutex> lock { state->mutex };
+        /* published between the check and the suspension */
+        if (!state->pending.empty()) {
+            std::string pending = state->pop_pending();
+            lock.unlock();
+            resumer.resume(object::Object { std::make_shared<object::String>(std::move(pending)) });
+            return;
+        }
+        state->waiting.push_back(std::move(resumer));
+    });
+    return result.get_string();
+}
+
+bool EventBus::poll (std::string_view subscriber, std::string& topic) { return find(subscriber)->take(topic); }
+
+EventBusStats EventBus::get_stats () const {
+    EventBusStats stats {};
+    stats.published = m_published.load(std::memory_order_relaxed);
+    stats.delivered = m_delivered.load(std::memory_order_relaxed);
+    stats.coalesced = m_coalesced.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventBus::declare_functions (script::EnvStack& env) const {
+    env.declare_function("subscribe", &m_subscribe);
+    env.declare_function("wait_for", &m_wait_for);
+    env.declare_function("publish", &m_publish);
+}
+
+namespace {
+
+void assert_string (const std::vector<object::Object>& params, std::size_t count, const std::string& function) {
+    if (params.size() != count) { throw RuntimeError{function + " expects " + std::to_string(count) + " parameter(s)"}; }
+    for (const object::Object& param : params) {
+        if (param.get_typename() != object::String::type_name) {
+            throw RuntimeError{function + " expects parameters of type " + object::String::type_name};
+        }
+    }
+}
+
+} /* namespace */
+
+SubscribeFunction::SubscribeFunction (EventBus& bus) : m_bus(bus) {}
+
+object::Object SubscribeFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_string(params, 2, "subscribe");
+    m_bus.subscribe(params[0].get_string(), params[1].get_string());
+    return object::Object {};
+}
+
+WaitForFunction::WaitForFunction (EventBus& bus) : m_bus(bus) {}
+
+object::Object WaitForFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_string(params, 1, "wait_for");
+    /* the output of the script so far is visible while it waits */
+    env.get_output().flush();
+    return object::Object { std::make_shared<object::String>(m_bus.wait_for(params[0].get_string())) };
+}
+
+PublishFunction::PublishFunction (EventBus& bus) : m_bus(bus) {}
+
+object::Object PublishFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_string(params, 1, "publish");
+    return object::Object { std::make_shared<object::Int>(static_cast<int>(m_bus.publish(params[0].get_string()))) };
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
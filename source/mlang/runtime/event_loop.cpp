@@ -0,0 +1,358 @@
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/exception.hpp"
+
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <map>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <condition_variable>
+
+#if defined(__SANITIZE_THREAD__)
+#include <sanitizer/tsan_interface.h>
+#endif
+
+namespace mlang {
+namespace runtime {
+
+/* everything a task, a resumer or another thread may reach after the loop object itself is gone */
+class LoopCore {
+public:
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<std::shared_ptr<Task>> ready;
+    std::vector<std::function<void ()>> posted;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void ()>> timers;
+    std::unordered_set<std::shared_ptr<Task>> tasks;   /* spawned and not finished */
+    bool stopping { false };
+    bool closed { false };
+
+    void schedule (std::shared_ptr<Task> task) {
+        {
+            std::lock_guard<std::mutex> lock { mutex };
+            if (closed) { return; }
+            ready.push_back(std::move(task));
+        }
+        wakeup.notify_one();
+    }
+};
+
+class ResumeState {
+public:
+    std::atomic<bool> done { false };
+    std::atomic<std::uint32_t> signal { 0 };   /* for a suspension outside of a task */
+    std::shared_ptr<Task> task;
+    object::Object value {};
+};
+
+namespace {
+
+/* the task whose stack the calling thread is on */
+thread_local Task* current_task { nullptr };
+thread_local EventLoop* current_loop { nullptr };
+
+} /* namespace */
+
+/* a stack with a guard page below it and the context that runs on it */
+class Task::Fiber {
+private:
+    void* m_mapping { nullptr };
+    std::size_t m_size { 0 };
+    ucontext_t m_context {};
+    ucontext_t* m_caller { nullptr };
+#if defined(__SANITIZE_THREAD__)
+    void* m_tsan_fiber { nullptr };
+    void* m_tsan_caller { nullptr };
+#endif
+public:
+    Fiber (std::size_t stack_size) {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        m_size = ((stack_size + page - 1) / page + 1) * page;
+        m_mapping = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (m_mapping == MAP_FAILED) { throw RuntimeError{"could not allocate the stack of a task"}; }
+        mprotect(m_mapping, page, PROT_NONE);
+        getcontext(&m_context);
+        m_context.uc_stack.ss_sp = m_mapping;
+        m_context.uc_stack.ss_size = m_size;
+        m_context.uc_link = nullptr;
+        makecontext(&m_context, &Task::entry, 0);
+#if defined(__SANITIZE_THREAD__)
+        m_tsan_fiber = __tsan_create_fiber(0);
+#endif
+    }
+
+    ~Fiber () {
+#if defined(__SANITIZE_THREAD__)
+        __tsan_destroy_fiber(m_tsan_fiber);
+#endif
+        munmap(m_mapping, m_size);
+    }
+
+    /* from the loop into the task, returns once the task suspends or finishes */
+    void enter () {
+        ucontext_t caller {};
+        m_caller = &caller;
+#if defined(__SANITIZE_THREAD__)
+        m_tsan_caller = __tsan_get_current_fiber();
+        __tsan_switch_to_fiber(m_tsan_fiber, 0);
+#endif
+        swapcontext(&caller, &m_context);
+    }
+
+    /* from the task back to the loop */
+    void leave () {
+#if defined(__SANITIZE_THREAD__)
+        __tsan_switch_to_fiber(m_tsan_caller, 0);
+#endif
+        swapcontext(&m_context, m_caller);
+    }
+};
+
+Resumer::Resumer (std::shared_ptr<ResumeState> state) : m_state(std::move(state)) {}
+
+bool Resumer::resume (object::Object value) const {
+    bool expected = false;
+    if (!m_state->done.compare_exchange_strong(expected, true)) { return false; }
+    m_state->value = std::move(value);
+    if (m_state->task) {
+        std::shared_ptr<Task> task = std::move(m_state->task);
+        std::shared_ptr<LoopCore> core = task->m_core;
+        core->schedule(std::move(task));
+    }
+    else {
+        m_state->signal.store(1, std::memory_order_release);
+        m_state->signal.notify_one();
+    }
+    return true;
+}
+
+object::Object suspend (const std::function<void (Resumer)>& start) {
+    std::shared_ptr<ResumeState> state = std::make_shared<ResumeState>();
+    Task* task = current_task;
+    if (task == nullptr) {
+        start(Resumer { state });
+        state->signal.wait(0, std::memory_order_acquire);
+        return std::move(state->value);
+    }
+    if (task->m_cancel) { throw TaskCancelled{}; }
+    state->task = task->shared_from_this();
+    start(Resumer { state });
+    /* a resume that already happened only queued the task, the loop continues it after the switch */
+    task->m_status = task_status::suspended;
+    task->m_fiber->leave();
+    if (task->m_cancel) {
+        /* a later resume reports that nobody takes its value anymore */
+        if (!state->done.exchange(true)) { state->task.reset(); }
+        throw TaskCancelled{};
+    }
+    return std::move(state->value);
+}
+
+void yield () {
+    if (current_task == nullptr) { return; }
+    /* the task is queued behind the ones that are ready already */
+    suspend([] (Resumer resumer) { resumer.resume(); });
+}
+
+Task::Task (std::shared_ptr<const script::Program> program, env_initializer initializer, task_callback on_finished, std::shared_ptr<LoopCore> core)
+    : m_program(std::move(program)), m_initializer(std::move(initializer)), m_on_finished(std::move(on_finished)), m_core(std::move(core)) {}
+
+Task::~Task () = default;
+
+void Task::entry () {
+    Task* task = current_task;
+    task->body();
+    task->m_status = task_status::finished;
+    task->m_fiber->leave();
+}
+
+void Task::body () {
+    /* nothing may escape the stack of the task */
+    try {
+        if (m_cancel) { throw TaskCancelled{}; }
+        if (m_initializer) { m_initializer(m_env); }
+        if (m_time_slice != 0) {
+            script::Budget budget = m_env.get_budget();
+            budget.check_interval = std::min(budget.check_interval, m_time_slice);
+            budget.yield = &yield;
+            m_env.set_budget(std::move(budget));
+        }
+        m_exit_code = m_program->execute(m_env, m_value);
+    }
+    catch (const TaskCancelled&) {
+        m_exit_code = -1;
+    }
+    catch (...) {
+        m_exit_code = -1;
+        m_error = std::current_exception();
+    }
+}
+
+task_status Task::get_status () const { return m_status.load(); }
+
+bool Task::is_finished () const { return m_status.load() == task_status::finished; }
+
+int Task::get_exit_code () const { return m_exit_code; }
+
+const object::Object& Task::get_value () const { return m_value; }
+
+std::exception_ptr Task::get_error () const { return m_error; }
+
+script::EnvStack& Task::get_environment () { return m_env; }
+
+EventLoop::EventLoop (std::size_t stack_size) : m_core(std::make_shared<LoopCore>()), m_stack_size(stack_size) {}
+
+EventLoop::~EventLoop () {
+    std::unordered_set<std::shared_ptr<Task>> tasks;
+    std::deque<std::shared_ptr<Task>> ready;
+    std::vector<std::function<void ()>> posted;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void ()>> timers;
+    {
+        /* the callbacks may hold resumers, which hold tasks, which hold the core */
+        std::lock_guard<std::mutex> lock { m_core->mutex };
+        m_core->closed = true;
+        tasks.swap(m_core->tasks);
+        ready.swap(m_core->ready);
+        posted.swap(m_core->posted);
+        timers.swap(m_core->timers);
+    }
+    EventLoop* previous = current_loop;
+    current_loop = this;
+    for (const std::shared_ptr<Task>& task : tasks) {
+        task->m_cancel = true;
+        /* a task that never ran has nothing to unwind */
+        if (task->m_fiber) {
+            while (!task->is_finished()) { resume(task); }
+        }
+    }
+    current_loop = previous;
+}
+
+std::shared_ptr<Task> EventLoop::spawn (std::shared_ptr<const script::Program> program, env_initializer initializer, task_callback on_finished) {
+    if (!program) { throw RuntimeError{"cannot spawn a task without a program"}; }
+    std::shared_ptr<Task> task = std::make_shared<Task>(std::move(program), std::move(initializer), std::move(on_finished), m_core);
+    task->m_time_slice = m_time_slice.load();
+    {
+        std::lock_guard<std::mutex> lock { m_core->mutex };
+        m_core->tasks.insert(task);
+        m_core->ready.push_back(task);
+    }
+    m_core->wakeup.notify_one();
+    return task;
+}
+
+void EventLoop::post (std::function<void ()> callback) {
+    {
+        std::lock_guard<std::mutex> lock { m_core->mutex };
+        m_core->posted.push_back(std::move(callback));
+    }
+    m_core->wakeup.notify_one();
+}
+
+void EventLoop::set_time_slice (std::uint32_t steps) { m_time_slice.store(steps); }
+
+void EventLoop::call_after (std::chrono::steady_clock::duration delay, std::function<void ()> callback) {
+    {
+        std::lock_guard<std::mutex> lock { m_core->mutex };
+        m_core->timers.emplace(std::chrono::steady_clock::now() + delay, std::move(callback));
+    }
+    m_core->wakeup.notify_one();
+}
+
+void EventLoop::resume (const std::shared_ptr<Task>& task) {
+    if (task->is_finished()) { return; }
+    if (!task->m_fiber) { task->m_fiber = std::make_unique<Task::Fiber>(m_stack_size); }
+    Task* previous = current_task;
+    current_task = task.get();
+    task->m_status = task_status::running;
+    task->m_fiber->enter();
+    current_task = previous;
+    if (task->is_finished()) {
+        task->m_fiber.reset();
+        {
+            std::lock_guard<std::mutex> lock { m_core->mutex };
+            m_core->tasks.erase(task);
+        }
+        if (task->m_on_finished) { task->m_on_finished(*task); }
+    }
+}
+
+void EventLoop::run () {
+    EventLoop* previous = current_loop;
+    current_loop = this;
+    std::deque<std::shared_ptr<Task>> ready;
+    std::vector<std::function<void ()>> callbacks;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock { m_core->mutex };
+            while (true) {
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                while (!m_core->timers.empty() && (m_core->timers.begin()->first <= now)) {
+                    callbacks.push_back(std::move(m_core->timers.begin()->second));
+                    m_core->timers.erase(m_core->timers.begin());
+                }
+                for (std::function<void ()>& callback : m_core->posted) { callbacks.push_back(std::move(callback)); }
+                m_core->posted.clear();
+                ready.swap(m_core->ready);
+                if (!ready.empty() || !callbacks.empty()) { break; }
+                if (m_core->tasks.empty() || m_core->stopping) {
+                    m_core->stopping = false;
+                    current_loop = previous;
+                    return;
+                }
+                /* without a timer the deadline only keeps the time point representable */
+                const std::chrono::steady_clock::time_point deadline = m_core->timers.empty() ? now + std::chrono::hours { 1 } : m_core->timers.begin()->first;
+                m_core->wakeup.wait_until(lock, deadline);
+            }
+        }
+        for (std::function<void ()>& callback : callbacks) { callback(); }
+        callbacks.clear();
+        for (const std::shared_ptr<Task>& task : ready) { resume(task); }
+        ready.clear();
+    }
+}
+
+void EventLoop::stop () {
+    {
+        std::lock_guard<std::mutex> lock { m_core->mutex };
+        m_core->stopping = true;
+    }
+    m_core->wakeup.notify_one();
+}
+
+std::size_t EventLoop::get_task_count () const {
+    std::lock_guard<std::mutex> lock { m_core->mutex };
+    return m_core->tasks.size();
+}
+
+EventLoop* EventLoop::current () { return current_loop; }
+
+object::Object SleepFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    if (params.size() != 1) { throw RuntimeError{"sleep expects 1 parameter"}; }
+    if (params[0].get_typename() != object::Int::type_name) {
+        throw RuntimeError{"sleep expects the 1st parameter to be of type " + object::Int::type_name};
+    }
+    const std::chrono::milliseconds delay { params[0].get_int() };
+    EventLoop* loop = EventLoop::current();
+    if ((loop == nullptr) || (current_task == nullptr)) {
+        std::this_thread::sleep_for(delay);
+        return object::Object {};
+    }
+    return suspend([loop, delay] (Resumer resumer) {
+        loop->call_after(delay, [resumer] () { resumer.resume(); });
+    });
+}
+
+void declare_event_loop_functions (script::EnvStack& env) {
+    static const SleepFunction sleep {};
+    env.declare_function("sleep", &sleep);
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,211 @@
+#include "mlang/runtime/executor.hpp"
+#include "mlang/exception.hpp"
+
+#include <time.h>
+#include <algorithm>
+#include <exception>
+
+namespace mlang {
+namespace runtime {
+
+namespace {
+
+enum job_states : int { pending, running, finished, cancelled };
+
+/* the worker the current thread belongs to, jobs submitted by a running job stay on it */
+thread_local Executor* current_executor { nullptr };
+thread_local std::size_t current_worker { 0 };
+
+std::chrono::nanoseconds thread_cpu_time () {
+    timespec time {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds { time.tv_sec } + std::chrono::nanoseconds { time.tv_nsec };
+}
+
+} /* namespace */
+
+class JobState {
+public:
+    std::shared_ptr<const script::Program> program;
+    std::function<void ()> work;                    /* instead of the program */
+    env_initializer initializer;
+    job_inputs inputs;
+    job_priority priority { job_priority::normal };
+    std::promise<JobResult> result;
+    std::atomic<int> state { pending };
+};
+
+Job::Job (std::shared_ptr<JobState> state, std::future<JobResult> result) : m_state(std::move(state)), m_result(std::move(result)) {}
+
+bool Job::cancel () {
+    int expected = pending;
+    if (!m_state->state.compare_exchange_strong(expected, cancelled)) { return false; }
+    /* the queued entry is dropped by the worker that finds it */
+    JobResult result {};
+    result.exit_code = -1;
+    result.cancelled = true;
+    m_state->result.set_value(std::move(result));
+    return true;
+}
+
+JobResult Job::get () { return m_result.get(); }
+
+std::future<JobResult>& Job::get_future () { return m_result; }
+
+Executor::Executor (std::size_t threads) {
+    if (threads == 0) { threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1); }
+    for (std::size_t t = 0; t < threads; ++t) { m_queues.push_back(std::make_unique<WorkQueue>()); }
+    for (std::size_t t = 0; t < threads; ++t) { m_threads.emplace_back(&Executor::work, this, t); }
+}
+
+Executor::~Executor () {
+    m_stopping.store(true);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_all();
+    for (std::thread& thread : m_threads) { thread.join(); }
+}
+
+Job Executor::submit (std::shared_ptr<const script::Program> program, env_initializer initializer, job_inputs inputs, job_priority priority) {
+    if (!program) { throw RuntimeError{"cannot submit a job without a program"}; }
+    std::shared_ptr<JobState> state = std::make_shared<JobState>();
+    state->program = std::move(program);
+    state->initializer = std::move(initializer);
+    state->inputs = std::move(inputs);
+    state->priority = priority;
+    return push(std::move(state));
+}
+
+Job Executor::submit_work (std::function<void ()> work, job_priority priority) {
+    if (!work) { throw RuntimeError{"cannot submit a job without work"}; }
+    std::shared_ptr<JobState> state = std::make_shared<JobState>();
+    state->work = std::move(work);
+    state->priority = priority;
+    return push(std::move(state));
+}
+
+Job Executor::push (std::shared_ptr<JobState> state) {
+    const job_priority priority = state->priority;
+    Job job { state, state->result.get_future() };
+
+    const bool inside = (current_executor == this);
+    const std::size_t target = inside ? current_worker : (m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+    {
+        WorkQueue& queue = *m_queues[target];
+        std::lock_guard<std::mutex> lock { queue.mutex };
+        /* the worker itself continues with the job it just created, it is still warm in its cache */
+        if (inside) { queue.jobs[static_cast<std::size_t>(priority)].push_front(std::move(state)); }
+        else { queue.jobs[static_cast<std::size_t>(priority)].push_back(std::move(state)); }
+        /* counted under the lock, the count is never lower than the jobs a thief may find */
+        m_queued[static_cast<std::size_t>(priority)].fetch_add(1);
+    }
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+    return job;
+}
+
+bool Executor::take (std::size_t self, std::shared_ptr<JobState>& job) {
+    const std::size_t count = m_queues.size();
+    /* a job of a higher priority is taken from any worker before a job of a lower priority */
+    /* a priority without queued jobs is skipped without locking any queue, the own queue is tried before the others */
+    for (std::size_t p = 3; p-- > 0;) {
+        if (m_queued[p].load() == 0) { continue; }
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t index = (self + i) % count;
+            WorkQueue& queue = *m_queues[index];
+            std::lock_guard<std::mutex> lock { queue.mutex };
+            std::deque<std::shared_ptr<JobState>>& jobs = queue.jobs[p];
+            if (jobs.empty()) { continue; }
+            if (index == self) {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            else {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_queued[p].fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::work (std::size_t self) {
+    current_executor = this;
+    current_worker = self;
+    std::shared_ptr<JobState> job;
+    while (true) {
+        /* read before looking for work, a job submitted after the search changes it and the wait returns at once */
+        const std::uint32_t seen = m_signal.load(std::memory_order_acquire);
+        if (take(self, job)) {
+            run(*job);
+            job.reset();
+            continue;
+        }
+        /* the remaining jobs are run before the pool stops */
+        if (m_stopping.load() && std::all_of(m_queued.begin(), m_queued.end(), [] (const std::atomic<std::size_t>& queued) { return queued.load() == 0; })) { break; }
+        m_signal.wait(seen, std::memory_order_acquire);
+    }
+    current_executor = nullptr;
+}
+
+void Executor::run (JobState& job) {
+    int expected = pending;
+    if (!job.state.compare_exchange_strong(expected, running)) {
+        m_cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const std::chrono::nanoseconds start = thread_cpu_time();
+    JobResult result {};
+    std::exception_ptr error {};
+    try {
+        if (job.work) { job.work(); }
+        else {
+            script::EnvStack env {};
+            if (job.initializer) { job.initializer(env); }
+            for (const std::pair<std::string, object::Object>& input : job.inputs) {
+                env.declare_variable(input.first, script::builtin_types::none);
+                env.get_variable(input.first).assign(input.second);
+            }
+            result.exit_code = job.program->execute(env, result.value);
+        }
+    }
+    catch (...) {
+        /* errors of the initializer and of host functions reach the caller through the future */
+        error = std::current_exception();
+    }
+    result.cpu_time = thread_cpu_time() - start;
+    /* the statistics are complete once the caller sees the result */
+    m_cpu_time.fetch_add(result.cpu_time.count(), std::memory_order_relaxed);
+    m_completed.fetch_add(1, std::memory_order_relaxed);
+    job.state = finished;
+    if (error) { job.result.set_exception(error); }
+    else { job.result.set_value(std::move(result)); }
+}
+
+std::size_t Executor::get_thread_count () const { return m_threads.size(); }
+
+bool Executor::run_pending () {
+    Executor* executor = current_executor;
+    if (executor == nullptr) { return false; }
+    const std::size_t self = current_worker;
+    std::shared_ptr<JobState> job;
+    if (!executor->take(self, job)) { return false; }
+    executor->run(*job);
+    return true;
+}
+
+ExecutorStats Executor::get_stats () const {
+    ExecutorStats stats {};
+    stats.submitted = m_submitted.load(std::memory_order_relaxed);
+    stats.completed = m_completed.load(std::memory_order_relaxed);
+    stats.cancelled = m_cancelled.load(std::memory_order_relaxed);
+    stats.steals = m_steals.load(std::memory_order_relaxed);
+    stats.cpu_time = std::chrono::nanoseconds { m_cpu_time.load(std::memory_order_relaxed) };
+    return stats;
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,221 @@
+#include "mlang/runtime/future.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/boolean.hpp"
+#include "mlang/object/assert.hpp"
+#include "mlang/exception.hpp"
+
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <exception>
+
+namespace mlang {
+namespace runtime {
+
+class Future::State {
+public:
+    std::mutex mutex;
+    bool ready { false };
+    object::Object value {};
+    std::optional<std::string> error {};
+    std::deque<Resumer> waiters;
+
+    bool complete (object::Object result, std::optional<std::string> failure) {
+        std::deque<Resumer> parked;
+        {
+            std::lock_guard<std::mutex> lock { mutex };
+            if (ready) { return false; }
+            ready = true;
+            value = std::move(result);
+            error = std::move(failure);
+            parked.swap(waiters);
+        }
+        for (const Resumer& resumer : parked) { resumer.resume(); }
+        return true;
+    }
+};
+
+/* the last copy of a promise breaks the future it did not complete */
+class Promise::Completer {
+public:
+    std::shared_ptr<Future::State> state;
+
+    explicit Completer (std::shared_ptr<Future::State> future_state) : state(std::move(future_state)) {}
+    ~Completer () { state->complete(object::Object {}, std::string { "broken promise, the host call never completed" }); }
+};
+
+Promise::Promise (std::shared_ptr<Completer> completer) : m_completer(std::move(completer)) {}
+
+bool Promise::set_value (object::Object value) const { return m_completer->state->complete(std::move(value), std::nullopt); }
+
+bool Promise::set_error (std::string message) const { return m_completer->state->complete(object::Object {}, std::move(message)); }
+
+Future::Future (std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+Future::State& Future::get_state () const {
+    if (!m_state) { throw RuntimeError{"future is not bound to a host call"}; }
+    return *m_state;
+}
+
+script::type_id Future::define_type () {
+    static const script::type_id id = script::Environment::define_type(type_name, std::make_shared<FutureFactory>());
+    return id;
+}
+
+std::pair<object::Object, Promise> Future::create () {
+    std::shared_ptr<State> state = std::make_shared<State>();
+    Promise promise { std::make_shared<Promise::Completer>(state) };
+    return { object::Object { std::make_shared<Future>(std::move(state)) }, std::move(promise) };
+}
+
+bool Future::is_ready () const {
+    State& state = get_state();
+    std::lock_guard<std::mutex> lock { state.mutex };
+    return state.ready;
+}
+
+object::Object Future::wait () const {
+    State& state = get_state();
+    std::unique_lock<std::mutex> lock { state.mutex };
+    /* on a worker of an executor the host call may be queued behind the waiting job, the worker runs queued jobs first */
+    if (EventLoop::current() == nullptr) {
+        while (!state.ready) {
+            lock.unlock();
+            const bool ran = Executor::run_pending();
+            lock.lock();
+            if (!ran) { break; }
+        }
+    }
+    if (!state.ready) {
+        lock.unlock();
+        suspend([&state] (Resumer resumer) {
+            std::unique_lock<std::mutex> waiting { state.mutex };
+            if (state.ready) {
+                waiting.unlock();
+                resumer.resume();
+                return;
+            }
+            state.waiters.push_back(std::move(resumer));
+        });
+        lock.lock();
+    }
+    if (state.error) { throw RuntimeError{*state.error}; }
+    return state.value;
+}
+
+object::internal_obj_ptr Future::resolved () const { return wait().get_internal(); }
+
+std::string Future::get_typename () const { return type_name; }
+
+const object::ObjectFactory& Future::get_factory () const {
+    static FutureFactory factory{};
+    return factory;
+}
+
+/* construct */
+void Future::construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    throw RuntimeError { "a '" + type_name + "' is created by an asynchronous host function" };
+}
+
+void Future::assign (const std::shared_ptr<object::InternalObject> param) {
+    const std::shared_ptr<Future> future = object::assert_cast<Future>(param, type_name);
+    m_state = future->m_state;
+}
+
+std::shared_ptr<object::InternalObject> Future::call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    if (func.compare("ready") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return std::make_shared<object::Boolean>(is_ready());
+    }
+    else if (func.compare("get") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return resolved();
+    }
+    else {
+        return resolved()->call(func, params);
+    }
+}
+
+std::shared_ptr<object::InternalObject> Future::access (const std::string& member) { return resolved()->access(member); }
+
+bool Future::is_true () const { return resolved()->is_true(); }
+double Future::get_float () const { return resolved()->get_float(); }
+int Future::get_int () const { return resolved()->get_int(); }
+std::string Future::get_string () const { return resolved()->get_string(); }
+void Future::serialize (object::Serializer& serializer) const { resolved()->serialize(serializer); }
+
+std::shared_ptr<object::InternalObject> Future::operator_binary_add (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_binary_add(param); }
+std::shared_ptr<object::InternalObject> Future::operator_binary_sub (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_binary_sub(param); }
+std::shared_ptr<object::InternalObject> Future::operator_binary_mul (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_binary_mul(param); }
+std::shared_ptr<object::InternalObject> Future::operator_binary_div (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_binary_div(param); }
+std::shared_ptr<object::InternalObject> Future::unary_minus () { return resolved()->unary_minus(); }
+std::shared_ptr<object::InternalObject> Future::unary_not () { return resolved()->unary_not(); }
+std::shared_ptr<object::InternalObject> Future::operator_comparison_equal (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_comparison_equal(param); }
+std::shared_ptr<object::InternalObject> Future::operator_comparison_not_equal (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_comparison_not_equal(param); }
+std::shared_ptr<object::InternalObject> Future::operator_greater (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_greater(param); }
+std::shared_ptr<object::InternalObject> Future::operator_less (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_less(param); }
+std::shared_ptr<object::InternalObject> Future::operator_greater_equal (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_greater_equal(param); }
+std::shared_ptr<object::InternalObject> Future::operator_less_equal (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_less_equal(param); }
+/* the result is kept by the future, the reference stays valid */
+object::Object& Future::operator_subscript (const std::shared_ptr<object::InternalObject> param) { return resolved()->operator_subscript(param); }
+
+std::shared_ptr<object::InternalObject> FutureFactory::create () const {
+    return std::make_shared<Future>();
+}
+
+AsyncFunction::AsyncFunction () { Future::define_type(); }
+
+object::Object AsyncFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    /* the work may outlive the variables of the script, it gets its own values */
+    std::vector<object::Object> copies;
+    copies.reserve(params.size());
+    for (const object::Object& param : params) { copies.push_back(param.copy()); }
+    std::pair<object::Object, Promise> future = Future::create();
+    start(std::move(copies), std::move(future.second));
+    return future.first;
+}
+
+OffloadedFunction::OffloadedFunction (Executor& executor, host_call call) : m_executor(executor), m_call(std::move(call)) {}
+
+void OffloadedFunction::start (std::vector<object::Object> params, Promise promise) const {
+    m_executor.submit_work([call = m_call, params = std::move(params), promise] () {
+        try {
+            promise.set_value(call(params));
+        }
+        catch (const RuntimeError& e) {
+            promise.set_error(e.what());
+        }
+        catch (const std::exception& e) {
+            /* e.g. std::bad_alloc or an error of a library the host calls */
+            promise.set_error(e.what());
+        }
+    }, job_priority::high);
+}
+
+object::Object AwaitFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    if (params.size() != 1) { throw RuntimeError{"await expects 1 parameter"}; }
+    /* the output of the script so far is visible while it waits */
+    env.get_output().flush();
+    const object::internal_obj_ptr& value = params[0].get_internal();
+    if (const std::shared_ptr<Future> future = std::dynamic_pointer_cast<Future>(value)) { return future->wait(); }
+    if (const std::shared_ptr<object::Array> array = std::dynamic_pointer_cast<object::Array>(value)) {
+        std::vector<object::Object> results;
+        results.reserve(array->get_elements().size());
+        for (const object::Object& element : array->get_elements()) {
+            const std::shared_ptr<Future> future = std::dynamic_pointer_cast<Future>(element.get_internal());
+            results.push_back(future ? future->wait() : element);
+        }
+        return object::Object { std::make_shared<object::Array>(std::move(results)) };
+    }
+    return params[0];
+}
+
+void declare_future_functions (script::EnvStack& env) {
+    static const AwaitFunction await {};
+    env.declare_function("await", &await);
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,209 @@
+#include "mlang/runtime/parallel.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/exception.hpp"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include <exception>
+#include <functional>
+
+namespace mlang {
+namespace runtime {
+
+namespace {
+
+/* consecutive elements handled by one thread and what the function printed for them */
+struct Chunk {
+    std::size_t begin { 0 };
+    std::size_t end { 0 };
+    std::string output {};
+    object::Object partial {};  /* parallel_reduce */
+};
+
+typedef std::function<void (script::EnvStack& env, const func::Function& function, Chunk& chunk)> chunk_body;
+
+/* smaller chunks cost more in claiming them than they gain in balance */
+constexpr std::size_t min_chunk { 4 };
+
+/* runs 'body' over [0, count) on the calling thread and on as many workers as there is work for */
+/* returns the chunks in order, up to and including the one that failed first, whose error is rethrown afterwards */
+std::vector<Chunk> run_chunks (Executor& executor, script::EnvStack& caller, const std::string& function_name, std::size_t count, const chunk_body& body) {
+    const func::Function& function = *caller.get_function(function_name);
+    /* read once here, the workers must not touch the environment of the caller */
+    const std::map<std::string, const func::Function*, std::less<>> functions = caller.get_functions();
+    const std::size_t threads = executor.get_thread_count() + 1;
+
+    /* the workers share the deadline and the token of the caller and the steps it has left */
+    const script::Budget& limits = caller.get_budget();
+    const bool limited = (limits.max_steps != 0) || limits.deadline || limits.cancel;
+    const std::uint64_t steps_left = (limits.max_steps != 0) ? limits.max_steps - std::min(limits.max_steps, caller.get_steps()) : 0;
+    /* every call of the function is a step, with nothing left the first one exceeds the limit */
+    if ((limits.max_steps != 0) && (steps_left == 0) && (count != 0)) { caller.add_steps(1); }
+    std::atomic<std::uint64_t> steps { 0 };
+
+    std::atomic<std::size_t> cursor { 0 };
+    std::atomic<bool> failed { false };
+    std::mutex mutex;
+    std::vector<Chunk> chunks;
+    std::size_t error_begin { count };
+    std::exception_ptr error {};
+
+    auto work = [&] () {
+        script::EnvStack env {};
+        for (const auto& entry : functions) { env.declare_function(entry.first, entry.second); }
+        std::uint64_t reported = 0;
+        auto report = [&] () {
+            const std::uint64_t total = steps.fetch_add(env.get_steps() - reported) + (env.get_steps() - reported);
+            reported = env.get_steps();
+            return total;
+        };
+        if (limited) {
+            script::Budget budget {};
+            budget.max_steps = steps_left;
+            budget.deadline = limits.deadline;
+            budget.cancel = limits.cancel;
+            budget.check_interval = limits.check_interval;
+            /* every check adds the steps of this worker to the steps of all of them */
+            budget.yield = [&, max_steps = limits.max_steps] () {
+                if ((report() > steps_left) && (max_steps != 0)) {
+                    throw BudgetExceeded{budget_limit::steps, "the script exceeded its limit of " + std::to_string(max_steps) + " steps"};
+                }
+            };
+            env.set_budget(std::move(budget));
+        }
+        std::shared_ptr<script::StringSink> sink = std::make_shared<script::StringSink>();
+        env.set_output(sink, 0);
+        std::vector<Chunk> done;
+        while (!failed.load(std::memory_order_relaxed)) {
+            /* guided scheduling, every claim takes a share of what is left */
+            std::size_t begin = cursor.load(std::memory_order_relaxed);
+            std::size_t size = 0;
+            do {
+                if (begin >= count) { break; }
+                size = std::min(std::max(min_chunk, (count - begin) / (2 * threads)), count - begin);
+            } while (!cursor.compare_exchange_weak(begin, begin + size, std::memory_order_relaxed));
+            if (begin >= count) { break; }
+
+            Chunk chunk { begin, begin + size };
+            try {
+                body(env, function, chunk);
+            }
+            catch (...) {
+                /* the chunks are claimed in order, every chunk before this one runs to its end */
+                std::lock_guard<std::mutex> lock { mutex };
+                if (begin < error_begin) {
+                    error_begin = begin;
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+            chunk.output = sink->get();
+            sink->clear();
+            done.push_back(std::move(chunk));
+        }
+        report();
+        std::lock_guard<std::mutex> lock { mutex };
+        for (Chunk& chunk : done) { chunks.push_back(std::move(chunk)); }
+    };
+
+    std::vector<Job> helpers;
+    const std::size_t helper_count = std::min(executor.get_thread_count(), count / min_chunk);
+    for (std::size_t h = 0; h < helper_count; ++h) { helpers.push_back(executor.submit_work(work, job_priority::high)); }
+    work();
+    /* a helper still queued has nothing left to do, the caller does not wait for a worker to become free */
+    for (Job& helper : helpers) {
+        if (!helper.cancel()) { helper.get(); }
+    }
+
+    std::sort(chunks.begin(), chunks.end(), [] (const Chunk& lhs, const Chunk& rhs) { return lhs.begin < rhs.begin; });
+    if (error) {
+        chunks.erase(std::find_if(chunks.begin(), chunks.end(), [&] (const Chunk& chunk) { return chunk.begin > error_begin; }), chunks.end());
+    }
+    for (const Chunk& chunk : chunks) { caller.get_output().write(chunk.output); }
+    if (error) { std::rethrow_exception(error); }
+    caller.add_steps(steps.load());
+    return chunks;
+}
+
+void assert_params (const std::vector<object::Object>& params, const std::vector<std::string>& types, const std::string& function) {
+    if (params.size() != types.size()) { throw RuntimeError{function + " expects " + std::to_string(types.size()) + " parameter(s)"}; }
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        if (!types[i].empty() && (params[i].get_typename() != types[i])) {
+            throw RuntimeError{function + " expects parameter " + std::to_string(i + 1) + " of type " + types[i]};
+        }
+    }
+}
+
+} /* namespace */
+
+ParallelMapFunction::ParallelMapFunction (Executor& executor) : m_executor(executor) {}
+
+object::Object ParallelMapFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_params(params, { object::Array::type_name, object::String::type_name }, "parallel_map");
+    /* keeps the elements alive while the workers read them */
+    const object::internal_obj_ptr array = params[0].get_internal();
+    const std::vector<object::Object>& elements = static_cast<const object::Array&>(*array).get_elements();
+    std::vector<object::Object> results(elements.size());
+    run_chunks(m_executor, env, params[1].get_string(), elements.size(), [&] (script::EnvStack& worker, const func::Function& function, Chunk& chunk) {
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i) {
+            std::vector<object::Object> args { elements[i] };
+            results[i] = function.call(worker, args);
+        }
+    });
+    return object::Object { std::make_shared<object::Array>(std::move(results)) };
+}
+
+ParallelReduceFunction::ParallelReduceFunction (Executor& executor) : m_executor(executor) {}
+
+object::Object ParallelReduceFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_params(params, { object::Array::type_name, object::String::type_name, "" }, "parallel_reduce");
+    const object::internal_obj_ptr array = params[0].get_internal();
+    const std::vector<object::Object>& elements = static_cast<const object::Array&>(*array).get_elements();
+    const std::string function_name = params[1].get_string();
+    std::vector<Chunk> chunks = run_chunks(m_executor, env, function_name, elements.size(), [&] (script::EnvStack& worker, const func::Function& function, Chunk& chunk) {
+        chunk.partial = elements[chunk.begin];
+        for (std::size_t i = chunk.begin + 1; i < chunk.end; ++i) {
+            std::vector<object::Object> args { chunk.partial, elements[i] };
+            chunk.partial = function.call(worker, args);
+        }
+    });
+    const func::Function& function = *env.get_function(function_name);
+    object::Object result = params[2];
+    for (Chunk& chunk : chunks) {
+        std::vector<object::Object> args { result, chunk.partial };
+        result = function.call(env, args);
+    }
+    return result;
+}
+
+ParallelForFunction::ParallelForFunction (Executor& executor) : m_executor(executor) {}
+
+object::Object ParallelForFunction::call (script::EnvStack& env, std::vector<object::Object>& params) const {
+    assert_params(params, { object::Int::type_name, object::String::type_name }, "parallel_for");
+    const std::size_t count = static_cast<std::size_t>(std::max(params[0].get_int(), 0));
+    run_chunks(m_executor, env, params[1].get_string(), count, [] (script::EnvStack& worker, const func::Function& function, Chunk& chunk) {
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i) {
+            std::vector<object::Object> args { object::Object { std::make_shared<object::Int>(static_cast<int>(i)) } };
+            function.call(worker, args);
+        }
+    });
+    return object::Object {};
+}
+
+ParallelFunctions::ParallelFunctions (Executor& executor) : m_map(executor), m_reduce(executor), m_for(executor) {}
+
+void ParallelFunctions::declare_functions (script::EnvStack& env) const {
+    env.declare_function("parallel_map", &m_map);
+    env.declare_function("parallel_reduce", &m_reduce);
+    env.declare_function("parallel_for", &m_for);
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
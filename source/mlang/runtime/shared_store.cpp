@@ -0,0 +1,481 @@
+#include "mlang/runtime/shared_store.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/float.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/object/boolean.hpp"
+#include "mlang/object/none.hpp"
+#include "mlang/object/assert.hpp"
+#include "mlang/exception.hpp"
+
+#include <array>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+namespace mlang {
+namespace runtime {
+
+namespace {
+
+/* epoch based reclamation of the memory the readers of every store may still be using */
+/* a reader announces the epoch it started in, the epoch only advances once every active reader announced the current one */
+/* memory unlinked while the epoch was e is freed once the epoch reached e + 2, no reader can see it anymore */
+/* every thread collects what it retired itself, without a lock, after every 'collect_interval' retirements */
+class Epochs {
+private:
+    struct alignas(64) Record {
+        std::atomic<std::uint64_t> announced { 0 };    /* 2 * epoch + 1 while reading, 0 otherwise */
+        std::atomic<bool> in_use { true };
+        Record* next { nullptr };
+        /* only used by the thread owning the record, what is left when it exits goes to the next owner */
+        std::vector<std::pair<std::uint64_t, std::function<void ()>>> retired;
+    };
+
+    static constexpr std::size_t collect_interval { 64 };
+
+    /* a thread releases its record when it exits, the next new thread reuses it */
+    class Owner {
+    public:
+        Record* record;
+
+        explicit Owner (Epochs& epochs) : record(epochs.acquire()) {}
+        ~Owner () { record->in_use.store(false, std::memory_order_release); }
+    };
+
+    std::atomic<std::uint64_t> m_epoch { 1 };
+    std::atomic<Record*> m_records { nullptr };    /* only grows */
+
+    Record* acquire () {
+        for (Record* record = m_records.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            bool in_use = false;
+            if (!record->in_use.load(std::memory_order_relaxed) && record->in_use.compare_exchange_strong(in_use, true)) { return record; }
+        }
+        Record* record = new Record {};
+        record->next = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {}
+        return record;
+    }
+
+    Record& get_record () {
+        thread_local Owner owner { *this };
+        return *owner.record;
+    }
+
+    /* several threads may try at once, only one of them advances the epoch */
+    void try_advance () {
+        std::uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (Record* record = m_records.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            const std::uint64_t announced = record->announced.load(std::memory_order_acquire);
+            if ((announced & 1) != 0 && (announced >> 1) != epoch) { return; }
+        }
+        m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void collect (Record& record) {
+        try_advance();
+        const std::uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        const auto pending = std::partition(record.retired.begin(), record.retired.end(), [epoch] (const std::pair<std::uint64_t, std::function<void ()>>& retired) {
+            return retired.first + 2 <= epoch;
+        });
+        std::vector<std::function<void ()>> ready;
+        for (auto it = record.retired.begin(); it != pending; ++it) { ready.push_back(std::move(it->second)); }
+        record.retired.erase(record.retired.begin(), pending);
+        for (const std::function<void ()>& release_memory : ready) { release_memory(); }
+    }
+public:
+    Epochs () = default;
+    ~Epochs () {
+        for (Record* record = m_records.load(); record != nullptr;) {
+            for (std::pair<std::uint64_t, std::function<void ()>>& retired : record->retired) { retired.second(); }
+            Record* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    static Epochs& instance () {
+        static Epochs epochs {};
+        return epochs;
+    }
+
+    /* the memory retired while a reader exists stays valid, a reader must not wait or suspend */
+    class Reader {
+    private:
+        Record& m_record;
+    public:
+        Reader () : m_record(instance().get_record()) {
+            m_record.announced.store(2 * instance().m_epoch.load(std::memory_order_acquire) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        ~Reader () { m_record.announced.store(0, std::memory_order_release); }
+        Reader (const Reader&) = delete;
+        Reader& operator= (const Reader&) = delete;
+    };
+
+    /* 'release' runs once no reader can reach the memory anymore, call it after the memory was unlinked and outside of any lock */
+    void retire (std::function<void ()> release) {
+        Record& record = get_record();
+        record.retired.emplace_back(m_epoch.load(std::memory_order_seq_cst), std::move(release));
+        if (record.retired.size() % collect_interval == 0) { collect(record); }
+    }
+};
+
+/* a copy that shares nothing with 'value', built without touching the reference counts of 'value' */
+/* the stored values are read by many threads at once, they stay immutable */
+object::Object duplicate (const object::Object& value) {
+    const object::InternalObject* internal = value.get_internal().get();
+    if (const object::Int* integer = dynamic_cast<const object::Int*>(internal)) { return object::Object { std::make_shared<object::Int>(integer->get_int()) }; }
+    if (const object::Float* number = dynamic_cast<const object::Float*>(internal)) { return object::Object { std::make_shared<object::Float>(number->get_float()) }; }
+    if (const object::String* string = dynamic_cast<const object::String*>(internal)) { return object::Object { std::make_shared<object::String>(std::string { string->view() }) }; }
+    if (const object::Boolean* boolean = dynamic_cast<const object::Boolean*>(internal)) { return object::Object { std::make_shared<object::Boolean>(boolean->is_true()) }; }
+    if (dynamic_cast<const object::None*>(internal) != nullptr) { return object::Object {}; }
+    if (const object::Array* array = dynamic_cast<const object::Array*>(internal)) {
+        std::vector<object::Object> elements;
+        elements.reserve(array->get_elements().size());
+        for (const object::Object& element : array->get_elements()) { elements.push_back(duplicate(element)); }
+        return object::Object { std::make_shared<object::Array>(std::move(elements)) };
+    }
+    /* any other type keeps its own copy semantics, e.g. a channel stays shared */
+    return value.copy();
+}
+
+std::string_view key_of (const std::shared_ptr<object::InternalObject>& param) {
+    return object::assert_cast<object::String>(param, object::String::type_name)->view();
+}
+
+std::uint64_t version_of (const std::shared_ptr<object::InternalObject>& param) {
+    const int version = param->get_int();
+    if (version < 0) { throw RuntimeError{"the version of a key cannot be negative"}; }
+    return static_cast<std::uint64_t>(version);
+}
+
+/* a script sees versions as Int, a version past the range of an Int is an error instead of a wrapped value */
+std::shared_ptr<object::InternalObject> int_of_version (std::string_view key, std::uint64_t version) {
+    if (version > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+        throw RuntimeError{"the version of key '" + std::string { key } + "' does not fit an Int anymore"};
+    }
+    return std::make_shared<object::Int>(static_cast<int>(version));
+}
+
+} /* namespace */
+
+/* a hash table whose buckets are immutable chains of nodes */
+/* a writer locks the stripe of the bucket, builds a new chain and publishes it, readers follow the chain they loaded */
+/* every write increments the version of its key, a removed key loses its node and its stripe keeps the highest version it removed */
+/* a key that is set again starts after that version, so it never gives back a version it had */
+class SharedStore::State {
+public:
+    struct Node {
+        std::string key;
+        std::uint64_t version;
+        object::Object value;
+        const Node* next;
+    };
+
+    struct Table {
+        std::size_t mask;
+        std::unique_ptr<std::atomic<const Node*>[]> buckets;
+
+        explicit Table (std::size_t count) : mask(count - 1), buckets(std::make_unique<std::atomic<const Node*>[]>(count)) {}
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        /* the watchers of the keys of the stripe, a write takes the watchers of its key only */
+        std::map<std::string, std::vector<Resumer>, std::less<>> watchers;
+        std::uint64_t removed_version { 0 };    /* the highest version of a key removed from the stripe */
+    };
+
+    /* a power of two, every bucket belongs to one stripe */
+    static constexpr std::size_t stripe_count { 32 };
+
+    std::atomic<Table*> table;
+    std::array<Stripe, stripe_count> stripes;
+    std::atomic<std::size_t> size { 0 };
+
+    State () : table(new Table { 2 * stripe_count }) {}
+    ~State () {
+        Table* current = table.load();
+        for (std::size_t i = 0; i <= current->mask; ++i) { delete_chain(current->buckets[i].load()); }
+        delete current;
+    }
+
+    static std::size_t hash (std::string_view key) { return std::hash<std::string_view>{}(key); }
+
+    static const Node* find (const Node* node, std::string_view key) {
+        while (node != nullptr && node->key != key) { node = node->next; }
+        return node;
+    }
+
+    static void delete_chain (const Node* node) {
+        while (node != nullptr) {
+            const Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    /* the nodes of the chain except 'skip', in the same order */
+    static const Node* copy_chain (const Node* head, const Node* skip) {
+        std::vector<const Node*> kept;
+        for (const Node* node = head; node != nullptr; node = node->next) {
+            if (node != skip) { kept.push_back(node); }
+        }
+        const Node* copy = nullptr;
+        for (auto it = kept.rbegin(); it != kept.rend(); ++it) { copy = new Node { (*it)->key, (*it)->version, (*it)->value, copy }; }
+        return copy;
+    }
+
+    /* 'read' gets the node of the key or nullptr, it runs without any lock and must not wait */
+    template <typename Read>
+    auto read (std::string_view key, Read read) const {
+        const std::size_t key_hash = hash(key);
+        Epochs::Reader reader {};
+        const Table& current = *table.load(std::memory_order_acquire);
+        return read(find(current.buckets[key_hash & current.mask].load(std::memory_order_acquire), key));
+    }
+
+    /* 'decide' gets the node of the key or nullptr and returns the new value, none removes the key, nothing leaves the key as it is */
+    /* returns the new version of the key if it was written, 0 if it was removed */
+    template <typename Decide>
+    std::optional<std::uint64_t> write (std::string_view key, Decide decide) {
+        const std::size_t key_hash = hash(key);
+        std::optional<std::uint64_t> version {};
+        std::size_t grow_from = 0;
+        const Node* unlinked = nullptr;
+        std::vector<Resumer> watchers;
+        {
+            Stripe& stripe = stripes[key_hash % stripe_count];
+            std::lock_guard<std::mutex> lock { stripe.mutex };
+            /* the table is only replaced while every stripe is locked */
+            Table& current = *table.load(std::memory_order_relaxed);
+            std::atomic<const Node*>& bucket = current.buckets[key_hash & current.mask];
+            const Node* head = bucket.load(std::memory_order_relaxed);
+            const Node* node = find(head, key);
+            std::optional<object::Object> value = decide(node);
+            if (!value) { return std::nullopt; }
+            if (value->is_none()) {
+                if (node == nullptr) { return std::nullopt; }
+                bucket.store(copy_chain(head, node), std::memory_order_release);
+                stripe.removed_version = std::max(stripe.removed_version, node->version);
+                size.fetch_sub(1, std::memory_order_relaxed);
+                version = 0;
+            }
+            else {
+                /* the writers of a key hold the same stripe lock, its versions only grow */
+                version = ((node != nullptr) ? node->version : stripe.removed_version) + 1;
+                bucket.store(new Node { std::string { key }, *version, std::move(*value), copy_chain(head, node) }, std::memory_order_release);
+                if (node == nullptr && size.fetch_add(1, std::memory_order_relaxed) + 1 > current.mask + 1) { grow_from = current.mask + 1; }
+            }
+            unlinked = head;
+            const auto watched = stripe.watchers.find(key);
+            if (watched != stripe.watchers.end()) {
+                watchers = std::move(watched->second);
+                stripe.watchers.erase(watched);
+            }
+        }
+        if (unlinked != nullptr) { Epochs::instance().retire([unlinked] () { delete_chain(unlinked); }); }
+        for (const Resumer& resumer : watchers) { resumer.resume(); }
+        if (grow_from != 0) { grow(grow_from); }
+        return version;
+    }
+
+    /* doubles the buckets once there are more keys than buckets */
+    void grow (std::size_t bucket_count) {
+        Table* old = nullptr;
+        {
+            std::array<std::unique_lock<std::mutex>, stripe_count> locks;
+            for (std::size_t i = 0; i < stripe_count; ++i) { locks[i] = std::unique_lock<std::mutex> { stripes[i].mutex }; }
+            old = table.load(std::memory_order_relaxed);
+            if (old->mask + 1 != bucket_count) { return; }
+            Table* grown = new Table { 2 * bucket_count };
+            for (std::size_t i = 0; i <= old->mask; ++i) {
+                for (const Node* node = old->buckets[i].load(std::memory_order_relaxed); node != nullptr; node = node->next) {
+                    std::atomic<const Node*>& bucket = grown->buckets[hash(node->key) & grown->mask];
+                    bucket.store(new Node { node->key, node->version, node->value, bucket.load(std::memory_order_relaxed) }, std::memory_order_relaxed);
+                }
+            }
+            table.store(grown, std::memory_order_release);
+        }
+        Epochs::instance().retire([old] () {
+            for (std::size_t i = 0; i <= old->mask; ++i) { delete_chain(old->buckets[i].load()); }
+            delete old;
+        });
+    }
+
+    std::uint64_t get_version (std::string_view key) const {
+        return read(key, [] (const Node* node) -> std::uint64_t { return (node != nullptr) ? node->version : 0; });
+    }
+
+    /* parks the caller until the version of the key is not 'version' anymore */
+    /* the version is checked again under the stripe lock before the watcher is queued, a write of the key takes the same lock */
+    std::uint64_t watch (std::string_view key, std::uint64_t version) {
+        const std::size_t key_hash = hash(key);
+        std::uint64_t current = get_version(key);
+        while (current == version) {
+            suspend([&] (Resumer resumer) {
+                Stripe& stripe = stripes[key_hash % stripe_count];
+                std::unique_lock<std::mutex> lock { stripe.mutex };
+                const Table& latest = *table.load(std::memory_order_relaxed);
+                const Node* node = find(latest.buckets[key_hash & latest.mask].load(std::memory_order_relaxed), key);
+                if (((node != nullptr) ? node->version : 0) != version) {
+                    lock.unlock();
+                    resumer.resume();
+                    return;
+                }
+                auto watched = stripe.watchers.find(key);
+                if (watched == stripe.watchers.end()) { watched = stripe.watchers.emplace(std::string { key }, std::vector<Resumer> {}).first; }
+                watched->second.push_back(std::move(resumer));
+            });
+            current = get_version(key);
+        }
+        return current;
+    }
+};
+
+namespace {
+
+/* the named stores live as long as the process, a script may open one again at any time */
+std::shared_ptr<SharedStore::State> open_store (std::string_view name) {
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<SharedStore::State>, std::less<>> stores;
+    std::lock_guard<std::mutex> lock { mutex };
+    auto it = stores.find(name);
+    if (it == stores.end()) { it = stores.emplace(std::string { name }, std::make_shared<SharedStore::State>()).first; }
+    return it->second;
+}
+
+} /* namespace */
+
+SharedStore::SharedStore (std::string_view name) : m_state(open_store(name)) {}
+
+SharedStore::State& SharedStore::get_state () const {
+    if (!m_state) { throw RuntimeError{"shared store is not constructed"}; }
+    return *m_state;
+}
+
+script::type_id SharedStore::define_type () {
+    static const script::type_id id = script::Environment::define_type(type_name, std::make_shared<SharedStoreFactory>());
+    return id;
+}
+
+std::shared_ptr<SharedStore> SharedStore::create () {
+    std::shared_ptr<SharedStore> store = std::make_shared<SharedStore>();
+    store->m_state = std::make_shared<State>();
+    return store;
+}
+
+object::Object SharedStore::get (std::string_view key) const {
+    return get_state().read(key, [] (const State::Node* node) { return (node != nullptr) ? duplicate(node->value) : object::Object {}; });
+}
+
+std::uint64_t SharedStore::get_version (std::string_view key) const { return get_state().get_version(key); }
+
+std::uint64_t SharedStore::set (std::string_view key, const object::Object& value) {
+    if (value.is_none()) { throw RuntimeError{"none cannot be stored, remove the key instead"}; }
+    object::Object copy = duplicate(value);
+    return *get_state().write(key, [&copy] (const State::Node*) { return std::optional<object::Object> { copy }; });
+}
+
+bool SharedStore::compare_and_set (std::string_view key, std::uint64_t version, const object::Object& value) {
+    if (value.is_none()) { throw RuntimeError{"none cannot be stored, remove the key instead"}; }
+    object::Object copy = duplicate(value);
+    return get_state().write(key, [&copy, version] (const State::Node* node) {
+        const std::uint64_t current = (node != nullptr) ? node->version : 0;
+        return (current == version) ? std::optional<object::Object> { copy } : std::nullopt;
+    }).has_value();
+}
+
+bool SharedStore::remove (std::string_view key) {
+    return get_state().write(key, [] (const State::Node*) { return std::optional<object::Object> { object::Object {} }; }).has_value();
+}
+
+std::uint64_t SharedStore::watch (std::string_view key, std::uint64_t version) const { return get_state().watch(key, version); }
+
+std::size_t SharedStore::get_size () const { return get_state().size.load(std::memory_order_relaxed); }
+
+std::string SharedStore::get_typename () const { return type_name; }
+
+const object::ObjectFactory& SharedStore::get_factory () const {
+    static SharedStoreFactory factory{};
+    return factory;
+}
+
+/* construct, a private store without a name */
+void SharedStore::construct (const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    if (params.empty()) {
+        m_state = std::make_shared<State>();
+        return;
+    }
+    object::assert_params(params, 1, type_name, "constructor");
+    m_state = open_store(key_of(params[0]));
+}
+
+/* assign, both objects refer to the same store */
+void SharedStore::assign (const std::shared_ptr<object::InternalObject> param) {
+    const std::shared_ptr<SharedStore> store = object::assert_cast<SharedStore>(param, type_name);
+    m_state = store->m_state;
+}
+
+std::shared_ptr<object::InternalObject> SharedStore::call (const std::string& func, const std::vector<std::shared_ptr<object::InternalObject>>& params) {
+    if (func.compare("get") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        return get(key_of(params[0])).get_internal();
+    }
+    else if (func.compare("set") == 0) {
+        object::assert_params(params, 2, type_name, func);
+        const std::string_view key = key_of(params[0]);
+        return int_of_version(key, set(key, object::Object { params[1] }));
+    }
+    else if (func.compare("version") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        const std::string_view key = key_of(params[0]);
+        return int_of_version(key, get_version(key));
+    }
+    else if (func.compare("compare_and_set") == 0) {
+        object::assert_params(params, 3, type_name, func);
+        return std::make_shared<object::Boolean>(compare_and_set(key_of(params[0]), version_of(params[1]), object::Object { params[2] }));
+    }
+    else if (func.compare("remove") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        return std::make_shared<object::Boolean>(remove(key_of(params[0])));
+    }
+    else if (func.compare("watch") == 0) {
+        object::assert_params(params, 2, type_name, func);
+        const std::string_view key = key_of(params[0]);
+        return int_of_version(key, watch(key, version_of(params[1])));
+    }
+    else if (func.compare("has") == 0) {
+        object::assert_params(params, 1, type_name, func);
+        return std::make_shared<object::Boolean>(get_state().read(key_of(params[0]), [] (const State::Node* node) { return node != nullptr; }));
+    }
+    else if (func.compare("length") == 0) {
+        object::assert_params(params, 0, type_name, func);
+        return std::make_shared<object::Int>(static_cast<int>(get_size()));
+    }
+    else {
+        throw RuntimeError { "object of type '" + type_name + "' has no '" + func + "' member function" };
+    }
+}
+
+std::shared_ptr<object::InternalObject> SharedStore::access (const std::string& member) {
+    throw RuntimeError { "object of type '" + type_name + "' has no '" + member + "' member" };
+}
+
+std::string SharedStore::get_string () const { return type_name; }
+
+std::shared_ptr<object::InternalObject> SharedStoreFactory::create () const {
+    return std::make_shared<SharedStore>();
+}
+
+} /* namespace runtime */
+} /* namespace mlang */
@@ -0,0 +1,112 @@
+#include "mlang/script/batch.hpp"
+#include "mlang/exception.hpp"
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <memory>
+#include <algorithm>
+
+namespace mlang {
+namespace script {
+
+namespace {
+
+/* the owner takes files from the front, thieves from the back, so they meet as late as possible */
+class WorkQueue {
+private:
+    std::mutex m_mutex;
+    std::deque<std::size_t> m_items;
+public:
+    void push (std::size_t item) { m_items.push_back(item); }
+
+    bool pop (std::size_t& item) {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (m_items.empty()) { return false; }
+        item = m_items.front();
+        m_items.pop_front();
+        return true;
+    }
+
+    bool steal (std::size_t& item) {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (m_items.empty()) { return false; }
+        item = m_items.back();
+        m_items.pop_back();
+        return true;
+    }
+};
+
+void compile_file (CompileResult& result) {
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        Script script = Script::from_file(result.path);
+        script.compile();
+        result.script.emplace(std::move(script));
+    }
+    catch (const SyntaxError& e) {
+        result.error = e.what();
+    }
+    catch (const RuntimeError& e) {
+        result.error = e.what();
+    }
+    result.duration = std::chrono::steady_clock::now() - start;
+}
+
+} /* namespace */
+
+CompileBatch compile_all (const std::vector<std::string>& paths, std::size_t threads, compile_progress progress) {
+    const auto start = std::chrono::steady_clock::now();
+    CompileBatch batch {};
+    batch.results.resize(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) { batch.results[i].path = paths[i]; }
+
+    if (threads == 0) { threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1); }
+    threads = std::max<std::size_t>(std::min(threads, paths.size()), 1);
+
+    /* contiguous ranges, neighbouring files of one directory tend to be of similar size */
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (std::size_t t = 0; t < threads; ++t) { queues.push_back(std::make_unique<WorkQueue>()); }
+    for (std::size_t i = 0; i < paths.size(); ++i) { queues[i * threads / paths.size()]->push(i); }
+
+    std::mutex progress_mutex;
+    std::size_t done = 0;
+    std::size_t steals = 0;
+    auto worker = [&] (std::size_t self) {
+        std::size_t stolen = 0;
+        std::size_t item = 0;
+        while (true) {
+            bool found = queues[self]->pop(item);
+            for (std::size_t other = 1; !found && other < threads; ++other) {
+                found = queues[(self + other) % threads]->steal(item);
+                if (found) { ++stolen; }
+            }
+            /* nothing is added once the threads run, every queue is empty */
+            if (!found) { break; }
+            compile_file(batch.results[item]);
+            std::lock_guard<std::mutex> lock { progress_mutex };
+            ++done;
+            if (progress) { progress(done, paths.size(), batch.results[item]); }
+        }
+        std::lock_guard<std::mutex> lock { progress_mutex };
+        steals += stolen;
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads; ++t) { pool.emplace_back(worker, t); }
+    worker(0);
+    for (std::thread& thread : pool) { thread.join(); }
+
+    batch.stats.files = paths.size();
+    batch.stats.threads = threads;
+    batch.stats.steals = steals;
+    for (const CompileResult& result : batch.results) {
+        if (!result.script) { ++batch.stats.failed; }
+        batch.stats.compile_time += result.duration;
+    }
+    batch.stats.wall_time = std::chrono::steady_clock::now() - start;
+    return batch;
+}
+
+} /* namespace script */
+} /* namespace mlang */
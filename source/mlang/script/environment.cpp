@@ -1,6 +1,8 @@
 #include "mlang/script/environment.hpp"
 #include "mlang/exception.hpp"
 
+#include <algorithm>
+
 namespace mlang {
 namespace script {
 
@@ -12,74 +14,92 @@ void Environment::reset () {
     m_parent = nullptr;
 }
 
-bool Environment::has_type (const std::string& type_name) {
-    if (m_types.count(type_name) != 0) { return true; }
-    else { return false; }
-}
+bool Environment::has_type (std::string_view type_name) { return TypeRegistry::instance().has(type_name); }
 
-void Environment::define_type (const std::string& type_name, std::shared_ptr<object::ObjectFactory> factory) {
-    if (has_type(type_name)) { throw RuntimeError{"type '" + type_name + "' already exists"}; }
-    m_types[type_name] = factory;
+type_id Environment::define_type (std::string_view type_name, std::shared_ptr<object::ObjectFactory> factory) {
+    return TypeRegistry::instance().define(type_name, std::move(factory));
 }
 
-const object::ObjectFactory& Environment::get_factory (const std::string& type) {
-    if (m_types.count(type) == 0) { throw RuntimeError{"type '" + type + "' is unknown"}; }
-    return *(m_types[type]);
-}
+type_id Environment::find_type (std::string_view type_name) { return TypeRegistry::instance().find(type_name); }
+
+const object::ObjectFactory& Environment::get_factory (std::string_view type) { return TypeRegistry::instance().get_factory(type); }
+
+const object::ObjectFactory& Environment::get_factory (type_id type) { return TypeRegistry::instance().get_factory(type); }
 
-bool Environment::has_variable (const std::string& variable_name) const {
-    if (m_variables.count(variable_name) != 0) { return true; }
+bool Environment::has_variable (std::string_view variable_name) const {
+    if (m_variables.find(variable_name) != m_variables.end()) { return true; }
     else if (m_parent != nullptr) { return m_parent->has_variable(variable_name); }
     else { return false; }
 }
 
-void Environment::declare_variable (const std::string& variable_name, const std::string& type) {
-    if (m_types.count(type) == 0) {
-        throw RuntimeError{"type '" + type + "' is unknown"};
+void Environment::declare_variable (std::string_view variable_name, std::string_view type) {
+    const type_id id = find_type(type);
+    if (id == unknown_type) {
+        throw RuntimeError{"type '" + std::string { type } + "' is unknown"};
     }
+    declare_variable(variable_name, id);
+}
+
+void Environment::declare_variable (std::string_view variable_name, type_id type) {
+    const object::ObjectFactory& factory = get_factory(type);
     if (has_variable(variable_name)) {
-        throw RuntimeError{"variable '" + variable_name + "' already exists"};
+        throw RuntimeError{"variable '" + std::string { variable_name } + "' already exists"};
     }
-    m_variables[variable_name] = object::Object{m_types[type]->create()};
+    m_variables.emplace(variable_name, object::Object{factory.create()});
 }
 
-object::Object& Environment::get_variable (const std::string& variable_name) {
-    if (m_variables.count(variable_name) != 0) {
-        return m_variables[variable_name];
+object::Object& Environment::get_variable (std::string_view variable_name) {
+    auto it = m_variables.find(variable_name);
+    if (it != m_variables.end()) {
+        return it->second;
     }
     else if (m_parent != nullptr) {
         return m_parent->get_variable(variable_name);
     }
     else {
-        throw RuntimeError{"variable '" + variable_name + "' does not exists"};
+        throw RuntimeError{"variable '" + std::string { variable_name } + "' does not exists"};
     }
 }
 
-bool Environment::has_function (const std::string& function_name) const {
-    if (m_functions.count(function_name) != 0) { return true; }
+bool Environment::has_function (std::string_view function_name) const {
+    if (m_functions.find(function_name) != m_functions.end()) { return true; }
     else if (m_parent != nullptr) { return m_parent->has_function(function_name); }
     else { return false; }
 }
 
-void Environment::declare_function (const std::string& function_name, const func::Function* function) {
+void Environment::declare_function (std::string_view function_name, const func::Function* function) {
     if (has_function(function_name)) {
-        throw RuntimeError{"function '" + function_name + "' already exists"};
+        throw RuntimeError{"function '" + std::string { function_name } + "' already exists"};
     }
-    m_functions[function_name] = function;
+    m_functions.emplace(function_name, function);
 }
 
-const func::Function* Environment::get_function (const std::string& function_name) {
-    if (m_functions.count(function_name) != 0) {
-        return m_functions[function_name];
+const func::Function* Environment::get_function (std::string_view function_name) {
+    auto it = m_functions.find(function_name);
+    if (it != m_functions.end()) {
+        return it->second;
     }
     else if (m_parent != nullptr) {
         return m_parent->get_function(function_name);
     }
     else {
-        throw RuntimeError{"function '" + function_name + "' does not exists"};
+        throw RuntimeError{"function '" + std::string { function_name } + "' does not exists"};
     }
 }
 
+bool Environment::remove_function (std::string_view function_name) {
+    auto it = m_functions.find(function_name);
+    if (it == m_functions.end()) { return false; }
+    m_functions.erase(it);
+    return true;
+}
+
+void Environment::collect_functions (std::map<std::string, const func::Function*, std::less<>>& functions) const {
+    /* the inner declaration shadows the outer one */
+    for (const auto& function : m_functions) { functions.insert(function); }
+    if (m_parent != nullptr) { m_parent->collect_functions(functions); }
+}
+
 
 
 
@@ -90,6 +110,11 @@ EnvStack::EnvStack () {
     m_env_stack.push(std::make_unique<Environment>());
 }
 
+void EnvStack::clear () {
+    while (!m_env_stack.empty()) { m_env_stack.pop(); }
+    m_env_stack.push(std::make_unique<Environment>());
+}
+
 void EnvStack::enter_scope () {
     m_env_stack.push(std::make_unique<Environment>(m_env_stack.top().get()));
 }
@@ -98,29 +123,102 @@ void EnvStack::exit_scope () {
     m_env_stack.pop();
 }
 
-bool EnvStack::has_variable (const std::string& variable_name) const {
+std::size_t EnvStack::get_depth () const { return m_env_stack.size(); }
+
+void EnvStack::unwind (std::size_t depth) {
+    while (m_env_stack.size() > std::max<std::size_t>(depth, 1)) { m_env_stack.pop(); }
+}
+
+void EnvStack::set_budget (Budget budget) {
+    m_budget = std::move(budget);
+    if (m_budget.check_interval == 0) { m_budget.check_interval = 1; }
+    m_steps = 0;
+    start_slice();
+}
+
+const Budget& EnvStack::get_budget () const { return m_budget; }
+
+std::uint64_t EnvStack::get_steps () const { return m_steps + (m_slice - m_countdown); }
+
+void EnvStack::add_steps (std::uint64_t steps) {
+    m_steps += steps + (m_slice - m_countdown);
+    m_countdown = m_slice;
+    check_steps();
+    start_slice();
+}
+
+void EnvStack::start_slice () {
+    const bool limited = (m_budget.max_steps != 0) || m_budget.deadline || m_budget.cancel || m_budget.yield;
+    std::uint64_t slice = limited ? m_budget.check_interval : std::numeric_limits<std::uint32_t>::max();
+    /* the slice ends exactly on the first step over the limit */
+    if ((m_budget.max_steps != 0) && (m_budget.max_steps >= m_steps)) { slice = std::min<std::uint64_t>(slice, m_budget.max_steps + 1 - m_steps); }
+    m_slice = static_cast<std::uint32_t>(slice);
+    m_countdown = m_slice;
+}
+
+void EnvStack::check_steps () const {
+    if ((m_budget.max_steps != 0) && (m_steps > m_budget.max_steps)) {
+        throw BudgetExceeded{budget_limit::steps, "the script exceeded its limit of " + std::to_string(m_budget.max_steps) + " steps"};
+    }
+}
+
+void EnvStack::check_budget () {
+    m_steps += m_slice;
+    m_countdown = m_slice;
+    if (m_budget.yield) { m_budget.yield(); }
+    check_steps();
+    if (m_budget.cancel && m_budget.cancel->is_cancelled()) {
+        throw BudgetExceeded{budget_limit::cancelled, "the script was cancelled"};
+    }
+    if (m_budget.deadline && (std::chrono::steady_clock::now() >= *m_budget.deadline)) {
+        throw BudgetExceeded{budget_limit::deadline, "the script exceeded its deadline"};
+    }
+    start_slice();
+}
+
+bool EnvStack::has_variable (std::string_view variable_name) const {
     return m_env_stack.top()->has_variable(variable_name);
 }
 
-void EnvStack::declare_variable (const std::string& variable_name, const std::string& type) {
+void EnvStack::declare_variable (std::string_view variable_name, std::string_view type) {
     m_env_stack.top()->declare_variable(variable_name, type);
 }
 
-object::Object& EnvStack::get_variable (const std::string& variable_name) {
+void EnvStack::declare_variable (std::string_view variable_name, type_id type) {
+    m_env_stack.top()->declare_variable(variable_name, type);
+}
+
+object::Object& EnvStack::get_variable (std::string_view variable_name) {
     return m_env_stack.top()->get_variable(variable_name);
 }
 
-bool EnvStack::has_function (const std::string& function_name) const {
+bool EnvStack::has_function (std::string_view function_name) const {
     return m_env_stack.top()->has_function(function_name);
 }
 
-void EnvStack::declare_function (const std::string& function_name, const func::Function* function) {
+void EnvStack::declare_function (std::string_view function_name, const func::Function* function) {
     m_env_stack.top()->declare_function(function_name, function);
 }
 
-const func::Function* EnvStack::get_function (const std::string& function_name) {
+const func::Function* EnvStack::get_function (std::string_view function_name) {
     return m_env_stack.top()->get_function(function_name);
 }
 
+bool EnvStack::remove_function (std::string_view function_name) {
+    return m_env_stack.top()->remove_function(function_name);
+}
+
+std::map<std::string, const func::Function*, std::less<>> EnvStack::get_functions () const {
+    std::map<std::string, const func::Function*, std::less<>> functions;
+    m_env_stack.top()->collect_functions(functions);
+    return functions;
+}
+
+Output& EnvStack::get_output () { return m_output; }
+
+void EnvStack::set_output (std::shared_ptr<OutputSink> sink, std::size_t capacity) {
+    m_output.reset(std::move(sink), capacity);
+}
+
 } /* namespace script */
 } /* namespace mlang */
\ No newline at end of file
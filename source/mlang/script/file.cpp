@@ -0,0 +1,112 @@
+#include "mlang/script/file.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/exception.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mlang {
+namespace script {
+
+namespace {
+
+/* closes the descriptor on every path out of MappedFile's constructor */
+class FileDescriptor {
+private:
+    int m_fd { -1 };
+public:
+    FileDescriptor (int fd) : m_fd(fd) {}
+    FileDescriptor (const FileDescriptor&) = delete;
+    FileDescriptor& operator= (const FileDescriptor&) = delete;
+    ~FileDescriptor () { if (m_fd >= 0) { ::close(m_fd); } }
+    int get () const { return m_fd; }
+};
+
+void read_all (int fd, const std::string& path, std::string& buffer) {
+    constexpr std::size_t chunk_size { 1 << 16 };
+    std::size_t used = buffer.size();
+    while (true) {
+        buffer.resize(used + chunk_size);
+        const ssize_t count = ::read(fd, buffer.data() + used, chunk_size);
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            throw RuntimeError { "could not read file '" + path + "'" };
+        }
+        if (count == 0) { break; }
+        used += static_cast<std::size_t>(count);
+    }
+    buffer.resize(used);
+}
+
+std::string get_path_param (const std::vector<object::Object>& params, const std::string& func_name) {
+    if (params.size() != 1) { throw RuntimeError { "function '" + func_name + "' expects 1 parameter" }; }
+    if (params[0].get_typename() != object::String::type_name) {
+        throw RuntimeError { "function '" + func_name + "' expects the 1st parameter to be of type " + object::String::type_name };
+    }
+    return params[0].get_string();
+}
+
+} /* namespace */
+
+MappedFile::MappedFile (const std::string& path) : m_path(path) {
+    FileDescriptor fd { ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (fd.get() < 0) {
+        throw RuntimeError { "could not open file '" + path + "'" };
+    }
+    struct stat info {};
+    if (::fstat(fd.get(), &info) != 0) {
+        throw RuntimeError { "could not read file '" + path + "'" };
+    }
+    /* an empty file cannot be mapped, a size of 0 also marks most special files */
+    if (S_ISREG(info.st_mode) && (info.st_size > 0)) {
+        void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (mapping != MAP_FAILED) {
+            m_mapping = mapping;
+            m_size = static_cast<std::size_t>(info.st_size);
+            ::madvise(m_mapping, m_size, MADV_SEQUENTIAL);
+            m_text = std::string_view { static_cast<const char*>(m_mapping), m_size };
+            return;
+        }
+    }
+    read_all(fd.get(), path, m_buffer);
+    m_text = m_buffer;
+}
+
+MappedFile::~MappedFile () {
+    if (m_mapping != nullptr) { ::munmap(m_mapping, m_size); }
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open (const std::string& path) {
+    return std::shared_ptr<const MappedFile> { new MappedFile { path } };
+}
+
+std::string_view MappedFile::get_text () const { return m_text; }
+
+const std::string& MappedFile::get_path () const { return m_path; }
+
+bool MappedFile::is_mapped () const { return m_mapping != nullptr; }
+
+object::Object MapFileFunction::call (EnvStack& env, std::vector<object::Object>& params) const {
+    std::shared_ptr<const MappedFile> file = MappedFile::open(get_path_param(params, "map_file"));
+    const std::string_view text = file->get_text();
+    return object::Object { std::make_shared<object::String>(text, std::move(file)) };
+}
+
+object::Object ReadFileFunction::call (EnvStack& env, std::vector<object::Object>& params) const {
+    std::shared_ptr<const MappedFile> file = MappedFile::open(get_path_param(params, "read_file"));
+    return object::Object { std::make_shared<object::String>(std::string { file->get_text() }) };
+}
+
+void declare_file_functions (EnvStack& env) {
+    /* stateless, one instance serves every environment */
+    static const MapFileFunction map_file {};
+    static const ReadFileFunction read_file {};
+    env.declare_function("map_file", &map_file);
+    env.declare_function("read_file", &read_file);
+}
+
+} /* namespace script */
+} /* namespace mlang */
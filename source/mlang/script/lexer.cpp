@@ -0,0 +1,321 @@
+#include "mlang/script/lexer.hpp"
+#include "mlang/script/keywords.hpp"
+#include "mlang/object/convert.hpp"
+#include "mlang/exception.hpp"
+
+namespace mlang {
+namespace script {
+
+namespace {
+
+bool is_digit (char ch) { return (ch >= '0') && (ch <= '9'); }
+
+bool is_identifier_start (char ch) {
+    return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) || (ch == '_');
+}
+
+bool is_identifier_char (char ch) { return is_identifier_start(ch) || is_digit(ch); }
+
+} /* namespace */
+
+Lexer::Lexer (Source& source, std::size_t first_line, std::size_t offset, std::size_t first_column)
+    : m_owner(source), m_source(source.get_text()), m_offset(offset), m_first_line(first_line), m_first_column(first_column) {
+    rewind();
+}
+
+void Lexer::rewind () {
+    m_index = m_offset;
+    m_line = m_first_line;
+    m_line_start = m_offset - (m_first_column - 1);
+    m_tokens.clear();
+    m_offsets.clear();
+}
+
+bool Lexer::done () const { return m_index >= m_source.size(); }
+
+char Lexer::peek (std::size_t offset) const {
+    if (m_index + offset >= m_source.size()) { return '\0'; }
+    return m_source[m_index + offset];
+}
+
+/* the first character of a line is at position 1 */
+std::size_t Lexer::column () const { return m_index - m_line_start + 1; }
+
+void Lexer::new_line () {
+    ++m_line;
+    m_line_start = m_index + 1;
+}
+
+void Lexer::add (token_types type, std::size_t pos, std::size_t length) {
+    m_tokens.emplace_back(type, m_line, pos);
+    m_index += length;
+}
+
+void Lexer::lex_number () {
+    const std::size_t pos = column();
+    const std::size_t start = m_index;
+    while (!done() && is_digit(m_source[m_index])) { ++m_index; }
+    bool is_float = false;
+    if (!done() && (m_source[m_index] == '.')) {
+        is_float = true;
+        ++m_index;
+        while (!done() && is_digit(m_source[m_index])) { ++m_index; }
+    }
+    const std::string_view text = m_source.substr(start, m_index - start);
+    if (is_float) {
+        double value = 0.0;
+        if (!object::parse_float(text, value)) {
+            throw SyntaxError{"float token could not be converted, invalid format or out of range", m_line, pos};
+        }
+        m_tokens.emplace_back(token_types::floating, value, m_line, pos);
+        return;
+    }
+    int value = 0;
+    if (!object::parse_int(text, value)) {
+        throw SyntaxError{"integer token could not be converted, invalid format or out of range", m_line, pos};
+    }
+    m_tokens.emplace_back(token_types::integer, value, m_line, pos);
+}
+
+void Lexer::lex_identifier () {
+    const std::size_t pos = column();
+    const std::size_t start = m_index;
+    while (!done() && is_identifier_char(m_source[m_index])) { ++m_index; }
+    const std::string_view word = m_source.substr(start, m_index - start);
+    /* a member name is never a keyword, 'text.format(...)' calls the member */
+    const bool member = !m_tokens.empty() && (m_tokens.back().type == token_types::dot);
+    const token_types type = member ? token_types::identifier : keyword_type(word);
+    if (type == token_types::identifier) {
+        m_tokens.emplace_back(token_types::identifier, word, m_line, pos);
+        return;
+    }
+    /* 'else' followed by 'if' is one token */
+    if ((type == token_types::kw_if) && !m_tokens.empty() && (m_tokens.back().type == token_types::kw_else)) {
+        m_tokens.back().type = token_types::kw_elif;
+        return;
+    }
+    m_tokens.emplace_back(type, m_line, pos);
+}
+
+void Lexer::lex_string () {
+    const std::size_t line = m_line;
+    const std::size_t pos = column();
+    ++m_index;
+    /* most literals contain no escape sequence -> the token refers to the text directly */
+    const std::size_t first = m_index;
+    while (!done() && (m_source[m_index] != '"') && (m_source[m_index] != '\\')) {
+        if (m_source[m_index] == '\n') { new_line(); }
+        ++m_index;
+    }
+    if (done()) {
+        throw SyntaxError{"string not closed", m_line, column()};
+    }
+    if (m_source[m_index] == '"') {
+        m_tokens.emplace_back(token_types::string, m_source.substr(first, m_index - first), line, pos);
+        ++m_index;
+        return;
+    }
+    std::string value { m_source.substr(first, m_index - first) };
+    while (true) {
+        /* copy the run up to the next special character at once */
+        const std::size_t start = m_index;
+        while (!done() && (m_source[m_index] != '"') && (m_source[m_index] != '\\') && (m_source[m_index] != '\n')) { ++m_index; }
+        value.append(m_source, start, m_index - start);
+        if (done()) {
+            throw SyntaxError{"string not closed", m_line, column()};
+        }
+        const char ch = m_source[m_index];
+        if (ch == '"') {
+            ++m_index;
+            break;
+        }
+        if (ch == '\n') {
+            value.push_back('\n');
+            new_line();
+            ++m_index;
+            continue;
+        }
+        /* escape sequence */
+        switch (peek(1)) {
+            case 'n' : { value.push_back('\n'); break; }
+            case 't' : { value.push_back('\t'); break; }
+            case 'r' : { value.push_back('\r'); break; }
+            case '\\' : { value.push_back('\\'); break; }
+            case '"' : { value.push_back('"'); break; }
+            default : {
+                ++m_index;
+                throw SyntaxError{"invalid escape sequence", m_line, column()};
+            }
+        }
+        m_index += 2;
+    }
+    m_tokens.emplace_back(token_types::string, m_owner.store(first, std::move(value)), line, pos);
+}
+
+void Lexer::skip_comment () {
+    const std::size_t line = m_line;
+    const std::size_t pos = column();
+    m_index += 2;
+    while (!done()) {
+        if ((m_source[m_index] == '*') && (peek(1) == '/')) {
+            m_index += 2;
+            return;
+        }
+        if (m_source[m_index] == '\n') { new_line(); }
+        ++m_index;
+    }
+    throw SyntaxError{"comment not closed", line, pos};
+}
+
+void Lexer::lex_operator () {
+    const std::size_t pos = column();
+    const char next = peek(1);
+    switch (m_source[m_index]) {
+        case ',' : { add(token_types::comma, pos, 1); break; }
+        case '?' : { add(token_types::question_mark, pos, 1); break; }
+        case ':' : { add(token_types::colon, pos, 1); break; }
+        case ';' : { add(token_types::semicolon, pos, 1); break; }
+        case '(' : { add(token_types::round_bracket_open, pos, 1); break; }
+        case ')' : { add(token_types::round_bracket_close, pos, 1); break; }
+        case '[' : { add(token_types::square_bracket_open, pos, 1); break; }
+        case ']' : { add(token_types::square_bracket_close, pos, 1); break; }
+        case '{' : { add(token_types::curly_bracket_open, pos, 1); break; }
+        case '}' : { add(token_types::curly_bracket_close, pos, 1); break; }
+        case '~' : { add(token_types::tilde, pos, 1); break; }
+        case '$' : { add(token_types::dollar, pos, 1); break; }
+        case '.' : { add(token_types::dot, pos, 1); break; }
+        case '@' : { add(token_types::at, pos, 1); break; }
+        case '#' : { add(token_types::hashtag, pos, 1); break; }
+        case '+' : {
+            if (next == '=') { add(token_types::plus_equal, pos, 2); }
+            else if (next == '+') { add(token_types::plus_plus, pos, 2); }
+            else { add(token_types::plus, pos, 1); }
+            break;
+        }
+        case '-' : {
+            if (next == '=') { add(token_types::dash_equal, pos, 2); }
+            else if (next == '-') { add(token_types::dash_dash, pos, 2); }
+            else { add(token_types::dash, pos, 1); }
+            break;
+        }
+        case '*' : {
+            if (next == '=') { add(token_types::asterisk_equal, pos, 2); }
+            else if (next == '/') { add(token_types::comment_end, pos, 2); }
+            else { add(token_types::asterisk, pos, 1); }
+            break;
+        }
+        case '/' : {
+            if (next == '=') { add(token_types::slash_equal, pos, 2); }
+            else { add(token_types::slash, pos, 1); }
+            break;
+        }
+        case '%' : {
+            if (next == '=') { add(token_types::percent_equal, pos, 2); }
+            else { add(token_types::percent, pos, 1); }
+            break;
+        }
+        case '=' : {
+            if (next == '=') { add(token_types::double_equal, pos, 2); }
+            else { add(token_types::equal_sign, pos, 1); }
+            break;
+        }
+        case '!' : {
+            if (next == '=') { add(token_types::exclamation_equal, pos, 2); }
+            else { add(token_types::exclamation_mark, pos, 1); }
+            break;
+        }
+        case '<' : {
+            if ((next == '<') && (peek(2) == '=')) { add(token_types::double_less_eq, pos, 3); }
+            else if (next == '=') { add(token_types::less_equal, pos, 2); }
+            else if (next == '<') { add(token_types::double_less_than, pos, 2); }
+            else { add(token_types::less, pos, 1); }
+            break;
+        }
+        case '>' : {
+            if ((next == '>') && (peek(2) == '=')) { add(token_types::double_greater_eq, pos, 3); }
+            else if (next == '=') { add(token_types::greater_equal, pos, 2); }
+            else if (next == '>') { add(token_types::double_greater_than, pos, 2); }
+            else { add(token_types::greater, pos, 1); }
+            break;
+        }
+        case '&' : {
+            if (next == '=') { add(token_types::ampersand_equal, pos, 2); }
+            else if (next == '&') { add(token_types::double_ampersand, pos, 2); }
+            else { add(token_types::ampersand, pos, 1); }
+            break;
+        }
+        case '|' : {
+            if (next == '=') { add(token_types::pipe_equal, pos, 2); }
+            else if (next == '|') { add(token_types::double_pipe, pos, 2); }
+            else { add(token_types::pipe, pos, 1); }
+            break;
+        }
+        case '^' : {
+            if (next == '=') { add(token_types::caret_equal, pos, 2); }
+            else { add(token_types::caret, pos, 1); }
+            break;
+        }
+        case '\\' : {
+            throw SyntaxError{"character '\\' at invalid position", m_line, pos};
+        }
+        case '\'' : {
+            throw SyntaxError{"unexpected apostrophe", m_line, pos};
+        }
+        default : {
+            throw SyntaxError{"unknown character ", m_line, pos};
+        }
+    }
+}
+
+void Lexer::step () {
+    const char ch = m_source[m_index];
+    if (ch == '\n') {
+        new_line();
+        ++m_index;
+    }
+    else if ((ch == ' ') || (ch == '\t') || (ch == '\r')) {
+        ++m_index;
+    }
+    else if (is_digit(ch)) {
+        lex_number();
+    }
+    else if (is_identifier_start(ch)) {
+        lex_identifier();
+    }
+    else if (ch == '"') {
+        lex_string();
+    }
+    else if ((ch == '/') && (peek(1) == '*')) {
+        skip_comment();
+    }
+    else {
+        lex_operator();
+    }
+}
+
+std::vector<Token> Lexer::tokenize () {
+    rewind();
+    /* rough guess, avoids most of the reallocations */
+    m_tokens.reserve((m_source.size() - m_offset) / 4);
+    while (!done()) { step(); }
+    return std::move(m_tokens);
+}
+
+bool Lexer::next (Token& token, std::size_t& offset) {
+    /* one token is held back, an 'else' may still turn into 'else if' */
+    while ((m_tokens.size() < 2) && !done()) {
+        const std::size_t start = m_index;
+        const std::size_t count = m_tokens.size();
+        step();
+        if (m_tokens.size() > count) { m_offsets.push_back(start); }
+    }
+    if (m_tokens.empty()) { return false; }
+    token = m_tokens.front();
+    offset = m_offsets.front();
+    m_tokens.erase(m_tokens.begin());
+    m_offsets.erase(m_offsets.begin());
+    return true;
+}
+
+} /* namespace script */
+} /* namespace mlang */
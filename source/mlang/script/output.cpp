@@ -0,0 +1,96 @@
+#include "mlang/script/output.hpp"
+#include "mlang/exception.hpp"
+
+#include <iostream>
+#include <cerrno>
+#include <unistd.h>
+
+namespace mlang {
+namespace script {
+
+void OutputSink::flush () {}
+
+StreamSink::StreamSink (std::ostream& stream) : m_stream(stream) {}
+
+void StreamSink::write (std::string_view data) {
+    m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+void StreamSink::flush () { m_stream.flush(); }
+
+FdSink::FdSink (int fd) : m_fd(fd) {}
+
+void FdSink::write (std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t written = ::write(m_fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) { continue; }
+            throw RuntimeError { "could not write script output to file descriptor " + std::to_string(m_fd) };
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+void StringSink::write (std::string_view data) { m_str.append(data); }
+
+const std::string& StringSink::get () const { return m_str; }
+
+void StringSink::clear () { m_str.clear(); }
+
+CallbackSink::CallbackSink (callback_t callback) : m_callback(std::move(callback)) {}
+
+void CallbackSink::write (std::string_view data) { m_callback(data); }
+
+
+
+
+Output::Output () : m_sink(std::make_shared<StreamSink>(std::cout)), m_capacity(0) {}
+
+Output::Output (std::shared_ptr<OutputSink> sink, std::size_t capacity) : m_sink(std::move(sink)), m_capacity(capacity) {
+    m_buffer.reserve(m_capacity);
+}
+
+Output::~Output () {
+    try {
+        flush();
+    }
+    catch (...) {
+        /* nowhere to report it anymore */
+    }
+}
+
+void Output::reset (std::shared_ptr<OutputSink> sink, std::size_t capacity) {
+    flush();
+    m_sink = std::move(sink);
+    m_capacity = capacity;
+    m_buffer.reserve(m_capacity);
+}
+
+std::string& Output::buffer () { return m_buffer; }
+
+void Output::commit () {
+    if (m_buffer.length() < m_capacity) { return; }
+    if (m_buffer.empty()) { return; }
+    m_sink->write(m_buffer);
+    m_buffer.clear();
+}
+
+void Output::write (std::string_view data) {
+    m_buffer.append(data);
+    commit();
+}
+
+void Output::flush () {
+    if (!m_buffer.empty()) {
+        m_sink->write(m_buffer);
+        m_buffer.clear();
+    }
+    m_sink->flush();
+}
+
+const std::shared_ptr<OutputSink>& Output::get_sink () const { return m_sink; }
+
+std::size_t Output::get_capacity () const { return m_capacity; }
+
+} /* namespace script */
+} /* namespace mlang */
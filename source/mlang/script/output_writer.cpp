@@ -0,0 +1,238 @@
+#include "mlang/script/output_writer.hpp"
+#include "mlang/exception.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace mlang {
+namespace script {
+
+struct ChannelSink::State {
+    std::shared_ptr<OutputWriter::Core> core;
+    std::shared_ptr<OutputSink> destination;
+    std::size_t max_pending { OutputWriter::default_max_pending };
+    overflow_policy policy { overflow_policy::block };
+    std::atomic<std::size_t> pending { 0 };
+    std::atomic<std::size_t> dropped { 0 };
+};
+
+struct OutputWriter::Chunk {
+    std::atomic<Chunk*> next { nullptr };
+    std::shared_ptr<ChannelSink::State> channel;
+    std::string data;
+};
+
+/* intrusive multi-producer single-consumer queue (D. Vyukov), producers never wait on each other */
+struct OutputWriter::Core {
+    std::atomic<Chunk*> head;
+    Chunk* tail;
+    Chunk stub;
+
+    std::atomic<std::uint32_t> signal { 0 };
+    std::atomic<bool> stop { false };
+    std::atomic<bool> closed { false };
+    std::atomic<std::size_t> producers { 0 };   /* hand_over calls in progress */
+    std::atomic<std::size_t> errors { 0 };
+
+    Core () : head(&stub), tail(&stub) {}
+
+    void push (Chunk* chunk) {
+        chunk->next.store(nullptr, std::memory_order_relaxed);
+        Chunk* prev = head.exchange(chunk, std::memory_order_acq_rel);
+        prev->next.store(chunk, std::memory_order_release);
+    }
+
+    /* consumer side only, returns nullptr if empty or if a push is still in progress */
+    Chunk* pop () {
+        Chunk* first = tail;
+        Chunk* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr) { return nullptr; }
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        if (first != head.load(std::memory_order_acquire)) { return nullptr; }
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+
+    bool is_empty () const { return head.load(std::memory_order_acquire) == tail; }
+
+    void wake () {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+    }
+};
+
+ChannelSink::ChannelSink (std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+ChannelSink::~ChannelSink () {
+    if (m_partial.empty() || m_state->core->closed.load(std::memory_order_acquire)) { return; }
+    try {
+        hand_over(std::move(m_partial));
+    }
+    catch (...) {
+        /* nowhere to report it anymore */
+    }
+}
+
+void ChannelSink::hand_over (std::string&& text) {
+    /* the writer is closed before it drains the queue the last time, it waits for the producers that got past this check */
+    struct Producer {
+        OutputWriter::Core& core;
+        explicit Producer (OutputWriter::Core& writer) : core(writer) { core.producers.fetch_add(1, std::memory_order_seq_cst); }
+        ~Producer () {
+            core.producers.fetch_sub(1, std::memory_order_seq_cst);
+            core.producers.notify_all();
+        }
+    } producer { *m_state->core };
+    if (m_state->core->closed.load(std::memory_order_seq_cst)) {
+        throw RuntimeError { "output writer is already closed" };
+    }
+    const std::size_t size = text.size();
+    std::atomic<std::size_t>& pending = m_state->pending;
+    std::size_t current = pending.load(std::memory_order_acquire);
+    while (true) {
+        /* an empty channel always accepts, even a chunk larger than the limit */
+        if ((current == 0) || (current + size <= m_state->max_pending)) {
+            if (pending.compare_exchange_weak(current, current + size, std::memory_order_acq_rel)) { break; }
+            continue;
+        }
+        if (m_state->policy == overflow_policy::drop) {
+            m_state->dropped.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+        pending.wait(current, std::memory_order_acquire);
+        current = pending.load(std::memory_order_acquire);
+    }
+    OutputWriter::Chunk* chunk = new OutputWriter::Chunk {};
+    chunk->channel = m_state;
+    chunk->data = std::move(text);
+    m_state->core->push(chunk);
+    m_state->core->wake();
+}
+
+void ChannelSink::write (std::string_view data) {
+    m_partial.append(data);
+    const std::size_t last_newline = m_partial.rfind('\n');
+    if (last_newline == std::string::npos) {
+        /* a line that never ends must not grow without bounds */
+        if (m_partial.size() >= m_state->max_pending) { hand_over(std::move(m_partial)); m_partial.clear(); }
+        return;
+    }
+    if (last_newline == m_partial.size() - 1) {
+        hand_over(std::move(m_partial));
+        m_partial.clear();
+        return;
+    }
+    std::string rest = m_partial.substr(last_newline + 1);
+    m_partial.resize(last_newline + 1);
+    hand_over(std::move(m_partial));
+    m_partial = std::move(rest);
+}
+
+void ChannelSink::flush () {
+    if (!m_partial.empty()) {
+        hand_over(std::move(m_partial));
+        m_partial.clear();
+    }
+    std::atomic<std::size_t>& pending = m_state->pending;
+    std::size_t current = pending.load(std::memory_order_acquire);
+    while (current != 0) {
+        pending.wait(current, std::memory_order_acquire);
+        current = pending.load(std::memory_order_acquire);
+    }
+}
+
+std::size_t ChannelSink::get_pending () const { return m_state->pending.load(std::memory_order_acquire); }
+
+std::size_t ChannelSink::get_dropped () const { return m_state->dropped.load(std::memory_order_relaxed); }
+
+OutputWriter::OutputWriter (std::shared_ptr<OutputSink> target) : m_core(std::make_shared<Core>()), m_target(std::move(target)) {
+    m_thread = std::thread { &OutputWriter::run, m_core };
+}
+
+OutputWriter::~OutputWriter () {
+    /* no chunk may arrive after the writer thread saw the queue empty for the last time */
+    m_core->closed.store(true, std::memory_order_seq_cst);
+    std::size_t producers = m_core->producers.load(std::memory_order_seq_cst);
+    while (producers != 0) {
+        m_core->producers.wait(producers, std::memory_order_seq_cst);
+        producers = m_core->producers.load(std::memory_order_seq_cst);
+    }
+    m_core->stop.store(true, std::memory_order_release);
+    m_core->wake();
+    m_thread.join();
+}
+
+void OutputWriter::run (std::shared_ptr<Core> core) {
+    std::vector<Chunk*> batch;
+    std::vector<OutputSink*> destinations;
+    while (true) {
+        const std::uint32_t seen = core->signal.load(std::memory_order_acquire);
+        while (Chunk* chunk = core->pop()) {
+            batch.push_back(chunk);
+        }
+        if (batch.empty()) {
+            if (core->stop.load(std::memory_order_acquire) && core->is_empty()) { break; }
+            core->signal.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+        for (Chunk* chunk : batch) {
+            OutputSink* destination = chunk->channel->destination.get();
+            try {
+                destination->write(chunk->data);
+            }
+            catch (...) {
+                core->errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (std::find(destinations.begin(), destinations.end(), destination) == destinations.end()) {
+                destinations.push_back(destination);
+            }
+        }
+        for (OutputSink* destination : destinations) {
+            try {
+                destination->flush();
+            }
+            catch (...) {
+                core->errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        /* only now the text really left the channel -> release the waiting producers */
+        for (Chunk* chunk : batch) {
+            chunk->channel->pending.fetch_sub(chunk->data.size(), std::memory_order_acq_rel);
+            chunk->channel->pending.notify_all();
+            delete chunk;
+        }
+        batch.clear();
+        destinations.clear();
+    }
+}
+
+std::shared_ptr<ChannelSink> OutputWriter::open_channel (std::size_t max_pending, overflow_policy policy) {
+    return open_channel(m_target, max_pending, policy);
+}
+
+std::shared_ptr<ChannelSink> OutputWriter::open_channel (std::shared_ptr<OutputSink> destination, std::size_t max_pending, overflow_policy policy) {
+    std::shared_ptr<ChannelSink::State> state = std::make_shared<ChannelSink::State>();
+    state->core = m_core;
+    state->destination = std::move(destination);
+    state->max_pending = max_pending;
+    state->policy = policy;
+    return std::shared_ptr<ChannelSink> { new ChannelSink { std::move(state) } };
+}
+
+std::size_t OutputWriter::get_errors () const { return m_core->errors.load(std::memory_order_relaxed); }
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,70 @@
+#include "mlang/script/program.hpp"
+#include "mlang/ast/flat_tree.hpp"
+#include "mlang/ast/exception.hpp"
+#include "mlang/exception.hpp"
+
+namespace mlang {
+namespace script {
+
+Program::Program (std::shared_ptr<const Source> source, std::shared_ptr<const ast::FlatTree> tree) : m_source(std::move(source)), m_tree(std::move(tree)) {}
+
+const Source& Program::get_source () const { return *m_source; }
+
+const ast::FlatTree& Program::get_tree () const { return *m_tree; }
+
+int Program::execute (EnvStack& env) const {
+    object::Object result {};
+    return execute(env, result);
+}
+
+int Program::execute (EnvStack& env, object::Object& result) const {
+    Output& output = env.get_output();
+    /* an aborted execution leaves the scopes it entered, the environment stays usable */
+    const std::size_t depth = env.get_depth();
+    try {
+        m_tree->execute(env);
+    }
+    catch (const ast::Exit& e) {
+        env.unwind(depth);
+        result = e.get_value();
+    }
+    catch (const ast::Return& e) {
+        env.unwind(depth);
+        result = e.get_value();
+    }
+    catch (const RuntimeError& e) {
+        env.unwind(depth);
+        output.write("ERROR : runtime error occurred\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
+        return 2;
+    }
+    catch (const BudgetExceeded& e) {
+        env.unwind(depth);
+        output.write("ERROR : execution budget exceeded\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
+        return 3;
+    }
+    catch (...) {
+        output.flush();
+        throw;
+    }
+    output.flush();
+    return 0;
+}
+
+Isolate::Isolate (std::shared_ptr<const Program> program) : m_program(std::move(program)) {}
+
+const Program& Isolate::get_program () const { return *m_program; }
+
+EnvStack& Isolate::get_environment () { return m_env; }
+
+int Isolate::run () { return m_program->execute(m_env); }
+
+void Isolate::reset () { m_env.clear(); }
+
+} /* namespace script */
+} /* namespace mlang */
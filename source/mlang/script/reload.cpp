@@ -0,0 +1,254 @@
+#include "mlang/script/reload.hpp"
+#include "mlang/script/lexer.hpp"
+#include "mlang/parser/parser.hpp"
+#include "mlang/exception.hpp"
+
+#include <unordered_map>
+
+namespace mlang {
+namespace script {
+
+namespace {
+
+struct Span {
+    unit_kinds kind;
+    std::string_view text;
+    std::string_view name;
+    std::size_t line;
+};
+
+bool is_word_char (char ch) {
+    return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) || ((ch >= '0') && (ch <= '9')) || (ch == '_');
+}
+
+/* finds the top-level declarations without lexing, only brackets, strings and comments are recognized */
+class UnitScanner {
+private:
+    std::string_view m_text;
+    std::size_t m_index { 0 };
+    std::size_t m_line { 1 };
+
+    bool done () const { return m_index >= m_text.size(); }
+
+    void skip_space () {
+        while (!done()) {
+            const char ch = m_text[m_index];
+            if (ch == '\n') { ++m_line; ++m_index; }
+            else if ((ch == ' ') || (ch == '\t') || (ch == '\r')) { ++m_index; }
+            else if ((ch == '/') && (m_index + 1 < m_text.size()) && (m_text[m_index + 1] == '*')) {
+                m_index += 2;
+                while (!done() && !((m_text[m_index] == '*') && (m_index + 1 < m_text.size()) && (m_text[m_index + 1] == '/'))) {
+                    if (m_text[m_index] == '\n') { ++m_line; }
+                    ++m_index;
+                }
+                m_index = std::min(m_index + 2, m_text.size());
+            }
+            else { break; }
+        }
+    }
+
+    std::string_view word () {
+        const std::size_t start = m_index;
+        while (!done() && is_word_char(m_text[m_index])) { ++m_index; }
+        return m_text.substr(start, m_index - start);
+    }
+
+    std::string_view peek_word () {
+        const std::size_t index = m_index;
+        const std::size_t line = m_line;
+        skip_space();
+        std::string_view next = word();
+        m_index = index;
+        m_line = line;
+        return next;
+    }
+
+    void skip_string () {
+        ++m_index;
+        while (!done() && (m_text[m_index] != '"')) {
+            if (m_text[m_index] == '\\') { ++m_index; }
+            else if (m_text[m_index] == '\n') { ++m_line; }
+            ++m_index;
+        }
+        ++m_index;
+    }
+public:
+    UnitScanner (std::string_view text) : m_text(text) {}
+
+    bool next (Span& span) {
+        skip_space();
+        if (done()) { return false; }
+        const std::size_t start = m_index;
+        span.line = m_line;
+        span.name = {};
+        const std::string_view first = word();
+        span.kind = unit_kinds::statement;
+        if ((first == "function") || (first == "var")) {
+            span.kind = (first == "function") ? unit_kinds::function : unit_kinds::global;
+            skip_space();
+            span.name = word();
+        }
+        /* a block of these ends the declaration unless an 'else' follows */
+        const bool block_statement = (first == "function") || (first == "if") || (first == "for") || (first == "while");
+        std::size_t depth = 0;
+        while (!done()) {
+            const char ch = m_text[m_index];
+            if (ch == '"') { skip_string(); continue; }
+            if ((ch == '/') && (m_index + 1 < m_text.size()) && (m_text[m_index + 1] == '*')) { skip_space(); continue; }
+            ++m_index;
+            if (ch == '\n') { ++m_line; }
+            else if ((ch == '(') || (ch == '[') || (ch == '{')) { ++depth; }
+            else if ((ch == ')') || (ch == ']')) { depth = (depth > 0) ? depth - 1 : 0; }
+            else if (ch == '}') {
+                depth = (depth > 0) ? depth - 1 : 0;
+                if ((depth == 0) && block_statement && (peek_word() != "else")) { break; }
+            }
+            else if ((ch == ';') && (depth == 0)) { break; }
+        }
+        m_index = std::min(m_index, m_text.size());
+        span.text = m_text.substr(start, m_index - start);
+        return true;
+    }
+};
+
+/* the same messages and results as Script::execute */
+int report (Output& output, const std::string& headline, const LangException& e, int result) {
+    output.write("ERROR : " + headline + "\n");
+    output.write(e.what());
+    output.write("\n");
+    output.flush();
+    return result;
+}
+
+} /* namespace */
+
+std::vector<ReloadableScript::Unit> ReloadableScript::compile (std::string_view text, const std::vector<Unit>& previous, ReloadStats& stats) {
+    /* unchanged declarations are found by their text, a text that occurs twice is matched twice */
+    std::unordered_multimap<std::string_view, std::size_t> known;
+    known.reserve(previous.size());
+    for (std::size_t i = 0; i < previous.size(); ++i) { known.emplace(previous[i].source->get_text(), i); }
+
+    std::vector<Unit> units;
+    UnitScanner scanner { text };
+    Span span {};
+    while (scanner.next(span)) {
+        ++stats.units;
+        auto it = known.find(span.text);
+        if (it != known.end()) {
+            const Unit& unit = previous[it->second];
+            units.push_back(Unit { unit.kind, unit.name, span.line, unit.source, nullptr, it->second });
+            known.erase(it);
+            ++stats.reused;
+            continue;
+        }
+        std::shared_ptr<Source> source = std::make_shared<Source>(std::string { span.text });
+        parser::Parser parser {};
+        ast::node_ptr node {};
+        if (span.kind == unit_kinds::function) {
+            /* parsed from a token vector the body is compiled right away, a syntax error in it fails the reload */
+            const std::vector<Token> tokens = Lexer { *source, span.line }.tokenize();
+            node = parser.parse(tokens, source);
+        }
+        else { node = parser.parse(source, span.line); }
+        const std::size_t name_offset = static_cast<std::size_t>(span.name.data() - span.text.data());
+        const std::string_view name = span.name.empty() ? std::string_view {} : source->get_text().substr(name_offset, span.name.size());
+        units.push_back(Unit { span.kind, name, span.line, std::move(source), std::move(node), not_reused });
+        ++stats.compiled;
+        stats.lexed_bytes += span.text.size();
+    }
+    return units;
+}
+
+ReloadableScript::ReloadableScript (std::string_view text) {
+    m_units = compile(text, {}, m_stats);
+}
+
+int ReloadableScript::execute (EnvStack& env) {
+    Output& output = env.get_output();
+    /* an aborted execution leaves the scopes it entered, the next reload finds the functions at the top level */
+    const std::size_t depth = env.get_depth();
+    try {
+        for (Unit& unit : m_units) {
+            unit.node->execute(env);
+            ++m_stats.executed;
+        }
+    }
+    catch (const SyntaxError& e) {
+        env.unwind(depth);
+        return report(output, "syntax error occurred", e, 1);
+    }
+    catch (const RuntimeError& e) {
+        env.unwind(depth);
+        return report(output, "runtime error occurred", e, 2);
+    }
+    catch (const BudgetExceeded& e) {
+        env.unwind(depth);
+        return report(output, "execution budget exceeded", e, 3);
+    }
+    catch (...) {
+        output.flush();
+        throw;
+    }
+    output.flush();
+    return 0;
+}
+
+int ReloadableScript::reload (std::string_view text, EnvStack& env) {
+    Output& output = env.get_output();
+    ReloadStats stats {};
+    std::vector<Unit> units;
+    try {
+        units = compile(text, m_units, stats);
+    }
+    catch (const SyntaxError& e) { return report(output, "syntax error occurred", e, 1); }
+
+    std::vector<bool> kept(m_units.size(), false);
+    std::unordered_map<std::string_view, bool> functions;
+    for (Unit& unit : units) {
+        if (unit.kind == unit_kinds::function) { functions[unit.name] = true; }
+        if (unit.reused_from == not_reused) { continue; }
+        kept[unit.reused_from] = true;
+        unit.node = std::move(m_units[unit.reused_from].node);
+    }
+    /* the environment must not refer to the nodes that are dropped, changed functions are declared again below */
+    for (std::size_t i = 0; i < m_units.size(); ++i) {
+        if (kept[i] || (m_units[i].kind != unit_kinds::function)) { continue; }
+        if (env.remove_function(m_units[i].name) && (functions.find(m_units[i].name) == functions.end())) { ++stats.removed; }
+    }
+    std::vector<Unit> previous = std::move(m_units);
+    m_units = std::move(units);
+    m_stats = stats;
+
+    const std::size_t depth = env.get_depth();
+    try {
+        for (Unit& unit : m_units) {
+            if (unit.reused_from != not_reused) { continue; }
+            if ((unit.kind == unit_kinds::global) && env.has_variable(unit.name)) { continue; }
+            unit.node->execute(env);
+            ++m_stats.executed;
+        }
+    }
+    catch (const SyntaxError& e) {
+        env.unwind(depth);
+        return report(output, "syntax error occurred", e, 1);
+    }
+    catch (const RuntimeError& e) {
+        env.unwind(depth);
+        return report(output, "runtime error occurred", e, 2);
+    }
+    catch (const BudgetExceeded& e) {
+        env.unwind(depth);
+        return report(output, "execution budget exceeded", e, 3);
+    }
+    catch (...) {
+        output.flush();
+        throw;
+    }
+    output.flush();
+    return 0;
+}
+
+const ReloadStats& ReloadableScript::get_stats () const { return m_stats; }
+
+} /* namespace script */
+} /* namespace mlang */
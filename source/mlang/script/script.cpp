@@ -1,488 +1,153 @@
+#include <fstream>
+#include <filesystem>
+
 #include "mlang/script/script.hpp"
-#include "mlang/tokenizer/tokenizer.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/lexer.hpp"
 #include "mlang/exception.hpp"
 #include "mlang/object/object.hpp"
 #include "mlang/parser/parser.hpp"
+#include "mlang/ast/flat_tree.hpp"
 
 namespace mlang {
 namespace script {
 
-void Script::debug(const std::string& debug_message) {
+void Script::debug(const std::string& debug_message) const {
     #if DEBUG_SCRIPT == 1
         std::cout << debug_message << std::endl;
     #endif
 }
 
-Script::Script (const std::string& script) {
-    tokenizer::Tokenizer tokenizer { script };
-    tokenizer.tokenize();
+Script::Script (const std::string& script) : Script(std::string { script }) {}
 
-    const std::vector<tokenizer::Token>& tokens = tokenizer.get_tokens();
-    std::size_t tokens_size = tokens.size();
-    for (std::size_t index = 0; index < tokens_size; ++index) {
-        const tokenizer::Token& token = tokens[index];
-        switch (token.get_type()) {
-            case tokenizer::token_types::none: {
-                throw SyntaxError{"token cannot be of type none", token.get_line(), token.get_pos()};
-            }
-            case tokenizer::token_types::identifier: {
-                if (token.get_value().compare("none") == 0) {
-                    debug("token with type 'none'");
-                    m_tokens.push_back(Token{token_types::kw_none, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("true") == 0) {
-                    debug("token with type 'true'");
-                    m_tokens.push_back(Token{token_types::kw_true, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("false") == 0) {
-                    debug("token with type 'false'");
-                    m_tokens.push_back(Token{token_types::kw_false, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("if") == 0) {
-                    debug("token with type 'if'");
-                    m_tokens.push_back(Token{token_types::kw_if, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("else") == 0) {
-                    /* it could be a 'else', or it could be 'else if' */
-                    if ((index + 1) < tokens_size) {
-                        if (tokens[index + 1].get_value().compare("if") == 0) {
-                            debug("token with type 'else if'");
-                            m_tokens.push_back(Token{token_types::kw_elif, token.get_line(), token.get_pos()});
-                            ++index;
-                            break;
-                        }
-                    }
-                    debug("token with type 'else'");
-                    m_tokens.push_back(Token{token_types::kw_else, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("new") == 0) {
-                    debug("token with type 'new'");
-                    m_tokens.push_back(Token{token_types::kw_new, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("for") == 0) {
-                    debug("token with type 'for'");
-                    m_tokens.push_back(Token{token_types::kw_for, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("while") == 0) {
-                    debug("token with type 'while'");
-                    m_tokens.push_back(Token{token_types::kw_while, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("break") == 0) {
-                    debug("token with type 'break'");
-                    m_tokens.push_back(Token{token_types::kw_break, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("continue") == 0) {
-                    debug("token with type 'continue'");
-                    m_tokens.push_back(Token{token_types::kw_continue, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("switch") == 0) {
-                    debug("token with type 'switch'");
-                    m_tokens.push_back(Token{token_types::kw_switch, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("case") == 0) {
-                    debug("token with type 'case'");
-                    m_tokens.push_back(Token{token_types::kw_case, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("default") == 0) {
-                    debug("token with type 'default'");
-                    m_tokens.push_back(Token{token_types::kw_default, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("function") == 0) {
-                    debug("token with type 'function'");
-                    m_tokens.push_back(Token{token_types::kw_function, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("var") == 0) {
-                    debug("token with type 'variable'");
-                    m_tokens.push_back(Token{token_types::kw_var, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("return") == 0) {
-                    debug("token with type 'return'");
-                    m_tokens.push_back(Token{token_types::kw_return, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("exit") == 0) {
-                    debug("token with type 'exit'");
-                    m_tokens.push_back(Token{token_types::kw_exit, token.get_line(), token.get_pos()});
-                }
-                else if (token.get_value().compare("print") == 0) {
-                    debug("token with type 'print'");
-                    m_tokens.push_back(Token{token_types::kw_print, token.get_line(), token.get_pos()});
-                }
-                else {
-                    debug("token with type 'identifier' and value " + token.get_value());
-                    m_tokens.push_back(Token{token_types::identifier, token.get_value(), token.get_line(), token.get_pos()});
-                }
-                break;
-            }
-            case tokenizer::token_types::integer: {
-                try {
-                    int value = std::stoi(token.get_value());
-                    debug("token with type 'integer' and value " + std::to_string(value));
-                    m_tokens.push_back(Token{token_types::integer, value, token.get_line(), token.get_pos()});
-                }
-                catch (const std::invalid_argument&) {
-                    throw SyntaxError{"integer token could not be converted, invalid format", token.get_line(), token.get_pos()};
-                }
-                catch (const std::out_of_range&) {
-                    throw SyntaxError{"integer token could not be converted, out of range", token.get_line(), token.get_pos()};
-                }
-                break;
-            }
-            case tokenizer::token_types::floating: {
-                try {
-                    double value = std::stod(token.get_value());
-                    debug("token with type 'floating' and value " + std::to_string(value));
-                    m_tokens.push_back(Token{token_types::floating, value, token.get_line(), token.get_pos()});
-                }
-                catch (const std::invalid_argument&) {
-                    throw SyntaxError{"float token could not be converted, invalid format", token.get_line(), token.get_pos()};
-                }
-                catch (const std::out_of_range&) {
-                    throw SyntaxError{"float token could not be converted, out of range", token.get_line(), token.get_pos()};
-                }
-                break;
-            }
-            case tokenizer::token_types::string: {
-                debug("token with type 'string' and value " +  token.get_value());
-                m_tokens.push_back(Token{token_types::string, token.get_value(), token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::comma: {
-                debug("token with type 'comma'");
-                m_tokens.push_back(Token{token_types::comma, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::question_mark: {
-                debug("token with type 'question_mark'");
-                m_tokens.push_back(Token{token_types::question_mark, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::colon: {
-                debug("token with type 'colon'");
-                m_tokens.push_back(Token{token_types::colon, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::semicolon: {
-                debug("token with type 'semicolon'");
-                m_tokens.push_back(Token{token_types::semicolon, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::round_bracket_open: {
-                debug("token with type 'round_bracket_open'");
-                m_tokens.push_back(Token{token_types::round_bracket_open, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::round_bracket_close: {
-                debug("token with type 'round_bracket_close'");
-                m_tokens.push_back(Token{token_types::round_bracket_close, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::square_bracket_open: {
-                debug("token with type 'square_bracket_open'");
-                m_tokens.push_back(Token{token_types::square_bracket_open, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::square_bracket_close: {
-                debug("token with type 'square_bracket_close'");
-                m_tokens.push_back(Token{token_types::square_bracket_close, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::curly_bracket_open: {
-                debug("token with type 'curly_bracket_open'");
-                m_tokens.push_back(Token{token_types::curly_bracket_open, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::curly_bracket_close: {
-                debug("token with type 'curly_bracket_close'");
-                m_tokens.push_back(Token{token_types::curly_bracket_close, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::asterisk: {
-                /* it could be a signle asterisk, or it could be '*=' or comment end */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'asterisk_equal'");
-                        m_tokens.push_back(Token{token_types::asterisk_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    else if (tokens[index + 1].get_type() == tokenizer::token_types::slash) {
-                        debug("token with type 'comment_end'");
-                        m_tokens.push_back(Token{token_types::comment_end, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'asterisk'");
-                m_tokens.push_back(Token{token_types::asterisk, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::slash: {
-                /* it could be a signle slash, or it could be slash_equal or comment_start */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'slash_equal'");
-                        m_tokens.push_back(Token{token_types::slash_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    else if (tokens[index + 1].get_type() == tokenizer::token_types::asterisk) {
-                        debug("token with type 'comment_start'");
-                        m_tokens.push_back(Token{token_types::comment_start, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'slash'");
-                m_tokens.push_back(Token{token_types::slash, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::percent: {
-                /* it could be a signle percent, or it could be percent_equal */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'percent_equal'");
-                        m_tokens.push_back(Token{token_types::percent_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'percent'");
-                m_tokens.push_back(Token{token_types::percent, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::plus: {
-                /* it could be a signle plus, or it could be plus_equal, or plus_plus */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'plus_equal'");
-                        m_tokens.push_back(Token{token_types::plus_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::plus) {
-                        debug("token with type 'plus_plus'");
-                        m_tokens.push_back(Token{token_types::plus_plus, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'plus'");
-                m_tokens.push_back(Token{token_types::plus, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::dash: {
-                /* it could be a signle dash, or it could be dash_equal, or dash_dash */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'dash_equal'");
-                        m_tokens.push_back(Token{token_types::dash_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::dash) {
-                        debug("token with type 'dash_dash'");
-                        m_tokens.push_back(Token{token_types::dash_dash, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'dash'");
-                m_tokens.push_back(Token{token_types::dash, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::equal_sign: {
-                /* it could be a signle dash, or it could be double_equal */
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'double_equal'");
-                        m_tokens.push_back(Token{token_types::double_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'equal_sign'");
-                m_tokens.push_back(Token{token_types::equal_sign, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::exclamation_mark: {
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'exclamation_equal'");
-                        m_tokens.push_back(Token{token_types::exclamation_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'exclamation_mark'");
-                m_tokens.push_back(Token{token_types::exclamation_mark, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::tilde: {
-                debug("token with type 'tilde'");
-                m_tokens.push_back(Token{token_types::tilde, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::less: {
-                /* it could be a '<', '<<', '<=', '<<=' */
-                if ((index + 1) < tokens_size) {
-                    if ((index + 2) < tokens_size) {
-                        if (tokens[index + 1].get_type() == tokenizer::token_types::less) {
-                            if (tokens[index + 2].get_type() == tokenizer::token_types::equal_sign) {
-                                debug("token with type 'double_less_eq'");
-                                m_tokens.push_back(Token{token_types::double_less_eq, token.get_line(), token.get_pos()});
-                                index += 2;
-                                break;
-                            }
-                        }
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'less_equal'");
-                        m_tokens.push_back(Token{token_types::less_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::less) {
-                        debug("token with type 'double_less_than'");
-                        m_tokens.push_back(Token{token_types::double_less_than, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'less'");
-                m_tokens.push_back(Token{token_types::less, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::greater: {
-                /* it could be a '>', '>>', '>=', '>>=' */
-                if ((index + 1) < tokens_size) {
-                    if ((index + 2) < tokens_size) {
-                        if (tokens[index + 1].get_type() == tokenizer::token_types::greater) {
-                            if (tokens[index + 2].get_type() == tokenizer::token_types::equal_sign) {
-                                debug("token with type 'double_greater_eq'");
-                                m_tokens.push_back(Token{token_types::double_greater_eq, token.get_line(), token.get_pos()});
-                                index += 2;
-                                break;
-                            }
-                        }
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'greater_equal'");
-                        m_tokens.push_back(Token{token_types::greater_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::greater) {
-                        debug("token with type 'double_greater_than'");
-                        m_tokens.push_back(Token{token_types::double_greater_than, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'greater'");
-                m_tokens.push_back(Token{token_types::greater, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::ampersand: {
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'ampersand_equal'");
-                        m_tokens.push_back(Token{token_types::ampersand_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::ampersand) {
-                        debug("token with type 'double_ampersand'");
-                        m_tokens.push_back(Token{token_types::double_ampersand, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'ampersand'");
-                m_tokens.push_back(Token{token_types::ampersand, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::dollar: {
-                debug("token with type 'dollar'");
-                m_tokens.push_back(Token{token_types::dollar, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::caret: {
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'caret_equal'");
-                        m_tokens.push_back(Token{token_types::caret_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'caret'");
-                m_tokens.push_back(Token{token_types::caret, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::pipe: {
-                if ((index + 1) < tokens_size) {
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::equal_sign) {
-                        debug("token with type 'pipe_equal'");
-                        m_tokens.push_back(Token{token_types::pipe_equal, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                    if (tokens[index + 1].get_type() == tokenizer::token_types::pipe) {
-                        debug("token with type 'double_pipe'");
-                        m_tokens.push_back(Token{token_types::double_pipe, token.get_line(), token.get_pos()});
-                        ++index;
-                        break;
-                    }
-                }
-                debug("token with type 'pipe'");
-                m_tokens.push_back(Token{token_types::pipe, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::dot: {
-                debug("token with type 'dot'");
-                m_tokens.push_back(Token{token_types::dot, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::at: {
-                debug("token with type 'at'");
-                m_tokens.push_back(Token{token_types::at, token.get_line(), token.get_pos()});
-                break;
-            }
-            case tokenizer::token_types::hashtag: {
-                debug("token with type 'hashtag'");
-                m_tokens.push_back(Token{token_types::hashtag, token.get_line(), token.get_pos()});
-                break;
-            }
-            default: {
-                throw SyntaxError{"unknown token type", token.get_line(), token.get_pos()};
-            }
-        }
+Script::Script (std::string&& script) : Script(std::make_shared<Source>(std::move(script))) {}
+
+Script::Script (std::shared_ptr<Source> source) : m_source(std::move(source)), m_tokens(std::make_shared<TokenCache>()) {}
+
+Script::Script (std::shared_ptr<Source> source, std::shared_ptr<const ast::FlatTree> program) : m_source(std::move(source)), m_tokens(std::make_shared<TokenCache>()), m_program(std::move(program)) {
+    /* nothing to lex, the text is the binary program */
+    m_tokens->tokens = std::make_shared<const std::vector<Token>>();
+}
+
+Script Script::from_file (const std::string& path) {
+    return Script { std::make_shared<Source>(MappedFile::open(path)) };
+}
+
+Script Script::load (const std::string& path) {
+    std::shared_ptr<Source> source = std::make_shared<Source>(MappedFile::open(path));
+    try {
+        std::shared_ptr<const ast::FlatTree> program = ast::FlatTree::deserialize(source);
+        return Script { std::move(source), std::move(program) };
+    }
+    catch (const RuntimeError& e) {
+        throw RuntimeError{ "could not load '" + path + "', " + e.what() };
     }
 }
 
-    
-const std::vector<Token>& Script::get_tokens () const { return m_tokens; }
+void Script::compile () {
+    if (m_program) { return; }
+    parser::FlatParser parser {};
+    m_program = parser.parse(m_source);
+}
+
+std::shared_ptr<const Program> Script::get_program () {
+    compile();
+    return std::make_shared<const Program>(m_source, m_program);
+}
 
-int Script::execute (script::EnvStack& env) {
-    parser::Parser parser {};
+void Script::save (const std::string& path) const {
+    std::string data;
+    if (m_program) {
+        m_program->serialize(data);
+    }
+    else {
+        parser::FlatParser parser {};
+        parser.parse(m_source)->serialize(data);
+    }
+    /* written next to the target and renamed, a reader never sees half a file */
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file { temp_path, std::ios::binary | std::ios::trunc };
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) { throw RuntimeError{ "could not write file '" + temp_path + "'" }; }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error) { throw RuntimeError{ "could not write file '" + path + "'" }; }
+}
+
+const std::vector<Token>& Script::get_tokens () const {
+    std::lock_guard<std::mutex> lock { m_tokens->mutex };
+    if (!m_tokens->tokens) {
+        Lexer lexer { *m_source };
+        m_tokens->tokens = std::make_shared<const std::vector<Token>>(lexer.tokenize());
+        debug("lexer produced " + std::to_string(m_tokens->tokens->size()) + " tokens");
+    }
+    return *m_tokens->tokens;
+}
+
+const Source& Script::get_source () const { return *m_source; }
+
+int Script::execute (script::EnvStack& env) { return execute(env, ast_layout::tree); }
+
+int Script::execute (script::EnvStack& env, ast_layout layout) {
+    Output& output = env.get_output();
     ast::node_ptr root {};
+    std::shared_ptr<const ast::FlatTree> flat_root { m_program };
     try {
-        root = parser.parse( m_tokens );
+        if (flat_root) { /* precompiled, nothing to parse */ }
+        else if (layout == ast_layout::flat) {
+            parser::FlatParser parser {};
+            flat_root = parser.parse( m_source );
+        }
+        else {
+            parser::Parser parser {};
+            root = parser.parse( m_source );
+        }
     }
     catch (const SyntaxError& e) {
-        std::cout << "ERROR : syntax error occurred" << std::endl;
-        std::cout << e.what() << std::endl;
+        output.write("ERROR : syntax error occurred\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
         return 1;
     }
     //root->print();
+    const std::size_t depth = env.get_depth();
     try {
-        root->execute(env);
+        if (flat_root) { flat_root->execute(env); }
+        else { root->execute(env); }
+    }
+    catch (const SyntaxError& e) {
+        /* a function body is compiled by its first call */
+        env.unwind(depth);
+        output.write("ERROR : syntax error occurred\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
+        return 1;
     }
     catch (const RuntimeError& e) {
-        std::cout << "ERROR : runtime error occurred" << std::endl;
-        std::cout << e.what() << std::endl;
+        env.unwind(depth);
+        output.write("ERROR : runtime error occurred\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
         return 2;
     }
+    catch (const BudgetExceeded& e) {
+        env.unwind(depth);
+        output.write("ERROR : execution budget exceeded\n");
+        output.write(e.what());
+        output.write("\n");
+        output.flush();
+        return 3;
+    }
+    catch (...) {
+        output.flush();
+        throw;
+    }
+    output.flush();
     return 0;
 }
 
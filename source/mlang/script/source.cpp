@@ -0,0 +1,25 @@
+#include "mlang/script/source.hpp"
+
+namespace mlang {
+namespace script {
+
+Source::Source (std::string text) : m_text(std::move(text)), m_view(m_text) {}
+
+Source::Source (std::shared_ptr<const MappedFile> file) : m_file(std::move(file)), m_view(m_file->get_text()) {}
+
+std::string_view Source::get_text () const { return m_view; }
+
+std::string_view Source::store (std::size_t offset, std::string&& literal) {
+    std::lock_guard<std::mutex> lock { m_literal_mutex };
+    const auto [it, inserted] = m_literals.try_emplace(offset, std::move(literal));
+    if (inserted) { m_literal_size += it->second.size(); }
+    return it->second;
+}
+
+std::size_t Source::get_size () const {
+    std::lock_guard<std::mutex> lock { m_literal_mutex };
+    return m_view.size() + m_literal_size;
+}
+
+} /* namespace script */
+} /* namespace mlang */
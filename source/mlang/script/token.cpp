@@ -77,6 +77,7 @@ std::size_t Token::get_length () const {
         case token_types::kw_return : { return 6; }
         case token_types::kw_exit : { return 4; }
         case token_types::kw_print : { return 5; }
+        case token_types::kw_format : { return 6; }
         default: { return 0; }
     }
 }
@@ -84,10 +85,10 @@ std::size_t Token::get_length () const {
 std::string Token::get_for_print() const {
     switch (type) {
         case token_types::none : { return "none"; }
-        case token_types::identifier : { return "identifier:" + value_str; }
+        case token_types::identifier : { return "identifier:" + std::string { value_str }; }
         case token_types::integer : { return "int:" + std::to_string(value_int); }
         case token_types::floating : { return "float:" + std::to_string(value_float); }
-        case token_types::string : { return "string:" + value_str; }
+        case token_types::string : { return "string:" + std::string { value_str }; }
         case token_types::comma : { return ","; }
         case token_types::question_mark : { return "?"; }
         case token_types::colon : { return ":"; }
@@ -155,6 +156,7 @@ std::string Token::get_for_print() const {
         case token_types::kw_return : { return "return"; }
         case token_types::kw_exit : { return "exit"; }
         case token_types::kw_print : { return "print"; }
+        case token_types::kw_format : { return "format"; }
         default: { return "ERROR"; }
     }
 }
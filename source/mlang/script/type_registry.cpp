@@ -0,0 +1,77 @@
+#include "mlang/script/type_registry.hpp"
+#include "mlang/object/none.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/float.hpp"
+#include "mlang/object/boolean.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/exception.hpp"
+
+namespace mlang {
+namespace script {
+
+TypeRegistry::TypeRegistry () {
+    /* in the order of builtin_types */
+    define(object::None::type_name, std::make_shared<object::NoneFactory>());
+    define(object::Int::type_name, std::make_shared<object::IntFactory>());
+    define(object::Float::type_name, std::make_shared<object::FloatFactory>());
+    define(object::Boolean::type_name, std::make_shared<object::BooleanFactory>());
+    define(object::Array::type_name, std::make_shared<object::ArrayFactory>());
+    define(object::String::type_name, std::make_shared<object::StringFactory>());
+}
+
+TypeRegistry& TypeRegistry::instance () {
+    static TypeRegistry registry {};
+    return registry;
+}
+
+std::size_t TypeRegistry::slot_of (std::string_view type_name) { return std::hash<std::string_view>{}(type_name) & (slot_count - 1); }
+
+type_id TypeRegistry::define (std::string_view type_name, std::shared_ptr<object::ObjectFactory> factory) {
+    std::lock_guard<std::mutex> lock { m_define_mutex };
+    std::size_t slot = slot_of(type_name);
+    for (const Entry* entry = m_slots[slot].load(std::memory_order_relaxed); entry != nullptr; entry = m_slots[slot].load(std::memory_order_relaxed)) {
+        if (entry->name == type_name) { throw RuntimeError{"type '" + std::string { type_name } + "' already exists"}; }
+        slot = (slot + 1) & (slot_count - 1);
+    }
+    const std::size_t size = m_size.load(std::memory_order_relaxed);
+    if (size >= max_types) {
+        throw RuntimeError{"type '" + std::string { type_name } + "' cannot be defined, too many types"};
+    }
+    const type_id id = static_cast<type_id>(size);
+    /* the factory is in place before the name can be found */
+    m_factories[id].store(factory.get(), std::memory_order_release);
+    m_owned.push_back(std::move(factory));
+    m_entries.push_back(std::make_unique<const Entry>(Entry { std::string { type_name }, id }));
+    m_slots[slot].store(m_entries.back().get(), std::memory_order_release);
+    m_size.store(size + 1, std::memory_order_release);
+    return id;
+}
+
+type_id TypeRegistry::find (std::string_view type_name) const {
+    /* a slot never changes once it is filled, a lookup ends at the first empty one */
+    for (std::size_t slot = slot_of(type_name);; slot = (slot + 1) & (slot_count - 1)) {
+        const Entry* entry = m_slots[slot].load(std::memory_order_acquire);
+        if (entry == nullptr) { return unknown_type; }
+        if (entry->name == type_name) { return entry->id; }
+    }
+}
+
+bool TypeRegistry::has (std::string_view type_name) const { return find(type_name) != unknown_type; }
+
+std::size_t TypeRegistry::size () const { return m_size.load(std::memory_order_acquire); }
+
+const object::ObjectFactory& TypeRegistry::get_factory (type_id type) const {
+    const object::ObjectFactory* factory = (type < max_types) ? m_factories[type].load(std::memory_order_acquire) : nullptr;
+    if (factory == nullptr) { throw RuntimeError{"type id " + std::to_string(type) + " is unknown"}; }
+    return *factory;
+}
+
+const object::ObjectFactory& TypeRegistry::get_factory (std::string_view type_name) const {
+    const type_id type = find(type_name);
+    if (type == unknown_type) { throw RuntimeError{"type '" + std::string { type_name } + "' is unknown"}; }
+    return get_factory(type);
+}
+
+} /* namespace script */
+} /* namespace mlang */
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+#include "mlang/script/batch.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+
+namespace {
+
+std::vector<std::string> write_rules (std::size_t count) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "mlang_batch_test";
+    std::filesystem::create_directories(directory);
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string path = (directory / ("rule_" + std::to_string(i) + ".mlang")).string();
+        std::ofstream file { path, std::ios::trunc };
+        if (i % 7 == 3) { file << "var broken = ;\n"; }
+        else { file << "function rule (x) { return x * " << i << "; }\nprint(\"%d\\n\", rule(2));\n"; }
+        paths.push_back(path);
+    }
+    paths.push_back((directory / "missing.mlang").string());
+    return paths;
+}
+
+} /* namespace */
+
+TEST(BatchTest, Test0) {
+    const std::vector<std::string> paths = write_rules(30);
+    std::size_t progress_calls = 0;
+    std::size_t last_done = 0;
+    mlang::script::CompileBatch batch = mlang::script::compile_all(paths, 3, [&] (std::size_t done, std::size_t total, const mlang::script::CompileResult&) {
+        ++progress_calls;
+        EXPECT_EQ(done, last_done + 1);
+        EXPECT_EQ(total, paths.size());
+        last_done = done;
+    });
+    ASSERT_EQ(progress_calls, paths.size());
+    ASSERT_EQ(batch.results.size(), paths.size());
+    ASSERT_EQ(batch.stats.files, paths.size());
+    ASSERT_EQ(batch.stats.threads, 3);
+    ASSERT_EQ(batch.stats.failed, 5);   /* 3, 10, 17, 24 and the missing file */
+
+    for (std::size_t i = 0; i < 30; ++i) {
+        const mlang::script::CompileResult& result = batch.results[i];
+        ASSERT_EQ(result.path, paths[i]);
+        if (i % 7 == 3) {
+            ASSERT_FALSE(result.script.has_value());
+            ASSERT_NE(result.error.find("syntax error"), std::string::npos);
+            continue;
+        }
+        ASSERT_TRUE(result.script.has_value());
+        ASSERT_TRUE(result.error.empty());
+        mlang::script::EnvStack env {};
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        env.set_output(sink);
+        mlang::script::Script script = *result.script;
+        ASSERT_EQ(script.execute(env), 0);
+        ASSERT_EQ(sink->get(), std::to_string(i * 2) + "\n");
+    }
+    ASSERT_FALSE(batch.results.back().script.has_value());
+    ASSERT_NE(batch.results.back().error.find("missing.mlang"), std::string::npos);
+
+    /* the same errors in the same places with any number of threads */
+    for (std::size_t threads : { 1, 8, 0 }) {
+        mlang::script::CompileBatch other = mlang::script::compile_all(paths, threads);
+        ASSERT_EQ(other.results.size(), batch.results.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            ASSERT_EQ(other.results[i].error, batch.results[i].error);
+        }
+    }
+    ASSERT_TRUE(mlang::script::compile_all({}, 4).results.empty());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/budget.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/runtime/parallel.hpp"
+
+namespace {
+
+/* runs the script under the budget and returns what it printed */
+std::string run (const std::string& script_text, const mlang::script::Budget& budget, mlang::script::ast_layout layout, int expected_result) {
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    env.set_budget(budget);
+    EXPECT_EQ(script.execute(env, layout), expected_result);
+    EXPECT_EQ(env.get_depth(), 1);
+    return sink->get();
+}
+
+} /* namespace */
+
+TEST(BudgetTest, Test0) {
+    /* every loop iteration, the last test included, and every call is a step */
+    const std::string counted = "function f(x) { return x; }\nfor (var i = 0; i < 10; i++) { f(i); }\nvar j = 0;\nwhile (j < 5) { j++; }\nprint(\"done\");";
+    for (mlang::script::ast_layout layout : { mlang::script::ast_layout::tree, mlang::script::ast_layout::flat }) {
+        mlang::script::Budget budget {};
+        budget.max_steps = 27;
+        ASSERT_EQ(run(counted, budget, layout, 0), "done");
+        budget.max_steps = 26;
+        ASSERT_EQ(run(counted, budget, layout, 3), "ERROR : execution budget exceeded\nthe script exceeded its limit of 26 steps\n");
+        budget.check_interval = 1;
+        ASSERT_EQ(run(counted, budget, layout, 3), "ERROR : execution budget exceeded\nthe script exceeded its limit of 26 steps\n");
+    }
+
+    /* the scopes of the loop are left, the environment can run the next script */
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    mlang::script::Budget budget {};
+    budget.max_steps = 1000;
+    env.set_budget(budget);
+    ASSERT_EQ(mlang::script::Script { "var a = 1;\nwhile (true) { var b = 2; }" }.execute(env), 3);
+    ASSERT_EQ(env.get_steps(), 1001);
+    ASSERT_EQ(env.get_depth(), 1);
+    ASSERT_TRUE(env.has_variable("a"));
+    ASSERT_FALSE(env.has_variable("b"));
+    env.set_budget(mlang::script::Budget {});
+    ASSERT_EQ(mlang::script::Script { "for (var i = 0; i < 5000; i++) { a += 1; }" }.execute(env), 0);
+    ASSERT_EQ(env.get_variable("a").get_int(), 5001);
+}
+
+TEST(BudgetTest, Test1) {
+    std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { "while (true) { }" }.get_program();
+
+    /* a deadline */
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    mlang::script::Budget budget {};
+    budget.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds { 50 };
+    env.set_budget(budget);
+    ASSERT_EQ(program->execute(env), 3);
+    ASSERT_EQ(sink->get(), "ERROR : execution budget exceeded\nthe script exceeded its deadline\n");
+    ASSERT_GE(std::chrono::steady_clock::now(), *budget.deadline);
+
+    /* a token cancelled by another thread */
+    sink->clear();
+    std::shared_ptr<mlang::script::CancelToken> token = std::make_shared<mlang::script::CancelToken>();
+    budget = mlang::script::Budget {};
+    budget.cancel = token;
+    env.set_budget(budget);
+    std::thread canceller { [token] () {
+        std::this_thread::sleep_for(std::chrono::milliseconds { 20 });
+        token->cancel();
+    } };
+    ASSERT_EQ(program->execute(env), 3);
+    canceller.join();
+    ASSERT_EQ(sink->get(), "ERROR : execution budget exceeded\nthe script was cancelled\n");
+}
+
+TEST(BudgetTest, Test2) {
+    /* a task stuck in a loop yields, the other tasks of the loop still run and finally cancel it */
+    mlang::runtime::EventLoop loop {};
+    loop.set_time_slice(100);
+    std::shared_ptr<mlang::script::CancelToken> token = std::make_shared<mlang::script::CancelToken>();
+    std::shared_ptr<mlang::runtime::Task> spinner = loop.spawn(mlang::script::Script { "while (true) { }" }.get_program(), [token] (mlang::script::EnvStack& env) {
+        env.set_output(std::make_shared<mlang::script::StringSink>());
+        mlang::script::Budget budget {};
+        budget.cancel = token;
+        env.set_budget(budget);
+    });
+    std::shared_ptr<mlang::runtime::Task> worker = loop.spawn(mlang::script::Script { "var s = 0;\nfor (var i = 0; i < 1000; i++) { s += i; }\nexit s;" }.get_program(), nullptr,
+        [token] (mlang::runtime::Task&) { token->cancel(); });
+    loop.run();
+    ASSERT_EQ(worker->get_exit_code(), 0);
+    ASSERT_EQ(worker->get_value().get_int(), 499500);
+    ASSERT_EQ(spinner->get_exit_code(), 3);
+    ASSERT_GT(spinner->get_environment().get_steps(), 100);
+}
+
+TEST(BudgetTest, Test3) {
+    /* the workers of parallel_map run under the budget of the script that called it */
+    const std::string spin = "function spin(x) { var i = 0; while (i < 10000) { i++; } return x; }\nvar r = parallel_map({ 1, 2, 3, 4, 5, 6, 7, 8 }, \"spin\");";
+    mlang::runtime::Executor executor { 3 };
+    mlang::runtime::ParallelFunctions parallel { executor };
+    auto run_parallel = [&] (const mlang::script::Budget& budget) {
+        mlang::script::EnvStack env {};
+        env.set_output(std::make_shared<mlang::script::StringSink>());
+        parallel.declare_functions(env);
+        env.set_budget(budget);
+        const int result = mlang::script::Script { spin }.execute(env);
+        EXPECT_EQ(env.get_depth(), 1);
+        return std::make_pair(result, env.get_steps());
+    };
+    mlang::script::Budget budget {};
+    budget.max_steps = 1000;
+    ASSERT_EQ(run_parallel(budget).first, 3);
+
+    /* the steps of all workers count, and they are added to the steps of the caller */
+    budget.max_steps = 70000;
+    ASSERT_EQ(run_parallel(budget).first, 3);
+    budget.max_steps = 1000000;
+    const std::pair<int, std::uint64_t> done = run_parallel(budget);
+    ASSERT_EQ(done.first, 0);
+    ASSERT_GT(done.second, 80000);
+
+    /* the token and the deadline reach the workers too */
+    budget.cancel = std::make_shared<mlang::script::CancelToken>();
+    std::const_pointer_cast<mlang::script::CancelToken>(budget.cancel)->cancel();
+    ASSERT_EQ(run_parallel(budget).first, 3);
+    budget.cancel = nullptr;
+    budget.deadline = std::chrono::steady_clock::now();
+    ASSERT_EQ(run_parallel(budget).first, 3);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include "mlang/runtime/channel.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/exception.hpp"
+
+namespace {
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+mlang::object::Object make_channel (std::size_t capacity) { return mlang::object::Object { std::make_shared<mlang::runtime::Channel>(capacity) }; }
+
+/* the stages of a pipeline, each one passes the values on to the next channel */
+const std::string source_stage = "for (var i = 1; i <= 100; i++) { var v = i; out.send(v); }\nout.close();";
+const std::string double_stage = "var v = in.recv();\nwhile (v != none) { out.send(v * 2); v = in.recv(); }\nout.close();";
+const std::string sum_stage = "var sum = 0;\nvar v = in.recv();\nwhile (v != none) { sum += v; v = in.recv(); }\nexit sum;";
+
+} /* namespace */
+
+TEST(ChannelTest, Test0) {
+    mlang::runtime::Channel channel { 2 };
+    ASSERT_EQ(channel.get_capacity(), 2);
+    ASSERT_TRUE(channel.try_send(make_int(1)));
+    ASSERT_TRUE(channel.try_send(make_int(2)));
+    ASSERT_FALSE(channel.try_send(make_int(3)));
+    ASSERT_EQ(channel.get_size(), 2);
+    mlang::object::Object value {};
+    ASSERT_TRUE(channel.try_recv(value));
+    ASSERT_EQ(value.get_int(), 1);
+    ASSERT_EQ(channel.recv().get_int(), 2);
+    ASSERT_FALSE(channel.try_recv(value));
+    ASSERT_THROW(channel.send(mlang::object::Object {}), mlang::RuntimeError);
+
+    /* the receiver gets its own copy of an array */
+    std::shared_ptr<mlang::object::Array> array = std::make_shared<mlang::object::Array>(std::vector<mlang::object::Object> { make_int(7), make_int(8) });
+    channel.send(mlang::object::Object { array });
+    mlang::object::Object element = array->get_elements()[0];
+    element.assign(make_int(70));
+    const mlang::object::Object received = channel.recv();
+    ASSERT_EQ(received.get_string(), "Array : { 7 8 }");
+
+    /* a closed channel delivers what was sent before, then none */
+    channel.send(make_int(5));
+    ASSERT_TRUE(channel.close());
+    ASSERT_FALSE(channel.close());
+    ASSERT_TRUE(channel.is_closed());
+    ASSERT_THROW(channel.send(make_int(6)), mlang::RuntimeError);
+    ASSERT_FALSE(channel.try_send(make_int(6)));
+    ASSERT_EQ(channel.recv().get_int(), 5);
+    ASSERT_TRUE(channel.recv().is_none());
+    ASSERT_THROW(mlang::runtime::Channel { 0 }, mlang::RuntimeError);
+}
+
+TEST(ChannelTest, Test1) {
+    /* many senders and receivers on a small channel, every value arrives once */
+    mlang::runtime::Channel channel { 8 };
+    constexpr int senders = 4;
+    constexpr int values = 5000;
+    std::atomic<long> sum { 0 };
+    std::atomic<int> count { 0 };
+    std::vector<std::thread> receivers;
+    for (int r = 0; r < 4; ++r) {
+        receivers.emplace_back([&] () {
+            for (mlang::object::Object value = channel.recv(); !value.is_none(); value = channel.recv()) {
+                sum += value.get_int();
+                ++count;
+            }
+        });
+    }
+    std::vector<std::thread> threads;
+    for (int s = 0; s < senders; ++s) {
+        threads.emplace_back([&] () {
+            for (int i = 1; i <= values; ++i) { channel.send(make_int(i)); }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    channel.close();
+    for (std::thread& thread : receivers) { thread.join(); }
+    ASSERT_EQ(count.load(), senders * values);
+    ASSERT_EQ(sum.load(), senders * (static_cast<long>(values) * (values + 1) / 2));
+}
+
+TEST(ChannelTest, Test2) {
+    /* a pipeline of scripts on the workers of an executor, the channels are job inputs */
+    mlang::runtime::Channel::define_type();
+    mlang::runtime::Executor executor { 3 };
+    mlang::object::Object first = make_channel(4);
+    mlang::object::Object second = make_channel(4);
+    mlang::runtime::Job sum = executor.submit(mlang::script::Script { sum_stage }.get_program(), nullptr, { { "in", second } });
+    mlang::runtime::Job doubler = executor.submit(mlang::script::Script { double_stage }.get_program(), nullptr, { { "in", first }, { "out", second } });
+    mlang::runtime::Job source = executor.submit(mlang::script::Script { source_stage }.get_program(), nullptr, { { "out", first } });
+    ASSERT_EQ(source.get().exit_code, 0);
+    ASSERT_EQ(doubler.get().exit_code, 0);
+    mlang::runtime::JobResult result = sum.get();
+    ASSERT_EQ(result.exit_code, 0);
+    ASSERT_EQ(result.value.get_int(), 10100);
+}
+
+TEST(ChannelTest, Test3) {
+    /* the same pipeline on one event loop thread, waiting parks the task */
+    mlang::runtime::Channel::define_type();
+    mlang::runtime::EventLoop loop {};
+    mlang::object::Object first = make_channel(1);
+    mlang::object::Object second = make_channel(1);
+    auto inputs = [] (std::vector<std::pair<std::string, mlang::object::Object>> channels) {
+        return [channels] (mlang::script::EnvStack& env) {
+            for (const auto& channel : channels) {
+                env.declare_variable(channel.first, mlang::runtime::Channel::define_type());
+                env.get_variable(channel.first).assign(channel.second);
+            }
+        };
+    };
+    std::shared_ptr<mlang::runtime::Task> sum = loop.spawn(mlang::script::Script { sum_stage }.get_program(), inputs({ { "in", second } }));
+    loop.spawn(mlang::script::Script { double_stage }.get_program(), inputs({ { "in", first }, { "out", second } }));
+    loop.spawn(mlang::script::Script { source_stage }.get_program(), inputs({ { "out", first } }));
+    loop.run();
+    ASSERT_EQ(sum->get_exit_code(), 0);
+    ASSERT_EQ(sum->get_value().get_int(), 10100);
+
+    /* a script creates its own channel */
+    std::string script_text;
+    script_text += "var ch = new Channel(2);\n";
+    script_text += "print(\"%s %s \", ch.try_send({ 1, 2 }), ch.try_send(3));\n";
+    script_text += "print(\"%s %d %d \", ch.try_send(4), ch.length(), ch.capacity());\n";
+    script_text += "var a = ch.recv();\n";
+    script_text += "ch.close();\n";
+    script_text += "print(\"%d %d %s %s\", a[1], ch.recv(), ch.recv() == none, ch.try_recv() != none);\n";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    ASSERT_EQ(script.execute(env), 0);
+    env.get_output().flush();
+    ASSERT_EQ(sink->get(), "true true false 2 2 2 3 true false");
+}
+
+TEST(ChannelTest, Test4) {
+    /* a value is either refused by a send that races with the close or received, it is never left in the channel */
+    for (int round = 0; round < 50; ++round) {
+        mlang::runtime::Channel channel { 4 };
+        std::atomic<int> sent { 0 };
+        std::atomic<int> received { 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&] () {
+                try {
+                    while (true) {
+                        channel.send(make_int(1));
+                        ++sent;
+                    }
+                }
+                catch (const mlang::RuntimeError&) {}
+            });
+            threads.emplace_back([&] () {
+                while (!channel.recv().is_none()) { ++received; }
+            });
+        }
+        while (received.load() < 100) { std::this_thread::yield(); }
+        channel.close();
+        for (std::thread& thread : threads) { thread.join(); }
+        ASSERT_EQ(received.load(), sent.load());
+        ASSERT_EQ(channel.get_size(), 0);
+    }
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include "mlang/runtime/event_bus.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/object/string.hpp"
+#include "mlang/exception.hpp"
+
+TEST(EventBusTest, Test0) {
+    mlang::runtime::EventBus bus {};
+    bus.subscribe("observer", "number");
+    bus.subscribe("observer", "string");
+    bus.subscribe("observer", "number");
+    bus.subscribe("other", "number");
+
+    /* published twice before it was consumed -> delivered once */
+    ASSERT_EQ(bus.publish("number"), 2);
+    ASSERT_EQ(bus.publish("number"), 0);
+    ASSERT_EQ(bus.publish("string"), 1);
+    ASSERT_EQ(bus.publish("nobody"), 0);
+    std::string topic;
+    ASSERT_TRUE(bus.poll("observer", topic));
+    ASSERT_EQ(topic, "number");
+    ASSERT_EQ(bus.wait_for("observer"), "string");
+    ASSERT_FALSE(bus.poll("observer", topic));
+    ASSERT_EQ(bus.wait_for("other"), "number");
+
+    ASSERT_TRUE(bus.unsubscribe("other", "number"));
+    ASSERT_FALSE(bus.unsubscribe("other", "number"));
+    ASSERT_EQ(bus.publish("number"), 1);
+    ASSERT_THROW(bus.wait_for("unknown"), mlang::RuntimeError);
+
+    const mlang::runtime::EventBusStats stats = bus.get_stats();
+    ASSERT_EQ(stats.published, 5);
+    ASSERT_EQ(stats.delivered, 4);
+    ASSERT_EQ(stats.coalesced, 2);
+}
+
+TEST(EventBusTest, Test1) {
+    /* waiting scripts are parked, one publish resumes all of them */
+    mlang::runtime::EventBus bus {};
+    mlang::runtime::EventLoop loop {};
+    mlang::script::Script script { "subscribe(name, \"parameter\");\nvar changed = wait_for(name);\nexit changed;" };
+    std::shared_ptr<const mlang::script::Program> program = script.get_program();
+    std::vector<std::shared_ptr<mlang::runtime::Task>> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.push_back(loop.spawn(program, [&bus, i] (mlang::script::EnvStack& env) {
+            bus.declare_functions(env);
+            env.declare_variable("name", mlang::script::builtin_types::string);
+            env.get_variable("name").assign(mlang::object::Object { std::make_shared<mlang::object::String>("observer_" + std::to_string(i)) });
+        }));
+    }
+    /* the publisher runs once every task waits */
+    std::shared_ptr<const mlang::script::Program> publisher = mlang::script::Script { "var n = publish(\"parameter\");\nexit n;" }.get_program();
+    loop.post([&] () { tasks.push_back(loop.spawn(publisher, [&bus] (mlang::script::EnvStack& env) { bus.declare_functions(env); })); });
+    loop.run();
+    ASSERT_EQ(tasks.back()->get_value().get_int(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(tasks[i]->get_exit_code(), 0);
+        ASSERT_EQ(tasks[i]->get_value().get_string(), "parameter");
+    }
+}
+
+TEST(EventBusTest, Test2) {
+    /* threads block until their topic is published by another thread */
+    mlang::runtime::EventBus bus {};
+    constexpr int waiters = 8;
+    for (int i = 0; i < waiters; ++i) { bus.subscribe("waiter_" + std::to_string(i), "topic_" + std::to_string(i % 2)); }
+    std::atomic<int> woken { 0 };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < waiters; ++i) {
+        threads.emplace_back([&, i] () {
+            for (int round = 0; round < 50; ++round) {
+                if (bus.wait_for("waiter_" + std::to_string(i)) == "topic_" + std::to_string(i % 2)) { ++woken; }
+            }
+        });
+    }
+    std::thread publisher { [&] () {
+        while (woken.load() < waiters * 50) {
+            bus.publish("topic_0");
+            bus.publish("topic_1");
+            std::this_thread::yield();
+        }
+    } };
+    for (std::thread& thread : threads) { thread.join(); }
+    publisher.join();
+    ASSERT_EQ(woken.load(), waiters * 50);
+}
+
+TEST(EventBusTest, Test3) {
+    /* the waiter of a destroyed loop does not take the topic, it stays pending */
+    mlang::runtime::EventBus bus {};
+    bus.subscribe("observer", "parameter");
+    {
+        mlang::runtime::EventLoop loop {};
+        std::shared_ptr<mlang::runtime::Task> task = loop.spawn(mlang::script::Script { "var changed = wait_for(\"observer\");" }.get_program(), [&bus] (mlang::script::EnvStack& env) {
+            bus.declare_functions(env);
+        });
+        /* posted callbacks run before the ready tasks, the loop stops once the task waits */
+        loop.post([&loop] () { loop.post([&loop] () { loop.stop(); }); });
+        loop.run();
+        ASSERT_EQ(task->get_status(), mlang::runtime::task_status::suspended);
+    }
+    ASSERT_EQ(bus.publish("parameter"), 1);
+    std::string topic;
+    ASSERT_TRUE(bus.poll("observer", topic));
+    ASSERT_EQ(topic, "parameter");
+}
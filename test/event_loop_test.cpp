@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+std::shared_ptr<const mlang::script::Program> compile (const std::string& text) {
+    mlang::script::Script script { text };
+    return script.get_program();
+}
+
+/* lookup(n) -> n * 10, answered by another thread a little later */
+class LookupFunction : public mlang::func::Function {
+public:
+    mlang::object::Object call (mlang::script::EnvStack& env, std::vector<mlang::object::Object>& params) const override {
+        const int n = params.at(0).get_int();
+        return mlang::runtime::suspend([n] (mlang::runtime::Resumer resumer) {
+            std::thread { [resumer, n] () {
+                std::this_thread::sleep_for(std::chrono::milliseconds { 2 });
+                resumer.resume(mlang::object::Object { std::make_shared<mlang::object::Int>(n * 10) });
+            } }.detach();
+        });
+    }
+};
+
+/* never completes */
+class ForeverFunction : public mlang::func::Function {
+public:
+    mlang::object::Object call (mlang::script::EnvStack& env, std::vector<mlang::object::Object>& params) const override {
+        return mlang::runtime::suspend([] (mlang::runtime::Resumer) {});
+    }
+};
+
+const LookupFunction lookup {};
+const ForeverFunction forever {};
+
+} /* namespace */
+
+TEST(EventLoopTest, Test0) {
+    /* many sleeping scripts share the thread, they sleep at the same time */
+    std::shared_ptr<const mlang::script::Program> program = compile("var x = n;\nsleep(50);\nx += 1;\nsleep(50);\nexit x;");
+    mlang::runtime::EventLoop loop {};
+    std::vector<std::shared_ptr<mlang::runtime::Task>> tasks;
+    std::size_t finished = 0;
+    for (int n = 0; n < 1000; ++n) {
+        tasks.push_back(loop.spawn(program, [n] (mlang::script::EnvStack& env) {
+            mlang::runtime::declare_event_loop_functions(env);
+            env.declare_variable("n", mlang::script::builtin_types::integer);
+            env.get_variable("n").assign(mlang::object::Object { std::make_shared<mlang::object::Int>(n) });
+        }, [&finished] (mlang::runtime::Task&) { ++finished; }));
+    }
+    ASSERT_EQ(loop.get_task_count(), 1000);
+    const auto start = std::chrono::steady_clock::now();
+    loop.run();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds { 10 });
+    ASSERT_EQ(finished, 1000);
+    ASSERT_EQ(loop.get_task_count(), 0);
+    for (int n = 0; n < 1000; ++n) {
+        ASSERT_TRUE(tasks[n]->is_finished());
+        ASSERT_EQ(tasks[n]->get_exit_code(), 0);
+        ASSERT_EQ(tasks[n]->get_value().get_int(), n + 1);
+    }
+}
+
+TEST(EventLoopTest, Test1) {
+    /* resumed from other threads */
+    std::string text;
+    text += "function total(limit) { var sum = 0; for (var i = 0; i < limit; i++) { if (i > 0) { sum += i; } } return sum; }\n";
+    text += "var a = lookup(1);\n";
+    text += "var b = lookup(2);\n";
+    text += "print(\"%d %d %d\\n\", a, b, total(21));\n";
+    std::shared_ptr<const mlang::script::Program> program = compile(text);
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    auto initializer = [sink] (mlang::script::EnvStack& env) {
+        env.set_output(sink);
+        env.declare_function("lookup", &lookup);
+    };
+    {
+        mlang::runtime::EventLoop loop {};
+        std::shared_ptr<mlang::runtime::Task> task = loop.spawn(program, initializer);
+        ASSERT_EQ(task->get_status(), mlang::runtime::task_status::ready);
+        loop.run();
+        ASSERT_EQ(task->get_exit_code(), 0);
+    }
+    ASSERT_EQ(sink->get(), "10 20 210\n");
+
+    /* outside of a task the same host function blocks */
+    sink->clear();
+    mlang::script::EnvStack env {};
+    initializer(env);
+    ASSERT_EQ(program->execute(env), 0);
+    ASSERT_EQ(sink->get(), "10 20 210\n");
+}
+
+TEST(EventLoopTest, Test2) {
+    std::shared_ptr<mlang::runtime::Task> parked;
+    std::shared_ptr<mlang::runtime::Task> failed;
+    std::shared_ptr<mlang::runtime::Task> stopped;
+    {
+        mlang::runtime::EventLoop loop {};
+        parked = loop.spawn(compile("forever();\nexit 1;"), [] (mlang::script::EnvStack& env) { env.declare_function("forever", &forever); });
+        failed = loop.spawn(compile("exit 1;"), [] (mlang::script::EnvStack&) { throw std::logic_error { "initializer failed" }; });
+        /* stop ends 'run' while a task still waits */
+        loop.post([&loop] () { loop.stop(); });
+        loop.run();
+        ASSERT_EQ(parked->get_status(), mlang::runtime::task_status::suspended);
+        ASSERT_TRUE(failed->is_finished());
+        ASSERT_THROW(std::rethrow_exception(failed->get_error()), std::logic_error);
+        ASSERT_EQ(loop.get_task_count(), 1);
+        stopped = loop.spawn(compile("exit 1;"));
+    }
+    /* the loop is gone, the parked task was unwound */
+    ASSERT_TRUE(parked->is_finished());
+    ASSERT_EQ(parked->get_exit_code(), -1);
+    ASSERT_FALSE(parked->get_error());
+    ASSERT_EQ(stopped->get_exit_code(), -1);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <stdexcept>
+
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+std::shared_ptr<const mlang::script::Program> compile (const std::string& text) {
+    mlang::script::Script script { text };
+    return script.get_program();
+}
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+} /* namespace */
+
+TEST(ExecutorTest, Test0) {
+    std::shared_ptr<const mlang::script::Program> program = compile("var r = n * 2;\nfor (var i = 0; i < 10; i++) { r += 1; }\nexit r;");
+    mlang::runtime::Executor executor { 4 };
+    ASSERT_EQ(executor.get_thread_count(), 4);
+    std::vector<mlang::runtime::Job> jobs;
+    for (int n = 0; n < 500; ++n) {
+        jobs.push_back(executor.submit(program, nullptr, { { "n", make_int(n) } }));
+    }
+    for (int n = 0; n < 500; ++n) {
+        mlang::runtime::JobResult result = jobs[n].get();
+        ASSERT_EQ(result.exit_code, 0);
+        ASSERT_FALSE(result.cancelled);
+        ASSERT_EQ(result.value.get_int(), n * 2 + 10);
+        ASSERT_GE(result.cpu_time.count(), 0);
+    }
+    const mlang::runtime::ExecutorStats stats = executor.get_stats();
+    ASSERT_EQ(stats.submitted, 500);
+    ASSERT_EQ(stats.completed, 500);
+    ASSERT_EQ(stats.cancelled, 0);
+}
+
+TEST(ExecutorTest, Test1) {
+    /* one worker, kept busy until every job is queued */
+    mlang::runtime::Executor executor { 1 };
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&] (std::string name) {
+        return [&, name] (mlang::script::EnvStack&) {
+            std::lock_guard<std::mutex> lock { order_mutex };
+            order.push_back(name);
+        };
+    };
+    std::shared_ptr<const mlang::script::Program> program = compile("var x = 1;");
+    mlang::runtime::Job blocker = executor.submit(program, [released] (mlang::script::EnvStack&) { released.wait(); });
+    mlang::runtime::Job low = executor.submit(program, record("low"), {}, mlang::runtime::job_priority::low);
+    mlang::runtime::Job normal = executor.submit(program, record("normal"), {}, mlang::runtime::job_priority::normal);
+    mlang::runtime::Job dropped = executor.submit(program, record("dropped"), {}, mlang::runtime::job_priority::high);
+    mlang::runtime::Job high = executor.submit(program, record("high"), {}, mlang::runtime::job_priority::high);
+    ASSERT_TRUE(dropped.cancel());
+    ASSERT_FALSE(dropped.cancel());
+    release.set_value();
+
+    ASSERT_EQ(blocker.get().exit_code, 0);
+    ASSERT_EQ(low.get().exit_code, 0);
+    ASSERT_EQ(normal.get().exit_code, 0);
+    ASSERT_EQ(high.get().exit_code, 0);
+    const mlang::runtime::JobResult result = dropped.get();
+    ASSERT_TRUE(result.cancelled);
+    ASSERT_EQ(result.exit_code, -1);
+    ASSERT_FALSE(high.cancel());
+    ASSERT_EQ(order, (std::vector<std::string> { "high", "normal", "low" }));
+    ASSERT_EQ(executor.get_stats().cancelled, 1);
+}
+
+TEST(ExecutorTest, Test2) {
+    mlang::runtime::Executor executor { 2 };
+    /* script errors are reported through the exit code and the output of the job */
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    mlang::runtime::Job failing = executor.submit(compile("print(\"%d\\n\", missing);"), [sink] (mlang::script::EnvStack& env) { env.set_output(sink); });
+    ASSERT_EQ(failing.get().exit_code, 2);
+    ASSERT_EQ(sink->get().substr(0, 30), "ERROR : runtime error occurred");
+
+    /* any other exception reaches the caller */
+    mlang::runtime::Job throwing = executor.submit(compile("var x = 1;"), [] (mlang::script::EnvStack&) { throw std::logic_error { "initializer failed" }; });
+    ASSERT_THROW(throwing.get(), std::logic_error);
+
+    /* the queued jobs still run when the executor is destroyed */
+    std::vector<std::future<mlang::runtime::JobResult>> results;
+    {
+        mlang::runtime::Executor shortlived { 2 };
+        for (int i = 0; i < 20; ++i) {
+            mlang::runtime::Job job = shortlived.submit(compile("exit 7;"));
+            results.push_back(std::move(job.get_future()));
+        }
+    }
+    for (std::future<mlang::runtime::JobResult>& result : results) {
+        ASSERT_EQ(result.get().value.get_int(), 7);
+    }
+    ASSERT_THROW(executor.submit(nullptr), mlang::RuntimeError);
+}
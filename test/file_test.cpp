@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/file.hpp"
+#include "mlang/script/output.hpp"
+
+namespace {
+
+std::string write_temp_file (const std::string& name, const std::string& content) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file { path, std::ios::binary };
+    file << content;
+    return path.string();
+}
+
+} /* namespace */
+
+TEST(FileTest, Test0) {
+    const std::string path = write_temp_file("mlang_file_test_0.mlang", "var a = 5;\nprint(\"%d %s\\n\", a, \"plain\");");
+    mlang::script::Script script = mlang::script::Script::from_file(path);
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    ASSERT_EQ(script.execute(env), 0);
+    ASSERT_EQ(sink->get(), "5 plain\n");
+
+    ASSERT_THROW(mlang::script::Script::from_file(path + ".missing"), mlang::RuntimeError);
+    std::filesystem::remove(path);
+}
+
+TEST(FileTest, Test1) {
+    const std::string path = write_temp_file("mlang_file_test_1.txt", "line 0\nline 1\nline 2");
+    std::shared_ptr<const mlang::script::MappedFile> file = mlang::script::MappedFile::open(path);
+    ASSERT_TRUE(file->is_mapped());
+    ASSERT_EQ(file->get_text(), "line 0\nline 1\nline 2");
+
+    /* files without a size (pipes, procfs) are read into memory */
+    std::shared_ptr<const mlang::script::MappedFile> status = mlang::script::MappedFile::open("/proc/self/status");
+    ASSERT_FALSE(status->is_mapped());
+    ASSERT_FALSE(status->get_text().empty());
+
+    std::string script_text;
+    script_text += "var mapped = map_file(\"" + path + "\");\n";
+    script_text += "var copied = read_file(\"" + path + "\");\n";
+    script_text += "var line = mapped.get_line(1, \"\\n\");\n";
+    script_text += "var same = mapped == copied;\n";
+    script_text += "mapped += \"!\";\n";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    mlang::script::declare_file_functions(env);
+    ASSERT_EQ(script.execute(env), 0);
+    ASSERT_EQ(env.get_variable("line").get_string(), "line 1");
+    ASSERT_TRUE(env.get_variable("same").is_true());
+    ASSERT_EQ(env.get_variable("mapped").get_string(), "line 0\nline 1\nline 2!");
+    ASSERT_EQ(env.get_variable("copied").get_string(), "line 0\nline 1\nline 2");
+    std::filesystem::remove(path);
+}
+
+TEST(FileTest, Test2) {
+    auto owner = std::make_shared<std::string>("abcdef");
+    mlang::object::String view { std::string_view { *owner }.substr(1, 3), owner };
+    ASSERT_TRUE(view.is_view());
+    ASSERT_EQ(view.view(), "bcd");
+    ASSERT_EQ(view.view().data(), owner->data() + 1);
+    ASSERT_EQ(view.get_string(), "bcd");
+    /* get works on a const string, it keeps a copy and the string still refers to the text */
+    const mlang::object::String& constant = view;
+    ASSERT_EQ(constant.get(), "bcd");
+    ASSERT_EQ(&constant.get(), &constant.get());
+    ASSERT_TRUE(view.is_view());
+    /* modifying the string copies the text first */
+    view.operator_add_equal(std::make_shared<mlang::object::String>("x"));
+    ASSERT_FALSE(view.is_view());
+    ASSERT_EQ(view.view(), "bcdx");
+    ASSERT_EQ(*owner, "abcdef");
+}
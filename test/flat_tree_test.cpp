@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <memory>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/ast/flat_tree.hpp"
+
+namespace {
+
+/* runs the script with the given layout and returns what it printed */
+std::string run (const std::string& script_text, mlang::script::ast_layout layout, int expected_result = 0) {
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    EXPECT_EQ(script.execute(env, layout), expected_result);
+    return sink->get();
+}
+
+} /* namespace */
+
+TEST(FlatTreeTest, Test0) {
+    ASSERT_EQ(sizeof(mlang::ast::FlatNode), 16);
+
+    std::string script_text;
+    script_text += "var a = 5;\n";
+    script_text += "var b = a * 2 + 3;\n";
+    script_text += "var s = \"abc\";\n";
+    script_text += "s += \"def\";\n";
+    script_text += "var arr = { 1, 2.5, \"x\" };\n";
+    script_text += "arr += b;\n";
+    script_text += "print(\"%d %d %s %s %d\\n\", a, b, s, arr[2], arr[3]);\n";
+    script_text += "print(\"%d %d %d %d\\n\", a++, ++a, a--, --a);\n";
+    script_text += "print(\"%s %s %s\\n\", !(a == 5), -a, (a >= 5) && (b < 14) || false);\n";
+    script_text += "print(\"%d %s\\n\", s.length(), format(\"<%s>\", s));\n";
+    const std::string tree = run(script_text, mlang::script::ast_layout::tree);
+    ASSERT_EQ(run(script_text, mlang::script::ast_layout::flat), tree);
+    ASSERT_EQ(tree.substr(0, 16), "5 13 abcdef x 13");
+}
+
+TEST(FlatTreeTest, Test1) {
+    std::string script_text;
+    script_text += "function square(n) {\n";
+    script_text += "    if (n < 2) { return n; }\n";
+    script_text += "    return n * n;\n";
+    script_text += "}\n";
+    script_text += "var sum = 0;\n";
+    script_text += "for (var i = 0; i < 10; i++) {\n";
+    script_text += "    if (i == 2) { continue; }\n";
+    script_text += "    else if (i == 8) { break; }\n";
+    script_text += "    else { sum += square(i); }\n";
+    script_text += "}\n";
+    script_text += "var j = 0;\n";
+    script_text += "while (j < 100) {\n";
+    script_text += "    j += 7;\n";
+    script_text += "    if (j > 50) { break; }\n";
+    script_text += "}\n";
+    script_text += "for (; j > 0; j -= 1) { if (j < 50) { break; } }\n";
+    script_text += "print(\"%d %d\\n\", sum, j);\n";
+    const std::string tree = run(script_text, mlang::script::ast_layout::tree);
+    ASSERT_EQ(tree, "136 49\n");
+    ASSERT_EQ(run(script_text, mlang::script::ast_layout::flat), tree);
+}
+
+TEST(FlatTreeTest, Test2) {
+    /* errors are reported the same way */
+    ASSERT_EQ(run("var a = 1;\nprint(\"%d\\n\", a);\nprint(\"%d\\n\", b);", mlang::script::ast_layout::flat, 2),
+              run("var a = 1;\nprint(\"%d\\n\", a);\nprint(\"%d\\n\", b);", mlang::script::ast_layout::tree, 2));
+    ASSERT_EQ(run("function f(x) { return x; }\nf(1, 2);", mlang::script::ast_layout::flat, 2),
+              run("function f(x) { return x; }\nf(1, 2);", mlang::script::ast_layout::tree, 2));
+    ASSERT_EQ(run("var a = ;", mlang::script::ast_layout::flat, 1),
+              run("var a = ;", mlang::script::ast_layout::tree, 1));
+
+    /* every loop iteration leaves its scope, the variables declared in the body do not leak */
+    std::string script_text = "var i = 0;\nwhile (i < 3) { var t = i; i++; }\nprint(\"%d\\n\", i);";
+    mlang::script::Script script { script_text };
+    for (mlang::script::ast_layout layout : { mlang::script::ast_layout::tree, mlang::script::ast_layout::flat }) {
+        mlang::script::EnvStack env {};
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        env.set_output(sink);
+        ASSERT_EQ(script.execute(env, layout), 0);
+        ASSERT_EQ(sink->get(), "3\n");
+        ASSERT_FALSE(env.has_variable("t"));
+    }
+}
+
+TEST(FlatTreeTest, Test3) {
+    /* the tree layout finds the error in the body on the first call, the scopes entered until then are left */
+    const std::string script_text = "var a = 1;\nfunction f() { var x = ; }\nif (a == 1) { while (true) { f(); } }";
+    for (mlang::script::ast_layout layout : { mlang::script::ast_layout::tree, mlang::script::ast_layout::flat }) {
+        mlang::script::Script script { script_text };
+        mlang::script::EnvStack env {};
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        env.set_output(sink);
+        ASSERT_EQ(script.execute(env, layout), 1);
+        ASSERT_EQ(env.get_depth(), 1);
+        ASSERT_EQ(sink->get().substr(0, 29), "ERROR : syntax error occurred");
+    }
+}
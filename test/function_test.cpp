@@ -1,8 +1,17 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <thread>
+#include <memory>
 
 #include "mlang/script/script.hpp"
+#include "mlang/script/lexer.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/parser/parser.hpp"
+#include "mlang/ast/main_node.hpp"
+#include "mlang/ast/func_decl_node.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/array.hpp"
 
 TEST(FunctionTest, Test0) {
     std::string script_text;
@@ -21,4 +30,83 @@ TEST(FunctionTest, Test0) {
     ASSERT_EQ(env.has_variable("a"), false);
     ASSERT_EQ(env.has_variable("b"), false);
     ASSERT_EQ(env.has_variable("c"), false);
-}
\ No newline at end of file
+}
+
+TEST(FunctionTest, Test1) {
+    /* bodies are compiled by their first call */
+    std::string script_text;
+    script_text += "function used (a) { return a * 2; }\n";
+    script_text += "function unused (a) { if (a) { return { a, a }; } }\n";
+    script_text += "var num = used(21);\n";
+    mlang::script::Source source { script_text };
+    mlang::script::Lexer lexer { source };
+    std::shared_ptr<const std::vector<mlang::script::Token>> tokens = std::make_shared<const std::vector<mlang::script::Token>>(lexer.tokenize());
+    mlang::parser::Parser parser {};
+    mlang::ast::node_ptr root = parser.parse(tokens);
+    const mlang::ast::MainNode& main = static_cast<const mlang::ast::MainNode&>(*root);
+    const mlang::ast::FunctionDeclNode& used = static_cast<const mlang::ast::FunctionDeclNode&>(*main.get_nodes()[0]);
+    const mlang::ast::FunctionDeclNode& unused = static_cast<const mlang::ast::FunctionDeclNode&>(*main.get_nodes()[1]);
+    ASSERT_FALSE(used.is_compiled());
+    tokens.reset();   /* the tree keeps the tokens alive */
+    mlang::script::EnvStack env {};
+    root->execute(env);
+    ASSERT_EQ(env.get_variable("num").get_int(), 42);
+    ASSERT_TRUE(used.is_compiled());
+    ASSERT_FALSE(unused.is_compiled());
+
+    /* every thread waits for the one compiling the body */
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&unused, &results, i] () {
+            mlang::script::EnvStack thread_env {};
+            std::vector<mlang::object::Object> params { mlang::object::Object { std::make_shared<mlang::object::Int>(static_cast<int>(i)) } };
+            mlang::object::Object value = unused.call(thread_env, params);
+            results[i] = (value.get_typename() == mlang::object::Array::type_name) ? 1 : 2;
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    ASSERT_TRUE(unused.is_compiled());
+    ASSERT_EQ(results, (std::vector<int> { 2, 1, 1, 1 }));
+}
+
+TEST(FunctionTest, Test2) {
+    /* a syntax error in a body is reported by the first call */
+    std::string script_text;
+    script_text += "function broken (a) { return a +; }\n";
+    script_text += "print(\"before\\n\");\n";
+    script_text += "broken(1);\n";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    ASSERT_EQ(script.execute(env), 1);
+    ASSERT_EQ(sink->get().substr(0, 36), "before\nERROR : syntax error occurred");
+    /* the precompiled layout still reports it before running */
+    ASSERT_EQ(script.execute(env, mlang::script::ast_layout::flat), 1);
+
+    mlang::script::Script unclosed { "function f () { var a = 1;\nvar b = 2;" };
+    ASSERT_EQ(unclosed.execute(env), 1);
+}
+
+TEST(FunctionTest, Test3) {
+    /* parsed while lexing, bodies are lexed again from the source by their first call */
+    std::string script_text;
+    script_text += "function greet (name) { return format(\"hi\\t%s\", name); }\n";
+    script_text += "function broken () {\n    return 1 +;\n}\n";
+    script_text += "var text = greet(\"a\");\n";
+    std::shared_ptr<mlang::script::Source> source = std::make_shared<mlang::script::Source>(script_text);
+    mlang::parser::Parser parser {};
+    mlang::ast::node_ptr root = parser.parse(source);
+    mlang::script::EnvStack env {};
+    root->execute(env);
+    ASSERT_EQ(env.get_variable("text").get_string(), "hi\ta");
+    try {
+        std::vector<mlang::object::Object> params {};
+        env.get_function("broken")->call(env, params);
+        FAIL();
+    }
+    catch (const mlang::SyntaxError& e) {
+        ASSERT_NE(std::string { e.what() }.find("line 3"), std::string::npos);
+    }
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#include "mlang/runtime/future.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/exception.hpp"
+
+namespace {
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+/* a slow host call, it counts how many of them run at the same time */
+class SlowLookup {
+public:
+    std::atomic<int> running { 0 };
+    std::atomic<int> most_running { 0 };
+
+    mlang::object::Object operator() (const std::vector<mlang::object::Object>& params) {
+        if (params.size() != 1) { throw mlang::RuntimeError{"lookup expects 1 parameter"}; }
+        if (params[0].get_int() == -2) { throw std::out_of_range{"key out of range"}; }
+        if (params[0].get_int() < 0) { throw mlang::RuntimeError{"no such key"}; }
+        const int now = ++running;
+        int most = most_running.load();
+        while (now > most && !most_running.compare_exchange_weak(most, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --running;
+        return make_int(params[0].get_int() * 2);
+    }
+};
+
+std::string run (const std::string& script_text, mlang::script::EnvStack& env, int expected_result = 0) {
+    mlang::script::Script script { script_text };
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    EXPECT_EQ(script.execute(env), expected_result);
+    env.get_output().flush();
+    return sink->get();
+}
+
+/* twenty lookups are started before the first result is used */
+const std::string fan_out_script =
+    "var pending = {};\n"
+    "for (var i = 1; i <= 20; i++) { var v = i; pending += lookup(v); }\n"
+    "var results = await(pending);\n"
+    "var sum = 0;\n"
+    "for (var j = 0; j < 20; j++) { sum += results[j]; }\n"
+    "exit sum;";
+
+} /* namespace */
+
+TEST(FutureTest, Test0) {
+    std::pair<mlang::object::Object, mlang::runtime::Promise> future = mlang::runtime::Future::create();
+    const std::shared_ptr<mlang::runtime::Future> state = std::dynamic_pointer_cast<mlang::runtime::Future>(future.first.get_internal());
+    ASSERT_FALSE(state->is_ready());
+    std::thread completer { [promise = future.second] () {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        promise.set_value(make_int(42));
+    } };
+    ASSERT_EQ(state->wait().get_int(), 42);
+    completer.join();
+    ASSERT_TRUE(state->is_ready());
+    ASSERT_FALSE(future.second.set_value(make_int(1)));
+    ASSERT_FALSE(future.second.set_error("late"));
+    ASSERT_EQ(future.first.get_int(), 42);
+
+    /* a failed future throws wherever its value is used */
+    std::pair<mlang::object::Object, mlang::runtime::Promise> failed = mlang::runtime::Future::create();
+    ASSERT_TRUE(failed.second.set_error("lookup failed"));
+    ASSERT_THROW(failed.first.get_int(), mlang::RuntimeError);
+
+    /* a promise dropped without a result breaks its future */
+    mlang::object::Object broken {};
+    {
+        std::pair<mlang::object::Object, mlang::runtime::Promise> abandoned = mlang::runtime::Future::create();
+        broken = abandoned.first;
+    }
+    ASSERT_THROW(broken.get_int(), mlang::RuntimeError);
+}
+
+TEST(FutureTest, Test1) {
+    mlang::runtime::Executor executor { 4 };
+    std::shared_ptr<SlowLookup> lookup = std::make_shared<SlowLookup>();
+    const mlang::runtime::OffloadedFunction function { executor, [lookup] (const std::vector<mlang::object::Object>& params) { return (*lookup)(params); } };
+
+    mlang::script::EnvStack env {};
+    env.declare_function("lookup", &function);
+    mlang::runtime::declare_future_functions(env);
+
+    /* the value of a future can be used like the result itself */
+    std::string script_text;
+    script_text += "var f = lookup(21);\n";
+    script_text += "var g = lookup(5);\n";
+    script_text += "print(\"%s %d \", f.ready() || !f.ready(), f + 1);\n";
+    script_text += "print(\"%d %d %d %s \", 1 + g, await(g), f.get(), f == 42);\n";
+    script_text += "print(\"%d\", await(7));\n";
+    ASSERT_EQ(run(script_text, env), "true 43 11 10 42 true 7");
+
+    /* a failed lookup is a runtime error at the point of use */
+    mlang::script::EnvStack failing {};
+    failing.declare_function("lookup", &function);
+    mlang::runtime::declare_future_functions(failing);
+    ASSERT_EQ(run("var f = lookup(-1);\nprint(\"started \");\nprint(\"%d\", await(f));", failing, 2).substr(0, 8), "started ");
+    /* so is any other exception of the host call, with its own message */
+    const std::string output = run("var g = lookup(-2);\nprint(\"%d\", await(g));", failing, 2);
+    ASSERT_NE(output.find("key out of range"), std::string::npos);
+
+    /* the lookups of one script overlap */
+    mlang::script::EnvStack fan_out {};
+    fan_out.declare_function("lookup", &function);
+    mlang::runtime::declare_future_functions(fan_out);
+    mlang::object::Object sum {};
+    ASSERT_EQ(mlang::script::Script { fan_out_script }.get_program()->execute(fan_out, sum), 0);
+    ASSERT_EQ(sum.get_int(), 420);
+    ASSERT_GT(lookup->most_running.load(), 1);
+}
+
+TEST(FutureTest, Test2) {
+    /* inside an event loop awaiting parks the task, the other tasks keep running */
+    mlang::runtime::Executor executor { 4 };
+    std::shared_ptr<SlowLookup> lookup = std::make_shared<SlowLookup>();
+    const mlang::runtime::OffloadedFunction function { executor, [lookup] (const std::vector<mlang::object::Object>& params) { return (*lookup)(params); } };
+    mlang::runtime::EventLoop loop {};
+    std::vector<std::shared_ptr<mlang::runtime::Task>> tasks;
+    const std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { fan_out_script }.get_program();
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(loop.spawn(program, [&function] (mlang::script::EnvStack& env) {
+            env.declare_function("lookup", &function);
+            mlang::runtime::declare_future_functions(env);
+        }));
+    }
+    loop.run();
+    for (const std::shared_ptr<mlang::runtime::Task>& task : tasks) {
+        ASSERT_EQ(task->get_exit_code(), 0);
+        ASSERT_EQ(task->get_value().get_int(), 420);
+    }
+    ASSERT_GT(lookup->most_running.load(), 1);
+}
+
+TEST(FutureTest, Test3) {
+    /* a job awaiting host calls offloaded to its own executor runs them itself if every worker is busy */
+    for (std::size_t threads : { 1, 4 }) {
+        mlang::runtime::Executor executor { threads };
+        std::shared_ptr<SlowLookup> lookup = std::make_shared<SlowLookup>();
+        const mlang::runtime::OffloadedFunction function { executor, [lookup] (const std::vector<mlang::object::Object>& params) { return (*lookup)(params); } };
+        const std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { fan_out_script }.get_program();
+        std::vector<mlang::runtime::Job> jobs;
+        for (std::size_t i = 0; i < threads; ++i) {
+            jobs.push_back(executor.submit(program, [&function] (mlang::script::EnvStack& env) {
+                env.declare_function("lookup", &function);
+                mlang::runtime::declare_future_functions(env);
+            }));
+        }
+        for (mlang::runtime::Job& job : jobs) {
+            ASSERT_EQ(job.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+            const mlang::runtime::JobResult result = job.get();
+            ASSERT_EQ(result.exit_code, 0);
+            ASSERT_EQ(result.value.get_int(), 420);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/int.hpp"
+
+namespace {
+
+std::string rule_text () {
+    std::string script_text;
+    script_text += "function classify(v) {\n";
+    script_text += "    if (v > 1000) { return \"large\"; }\n";
+    script_text += "    return \"plain\";\n";
+    script_text += "}\n";
+    script_text += "var label = \"n=\";\n";
+    script_text += "label += format(\"%d\", n);\n";
+    script_text += "var values = { 1, 2, 3 };\n";
+    script_text += "values[0] += n;\n";
+    script_text += "var total = 0;\n";
+    script_text += "for (var i = 0; i < 3; i++) { total += values[i]; }\n";
+    script_text += "var c = new Int(n);\n";
+    script_text += "c++;\n";
+    script_text += "print(\"%s %d %s %d\\n\", label, total, classify(n), c);\n";
+    return script_text;
+}
+
+std::string expected (int n) {
+    return "n=" + std::to_string(n) + " " + std::to_string(n + 6) + " " + ((n > 1000) ? "large" : "plain") + " " + std::to_string(n + 1) + "\n";
+}
+
+} /* namespace */
+
+TEST(IsolateTest, Test0) {
+    /* one compiled copy, every thread runs its own inputs through its own isolate */
+    mlang::script::Script script { rule_text() };
+    std::shared_ptr<const mlang::script::Program> program = script.get_program();
+
+    constexpr int thread_count = 8;
+    constexpr int inputs = 250;
+    std::atomic<int> failures { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] () {
+            mlang::script::Isolate isolate { program };
+            std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+            isolate.get_environment().set_output(sink);
+            for (int i = 0; i < inputs; ++i) {
+                const int n = t * inputs + i;
+                isolate.reset();
+                mlang::script::EnvStack& env = isolate.get_environment();
+                env.declare_variable("n", mlang::script::builtin_types::integer);
+                env.get_variable("n").assign(mlang::object::Object { std::make_shared<mlang::object::Int>(n) });
+                sink->clear();
+                if ((isolate.run() != 0) || (sink->get() != expected(n))) { ++failures; }
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    ASSERT_EQ(failures.load(), 0);
+}
+
+TEST(IsolateTest, Test1) {
+    /* the literals of the program are never modified by an execution */
+    mlang::script::Script script { "var a = { 1, 2 };\na[0]++;\nvar k = 0;\nfor (var i = 0; i < 3; i++) { k = 5++; }\nprint(\"%d %d %d\\n\", 5++, a[0], k);" };
+    std::shared_ptr<const mlang::script::Program> program = script.get_program();
+    for (int i = 0; i < 3; ++i) {
+        mlang::script::Isolate isolate { program };
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        isolate.get_environment().set_output(sink);
+        ASSERT_EQ(isolate.run(), 0);
+        ASSERT_EQ(sink->get(), "5 2 5\n");
+        ASSERT_TRUE(isolate.get_environment().has_variable("a"));
+        isolate.reset();
+        ASSERT_FALSE(isolate.get_environment().has_variable("a"));
+    }
+
+    /* runtime errors are reported per isolate */
+    mlang::script::Script failing { "print(\"%d\\n\", missing);" };
+    mlang::script::Isolate isolate { failing.get_program() };
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    isolate.get_environment().set_output(sink);
+    ASSERT_EQ(isolate.run(), 2);
+    ASSERT_EQ(sink->get().substr(0, 30), "ERROR : runtime error occurred");
+
+    /* an exit from inside a function and a loop leaves the scopes they entered */
+    mlang::script::Script leaving { "var kept = 4;\nfunction stop(v) { for (var i = 0; i < 3; i++) { if (i == v) { exit i; } } }\nstop(1);" };
+    mlang::script::Isolate exiting { leaving.get_program() };
+    const std::size_t depth = exiting.get_environment().get_depth();
+    ASSERT_EQ(exiting.run(), 0);
+    ASSERT_EQ(exiting.get_environment().get_depth(), depth);
+    ASSERT_TRUE(exiting.get_environment().has_variable("kept"));
+    ASSERT_FALSE(exiting.get_environment().has_variable("i"));
+
+    /* the script compiles once and hands out the same tree */
+    ASSERT_EQ(&script.get_program()->get_tree(), &program->get_tree());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "mlang/script/lexer.hpp"
+#include "mlang/script/keywords.hpp"
+#include "mlang/exception.hpp"
+
+using mlang::script::token_types;
+
+namespace {
+
+std::vector<mlang::script::Token> lex (mlang::script::Source& source) {
+    mlang::script::Lexer lexer { source };
+    return lexer.tokenize();
+}
+
+} /* namespace */
+
+TEST(LexerTest, Test0) {
+    mlang::script::Source source { "a+=1;b++;c<<=d>>e;f!=g&&h||i<=j;" };
+    std::vector<mlang::script::Token> tokens = lex(source);
+    std::vector<token_types> expected {
+        token_types::identifier, token_types::plus_equal, token_types::integer, token_types::semicolon,
+        token_types::identifier, token_types::plus_plus, token_types::semicolon,
+        token_types::identifier, token_types::double_less_eq, token_types::identifier, token_types::double_greater_than, token_types::identifier, token_types::semicolon,
+        token_types::identifier, token_types::exclamation_equal, token_types::identifier, token_types::double_ampersand, token_types::identifier,
+        token_types::double_pipe, token_types::identifier, token_types::less_equal, token_types::identifier, token_types::semicolon
+    };
+
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(tokens[i].type, expected[i]);
+    }
+}
+
+TEST(LexerTest, Test1) {
+    std::string source;
+    source += "/* comment with 'quotes' and \"strings\"\n";
+    source += "   over two lines */\n";
+    source += "if (x) {} else if (y) {} else {}\n";
+    source += "  var s = \"a\\tb\\\"c\";";
+    mlang::script::Source owner { std::move(source) };
+    std::vector<mlang::script::Token> tokens = lex(owner);
+
+    ASSERT_EQ(tokens.size(), 20);
+    ASSERT_EQ(tokens[0].type, token_types::kw_if);
+    ASSERT_EQ(tokens[0].line, 3);
+    ASSERT_EQ(tokens[0].pos, 1);
+    ASSERT_EQ(tokens[6].type, token_types::kw_elif);
+    ASSERT_EQ(tokens[6].pos, 11);
+    ASSERT_EQ(tokens[12].type, token_types::kw_else);
+    ASSERT_EQ(tokens[14].type, token_types::curly_bracket_close);
+    ASSERT_EQ(tokens[15].type, token_types::kw_var);
+    ASSERT_EQ(tokens[15].line, 4);
+    ASSERT_EQ(tokens[15].pos, 3);
+    ASSERT_EQ(tokens[18].type, token_types::string);
+    ASSERT_EQ(tokens[18].value_str, "a\tb\"c");
+    ASSERT_EQ(tokens[19].type, token_types::semicolon);
+}
+
+TEST(LexerTest, Test2) {
+    mlang::script::Source source { "1.5.x 12abc" };
+    std::vector<mlang::script::Token> tokens = lex(source);
+
+    ASSERT_EQ(tokens.size(), 5);
+    ASSERT_EQ(tokens[0].type, token_types::floating);
+    ASSERT_EQ(tokens[0].value_float, 1.5);
+    ASSERT_EQ(tokens[1].type, token_types::dot);
+    ASSERT_EQ(tokens[2].type, token_types::identifier);
+    ASSERT_EQ(tokens[3].type, token_types::integer);
+    ASSERT_EQ(tokens[3].value_int, 12);
+    ASSERT_EQ(tokens[4].type, token_types::identifier);
+    ASSERT_EQ(tokens[4].value_str, "abc");
+}
+
+TEST(LexerTest, Test3) {
+    for (const char* text : { "var s = \"abc;", "var s = \"a\\qc\";", "/* never closed", "var c = 'a';", "var i = 99999999999;" }) {
+        mlang::script::Source source { text };
+        ASSERT_THROW(lex(source), mlang::SyntaxError);
+    }
+}
+
+TEST(LexerTest, Test4) {
+    for (const mlang::script::Keyword& keyword : mlang::script::keyword_list) {
+        ASSERT_EQ(mlang::script::keyword_type(keyword.word), keyword.type);
+    }
+    for (const char* word : { "", "i", "iff", "Print", "elseif", "vars", "functio", "n", "_var", "retur" }) {
+        ASSERT_EQ(mlang::script::keyword_type(word), token_types::identifier);
+    }
+}
+
+TEST(LexerTest, Test5) {
+    mlang::script::Source source { "var plain = \"abc\";\nprint(\"x\\ty\");" };
+    std::vector<mlang::script::Token> tokens = lex(source);
+    const std::string_view text = source.get_text();
+
+    /* identifiers and plain literals point into the text, only the escaped literal is a copy */
+    ASSERT_EQ(tokens[1].value_str, "plain");
+    ASSERT_EQ(tokens[1].value_str.data(), text.data() + 4);
+    ASSERT_EQ(tokens[3].value_str, "abc");
+    ASSERT_EQ(tokens[3].value_str.data(), text.data() + 13);
+    ASSERT_EQ(tokens[7].type, token_types::string);
+    ASSERT_EQ(tokens[7].value_str, "x\ty");
+    ASSERT_TRUE((tokens[7].value_str.data() < text.data()) || (tokens[7].value_str.data() >= text.data() + text.size()));
+    ASSERT_EQ(source.get_size(), text.size() + 3);
+}
+
+TEST(LexerTest, Test6) {
+    /* pulling one token at a time gives the same tokens as lexing everything */
+    mlang::script::Source source { "if (a) { b = \"x\\ty\"; }\nelse /* c */ if (c) { d += 1.5; }\nelse { e--; }" };
+    std::vector<mlang::script::Token> tokens = lex(source);
+    mlang::script::Lexer lexer { source };
+    mlang::script::Token token { token_types::none, 0, 0 };
+    std::size_t offset = 0;
+    std::size_t count = 0;
+    while (lexer.next(token, offset)) {
+        ASSERT_LT(count, tokens.size());
+        ASSERT_EQ(token.type, tokens[count].type);
+        ASSERT_EQ(token.line, tokens[count].line);
+        ASSERT_EQ(token.pos, tokens[count].pos);
+        ASSERT_EQ(token.value_str, tokens[count].value_str);
+        ++count;
+    }
+    ASSERT_EQ(count, tokens.size());
+    ASSERT_EQ(tokens[10].type, token_types::kw_elif);
+
+    /* a lexer started in the middle reports the positions of the whole text */
+    const std::size_t brace = source.get_text().find('{', 30);
+    mlang::script::Lexer middle { source, 2, brace, brace - source.get_text().find('\n') };
+    ASSERT_TRUE(middle.next(token, offset));
+    ASSERT_EQ(offset, brace);
+    ASSERT_EQ(token.type, token_types::curly_bracket_open);
+    ASSERT_EQ(token.line, tokens[14].line);
+    ASSERT_EQ(token.pos, tokens[14].pos);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <sstream>
 
 #include "mlang/object/object.hpp"
 #include "mlang/object/int.hpp"
@@ -9,6 +10,7 @@
 #include "mlang/object/boolean.hpp"
 #include "mlang/object/array.hpp"
 #include "mlang/object/none.hpp"
+#include "mlang/object/serializer.hpp"
 #include "mlang/script/environment.hpp"
 
 TEST(ObjectTest, Test0) {
@@ -159,4 +161,59 @@ TEST(ObjectTest, Test6) {
     ASSERT_EQ(a.get_typename(), mlang::object::String::type_name);
     ASSERT_EQ(a.get_string(), "asdfghjkl");
     ASSERT_EQ(a.call("length", std::vector<mlang::object::Object>{}).get_int(), 9);
-}
\ No newline at end of file
+}
+
+TEST(ObjectTest, Test7) {
+    std::vector<mlang::object::Object> no_params {};
+    mlang::object::Object a { std::make_shared<mlang::object::String>(" 42\n") };
+    mlang::object::Object b { std::make_shared<mlang::object::String>("ff") };
+    mlang::object::Object c { std::make_shared<mlang::object::String>("2.5e-1") };
+    mlang::object::Object d { std::make_shared<mlang::object::String>("12abc") };
+    mlang::object::Object base { std::make_shared<mlang::object::Int>(16) };
+
+    ASSERT_EQ(a.call("to_int", no_params).get_int(), 42);
+    ASSERT_EQ(b.call("to_int", std::vector<mlang::object::Object>{ base }).get_int(), 255);
+    ASSERT_EQ(c.call("to_float", no_params).get_float(), 0.25);
+    ASSERT_THROW(d.call("to_int", no_params), mlang::RuntimeError);
+    ASSERT_THROW(d.call("to_float", no_params), mlang::RuntimeError);
+
+    mlang::object::Object e { std::make_shared<mlang::object::Float>(0.1) };
+    mlang::object::Object f { std::make_shared<mlang::object::Float>(5.0) };
+    mlang::object::Object g { std::make_shared<mlang::object::Int>(-2147483647 - 1) };
+
+    ASSERT_EQ(e.get_string(), "0.1");
+    ASSERT_EQ(f.get_string(), "5.0");
+    ASSERT_EQ(g.get_string(), "-2147483648");
+    ASSERT_EQ(g.call("to_string", no_params).call("to_int", no_params).get_int(), -2147483647 - 1);
+}
+
+
+TEST(ObjectTest, Test8) {
+    using namespace mlang::object;
+    std::vector<Object> inner_elements {
+        Object { std::make_shared<String>("a\"b\n") },
+        Object { std::make_shared<None>() }
+    };
+    std::vector<Object> elements {
+        Object { std::make_shared<Int>(1) },
+        Object { std::make_shared<Float>(2.5) },
+        Object { std::make_shared<Boolean>(true) },
+        Object { std::make_shared<Array>(inner_elements) },
+        Object { std::make_shared<Array>() }
+    };
+    Array arr { elements };
+
+    const std::string debug = "Array : { 1 2.5 true Array : { a\"b\n None } Array : { } }";
+    const std::string json = "[1,2.5,true,[\"a\\\"b\\n\",null],[]]";
+    ASSERT_EQ(arr.get_string(), debug);
+    ASSERT_EQ(measure<DebugSerializer>(arr), debug.length());
+    ASSERT_EQ(serialize<JsonSerializer>(arr), json);
+    ASSERT_EQ(measure<JsonSerializer>(arr), json.length());
+
+    std::ostringstream stream;
+    serialize<JsonSerializer>(arr, stream);
+    ASSERT_EQ(stream.str(), json);
+
+    Object obj { std::make_shared<Array>(elements) };
+    ASSERT_EQ(obj.call("to_json", std::vector<Object>{}).get_string(), json);
+}
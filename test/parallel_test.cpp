@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <memory>
+
+#include "mlang/runtime/parallel.hpp"
+#include "mlang/runtime/executor.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+
+namespace {
+
+/* runs the script with the parallel built-ins of the executor and returns what it printed */
+std::string run (const std::string& script_text, mlang::runtime::Executor& executor, int expected_result = 0) {
+    mlang::runtime::ParallelFunctions parallel { executor };
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    parallel.declare_functions(env);
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    EXPECT_EQ(script.execute(env), expected_result);
+    env.get_output().flush();
+    return sink->get();
+}
+
+} /* namespace */
+
+TEST(ParallelTest, Test0) {
+    mlang::runtime::Executor executor { 4 };
+    std::string script_text;
+    script_text += "function square(x) { return x * x; }\n";
+    script_text += "function add(a, b) { return a + b; }\n";
+    script_text += "function show(i) { print(\"%d,\", i); }\n";
+    script_text += "var arr = {};\n";
+    script_text += "for (var i = 0; i < 1000; i++) { var v = i; arr += v; }\n";
+    script_text += "var squares = parallel_map(arr, \"square\");\n";
+    script_text += "print(\"%d %d %d\\n\", squares[0], squares[7], squares[999]);\n";
+    script_text += "print(\"%d %d\\n\", parallel_reduce(arr, \"add\", 0), parallel_reduce(squares, \"add\", 5));\n";
+    script_text += "print(\"%d\\n\", parallel_reduce({}, \"add\", 42));\n";
+    script_text += "parallel_for(30, \"show\");\n";
+    std::string expected = "0 49 998001\n499500 332833505\n42\n";
+    for (int i = 0; i < 30; ++i) { expected += std::to_string(i) + ","; }
+    /* the result and the order of the output do not depend on the scheduling */
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        ASSERT_EQ(run(script_text, executor), expected);
+    }
+    mlang::runtime::Executor single { 1 };
+    ASSERT_EQ(run(script_text, single), expected);
+}
+
+TEST(ParallelTest, Test1) {
+    mlang::runtime::Executor executor { 4 };
+    /* the output stops with the element that failed, the elements after it are not printed */
+    std::string script_text;
+    script_text += "function check(x) { print(\"%d,\", x); if (x == 500) { return y; } return x; }\n";
+    script_text += "var arr = {};\n";
+    script_text += "for (var i = 0; i < 1000; i++) { var v = i; arr += v; }\n";
+    script_text += "parallel_map(arr, \"check\");\n";
+    std::string expected;
+    for (int i = 0; i <= 500; ++i) { expected += std::to_string(i) + ","; }
+    for (int repeat = 0; repeat < 10; ++repeat) {
+        ASSERT_EQ(run(script_text, executor, 2).substr(0, expected.size()), expected);
+    }
+
+    /* the function does not see the variables of the caller */
+    ASSERT_EQ(run("var g = 1;\nfunction f(x) { return x + g; }\nparallel_map({ 1, 2 }, \"f\");", executor, 2),
+              run("function f(x) { return x + g; }\nparallel_map({ 1, 2 }, \"f\");", executor, 2));
+    run("parallel_map({ 1, 2 }, \"missing\");", executor, 2);
+    run("parallel_map(1, \"f\");", executor, 2);
+    run("parallel_for(\"a\", \"f\");", executor, 2);
+}
+
+TEST(ParallelTest, Test2) {
+    /* nested calls do not wait for a free worker, they run on the caller as well */
+    mlang::runtime::Executor executor { 2 };
+    std::string script_text;
+    script_text += "function add(a, b) { return a + b; }\n";
+    script_text += "function row(n) {\n";
+    script_text += "    var arr = {};\n";
+    script_text += "    for (var i = 0; i < 100; i++) { var v = n; arr += v; }\n";
+    script_text += "    return parallel_reduce(arr, \"add\", 0);\n";
+    script_text += "}\n";
+    script_text += "var rows = {};\n";
+    script_text += "for (var i = 0; i < 50; i++) { var v = i; rows += v; }\n";
+    script_text += "print(\"%d\\n\", parallel_reduce(parallel_map(rows, \"row\"), \"add\", 0));\n";
+    ASSERT_EQ(run(script_text, executor), "122500\n");
+}
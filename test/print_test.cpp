@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <chrono>
+#include <memory>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/script/output_writer.hpp"
+#include "mlang/object/format.hpp"
+
+TEST(PrintTest, Test0) {
+    mlang::object::Format format { "a=%d b=%f c=%b d=%s %% %x 100%" };
+    std::vector<mlang::object::Object> args {
+        mlang::object::Object { std::make_shared<mlang::object::Int>(5) },
+        mlang::object::Object { std::make_shared<mlang::object::Float>(1.5) },
+        mlang::object::Object { std::make_shared<mlang::object::Boolean>(true) },
+        mlang::object::Object { std::make_shared<mlang::object::String>("str") }
+    };
+
+    ASSERT_EQ(format.get_argument_count(), 4);
+    ASSERT_EQ(format.format(args), "a=5 b=1.500000 c=true d=str % %x 100%");
+    args.pop_back();
+    ASSERT_THROW(format.format(args), mlang::RuntimeError);
+}
+
+TEST(PrintTest, Test1) {
+    std::string script_text;
+    script_text += "var a = 5; \n";
+    script_text += "for (var i = 0; i < 3; ++i) { \n";
+    script_text += "    print(\"%d:%s\\n\", i, \"x\"); \n";
+    script_text += "} \n";
+    script_text += "print(\"a = %d\\n\", a);";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+
+    int ret = script.execute(env);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(sink->get(), "0:x\n1:x\n2:x\na = 5\n");
+}
+
+TEST(PrintTest, Test2) {
+    std::string script_text;
+    script_text += "print(\"%d %d\\n\", 1);";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+
+    int ret = script.execute(env);
+    ASSERT_EQ(ret, 1);
+}
+
+TEST(PrintTest, Test3) {
+    std::vector<std::string> chunks;
+    mlang::script::EnvStack env {};
+    env.set_output(std::make_shared<mlang::script::CallbackSink>([&chunks] (std::string_view data) { chunks.emplace_back(data); }), 8);
+
+    mlang::script::Output& output = env.get_output();
+    output.write("abc");
+    ASSERT_EQ(chunks.size(), 0);
+    output.write("defgh");
+    ASSERT_EQ(chunks.size(), 1);
+    ASSERT_EQ(chunks[0], "abcdefgh");
+    output.write("i");
+    output.flush();
+    ASSERT_EQ(chunks.size(), 2);
+    ASSERT_EQ(chunks[1], "i");
+}
+
+
+TEST(PrintTest, Test4) {
+    constexpr int thread_count = 4;
+    constexpr int line_count = 300;
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    {
+        mlang::script::OutputWriter writer { sink };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&writer, t] () {
+                std::string script_text;
+                script_text += "var name = \"t" + std::to_string(t) + "\"; \n";
+                script_text += "for (var i = 0; i < " + std::to_string(line_count) + "; ++i) { \n";
+                script_text += "    print(\"%s:%d\\n\", name, i); \n";
+                script_text += "}";
+                mlang::script::Script script { script_text };
+                mlang::script::EnvStack env {};
+                env.set_output(writer.open_channel(), 64);
+                ASSERT_EQ(script.execute(env), 0);
+            });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+        ASSERT_EQ(writer.get_errors(), 0);
+    }
+
+    std::vector<int> next (thread_count, 0);
+    std::istringstream lines { sink->get() };
+    std::string line;
+    int total = 0;
+    while (std::getline(lines, line)) {
+        ASSERT_EQ(line[0], 't');
+        const std::size_t colon = line.find(':');
+        ASSERT_NE(colon, std::string::npos);
+        const int t = std::stoi(line.substr(1, colon - 1));
+        ASSERT_EQ(std::stoi(line.substr(colon + 1)), next[t]);
+        ++next[t];
+        ++total;
+    }
+    ASSERT_EQ(total, thread_count * line_count);
+}
+
+TEST(PrintTest, Test5) {
+    std::shared_ptr<mlang::script::StringSink> target = std::make_shared<mlang::script::StringSink>();
+    std::shared_ptr<mlang::script::StringSink> own = std::make_shared<mlang::script::StringSink>();
+    std::atomic<bool> released { false };
+    std::string blocked_text;
+    std::shared_ptr<mlang::script::CallbackSink> blocking = std::make_shared<mlang::script::CallbackSink>([&] (std::string_view data) {
+        released.wait(false);
+        blocked_text.append(data);
+    });
+    {
+        mlang::script::OutputWriter writer { target };
+
+        /* only complete lines leave the channel before flush */
+        std::shared_ptr<mlang::script::ChannelSink> channel = writer.open_channel(own);
+        channel->write("ab");
+        ASSERT_EQ(channel->get_pending(), 0);
+        channel->write("c\nd");
+        channel->flush();
+        ASSERT_EQ(own->get(), "abc\nd");
+        ASSERT_EQ(channel->get_pending(), 0);
+
+        /* the writer is stuck on the first line, the second one does not fit */
+        std::shared_ptr<mlang::script::ChannelSink> dropping = writer.open_channel(blocking, 4, mlang::script::overflow_policy::drop);
+        dropping->write("x\n");
+        dropping->write("aaa\n");
+        ASSERT_EQ(dropping->get_dropped(), 4);
+        released.store(true);
+        released.notify_all();
+        dropping->flush();
+        ASSERT_EQ(blocked_text, "x\n");
+        ASSERT_EQ(writer.get_errors(), 0);
+    }
+    ASSERT_EQ(target->get(), "");
+}
+
+
+TEST(PrintTest, Test6) {
+    mlang::object::Format format { "[%5d][%-5d][%05d][%8.3f][%-6s][%.2s][%6b][%5x]" };
+    std::vector<mlang::object::Object> args {
+        mlang::object::Object { std::make_shared<mlang::object::Int>(42) },
+        mlang::object::Object { std::make_shared<mlang::object::Int>(42) },
+        mlang::object::Object { std::make_shared<mlang::object::Int>(-42) },
+        mlang::object::Object { std::make_shared<mlang::object::Float>(3.14159) },
+        mlang::object::Object { std::make_shared<mlang::object::String>("ab") },
+        mlang::object::Object { std::make_shared<mlang::object::String>("abcdef") },
+        mlang::object::Object { std::make_shared<mlang::object::Boolean>(false) }
+    };
+
+    ASSERT_EQ(format.get_argument_count(), 7);
+    ASSERT_EQ(format.format(args), "[   42][42   ][-0042][   3.142][ab    ][ab][ false][%5x]");
+}
+
+TEST(PrintTest, Test7) {
+    std::string script_text;
+    script_text += "var name = \"x\"; \n";
+    script_text += "var line = format(\"%s=%3d|%.1f\", name, 7, 2.25); \n";
+    script_text += "var rule = \"%s-%s\"; \n";
+    script_text += "print(\"%s\\n\", line); \n";
+    script_text += "print(\"%s\\n\", rule.format(\"a\", \"b\")); \n";
+    script_text += "print(\"%d\\n\", format(\"%04d\", 5).length());";
+    mlang::script::Script script { script_text };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+
+    int ret = script.execute(env);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(sink->get(), "x=  7|2.2\na-b\n4\n");
+}
+
+TEST(PrintTest, Test8) {
+    mlang::script::Script script { "var s = format(\"%d %d\", 1);" };
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    ASSERT_EQ(script.execute(env), 1);
+
+    mlang::script::Script runtime_script { "var rule = \"%d %d\"; var s = rule.format(1);" };
+    ASSERT_EQ(runtime_script.execute(env), 2);
+
+    /* 'format' is a keyword, it cannot be redefined and its rule must be a literal */
+    for (const char* text : { "function format (rule) { return rule; }", "var format = 1;", "var rule = \"%d\"; var s = format(rule, 1);" }) {
+        mlang::script::Script keyword_script { text };
+        ASSERT_EQ(keyword_script.execute(env), 1);
+    }
+}
+
+TEST(PrintTest, Test9) {
+    /* a print that fails partway through prints nothing of its own */
+    const std::string script_text = "print(\"before \");\nprint(\"start %s then %d\\n\", \"X\", { 1 });";
+    for (mlang::script::ast_layout layout : { mlang::script::ast_layout::tree, mlang::script::ast_layout::flat }) {
+        mlang::script::Script script { script_text };
+        mlang::script::EnvStack env {};
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        env.set_output(sink);
+        ASSERT_EQ(script.execute(env, layout), 2);
+        ASSERT_EQ(sink->get().substr(0, 38), "before ERROR : runtime error occurred\n");
+    }
+}
+
+TEST(PrintTest, Test10) {
+    /* a line handed over while the writer is destroyed is either written or refused, never stranded */
+    for (int round = 0; round < 20; ++round) {
+        std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+        std::unique_ptr<mlang::script::OutputWriter> writer = std::make_unique<mlang::script::OutputWriter>(sink);
+        std::vector<std::shared_ptr<mlang::script::ChannelSink>> channels;
+        for (int t = 0; t < 3; ++t) { channels.push_back(writer->open_channel()); }
+        std::atomic<int> accepted { 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([&, t] () {
+                try {
+                    while (true) {
+                        channels[t]->write("x\n");
+                        ++accepted;
+                    }
+                }
+                catch (const mlang::RuntimeError&) {}
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        writer.reset();
+        for (std::thread& thread : threads) { thread.join(); }
+        ASSERT_EQ(sink->get().size(), 2 * static_cast<std::size_t>(accepted.load()));
+        for (const std::shared_ptr<mlang::script::ChannelSink>& channel : channels) {
+            /* the refused line is still there, handing it over again fails instead of waiting */
+            ASSERT_EQ(channel->get_pending(), 0);
+            ASSERT_THROW(channel->flush(), mlang::RuntimeError);
+        }
+    }
+}
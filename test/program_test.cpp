@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+
+#include "mlang/script/script.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/ast/flat_tree.hpp"
+#include "mlang/parser/parser.hpp"
+
+namespace {
+
+std::string temp_path (const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string read_bytes (const std::string& path) {
+    std::ifstream file { path, std::ios::binary };
+    return std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+}
+
+void write_bytes (const std::string& path, const std::string& bytes) {
+    std::ofstream file { path, std::ios::binary | std::ios::trunc };
+    file << bytes;
+}
+
+std::string run (mlang::script::Script& script) {
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    EXPECT_EQ(script.execute(env), 0);
+    return sink->get();
+}
+
+const char* const program_text =
+    "function scale(value, factor) { return value * factor; }\n"
+    "var names = { \"a\\tb\", \"plain\", 2.5, true };\n"
+    "var total = 0;\n"
+    "for (var i = 0; i < 4; ++i) {\n"
+    "    if (i == 1) { continue; }\n"
+    "    total += scale(i, 3);\n"
+    "}\n"
+    "var text = format(\"%s|%s\", names[0], names[1]);\n"
+    "print(\"%d %s %f %b %d\\n\", total, text, names[2], names[3], text.length());\n"
+    "print(\"%s %s %s %s\\n\", \"one\", \"two\", \"three\", \"two\");\n";
+
+} /* namespace */
+
+TEST(ProgramTest, Test0) {
+    const std::string path = temp_path("mlang_program_test_0.mlangc");
+    mlang::script::Script script { program_text };
+    const std::string expected = run(script);
+    script.save(path);
+
+    mlang::script::Script loaded = mlang::script::Script::load(path);
+    ASSERT_TRUE(loaded.get_tokens().empty());
+    ASSERT_EQ(run(loaded), expected);
+    /* a loaded program can be saved again, the result is identical */
+    loaded.save(path + ".again");
+    ASSERT_EQ(read_bytes(path + ".again"), read_bytes(path));
+    std::filesystem::remove(path + ".again");
+    std::filesystem::remove(path);
+}
+
+TEST(ProgramTest, Test1) {
+    const std::string path = temp_path("mlang_program_test_1.mlangc");
+    mlang::script::Script script { program_text };
+    script.save(path);
+    const std::string bytes = read_bytes(path);
+
+    /* truncated */
+    write_bytes(path, bytes.substr(0, bytes.size() - 1));
+    ASSERT_THROW(mlang::script::Script::load(path), mlang::RuntimeError);
+    /* not a program */
+    write_bytes(path, "var a = 1;");
+    ASSERT_THROW(mlang::script::Script::load(path), mlang::RuntimeError);
+    /* other version */
+    std::string other_version = bytes;
+    other_version[8] = static_cast<char>(mlang::ast::program_format_version + 1);
+    write_bytes(path, other_version);
+    ASSERT_THROW(mlang::script::Script::load(path), mlang::RuntimeError);
+    /* a child index pointing forward, every node is checked */
+    std::string corrupt = bytes;
+    const std::size_t first_node = 56;
+    const std::uint32_t forward = 1000;
+    for (std::size_t i = 0; i < 4; ++i) { corrupt[first_node + 4 + i] = static_cast<char>((forward >> (8 * i)) & 0xFF); }
+    write_bytes(path, corrupt);
+    ASSERT_THROW(mlang::script::Script::load(path), mlang::RuntimeError);
+    ASSERT_THROW(mlang::script::Script::load(path + ".missing"), mlang::RuntimeError);
+
+    /* syntax errors are reported when saving */
+    mlang::script::Script invalid { "var a = ;" };
+    ASSERT_THROW(invalid.save(path), mlang::SyntaxError);
+    std::filesystem::remove(path);
+}
+
+TEST(ProgramTest, Test2) {
+    /* statements keep the line they start on */
+    std::string script_text = "var a = 1;\n\nwhile (a < 3) {\n    a += 1;\n}\n";
+    mlang::script::Script script { script_text };
+    mlang::parser::FlatParser parser {};
+    std::unique_ptr<mlang::ast::FlatTree> tree = parser.parse(script.get_tokens());
+    std::size_t lines_found = 0;
+    for (mlang::ast::node_index i = 0; i < tree->get_node_count(); ++i) {
+        const mlang::ast::FlatNode& node = tree->get_node(i);
+        if (node.type == mlang::ast::ast_node_types::while_statement) {
+            ASSERT_EQ(tree->get_line(i), 3);
+            ++lines_found;
+        }
+        if (node.type == mlang::ast::ast_node_types::assignment) {
+            ASSERT_EQ(tree->get_line(i), 4);
+            ++lines_found;
+        }
+    }
+    ASSERT_EQ(lines_found, 2);
+}
+
+TEST(ProgramTest, Test3) {
+    /* the 'none' literal is saved like the other constants */
+    const std::string path = temp_path("mlang_program_test_3.mlangc");
+    mlang::script::Script script { "var v = none;\nvar values = { 1, none };\nprint(\"%b %b %b\\n\", v == none, values[1] == none, values[0] != none);\n" };
+    const std::string expected = run(script);
+    ASSERT_EQ(expected, "true true true\n");
+    script.save(path);
+    mlang::script::Script loaded = mlang::script::Script::load(path);
+    ASSERT_EQ(run(loaded), expected);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <memory>
+
+#include "mlang/script/reload.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/script/budget.hpp"
+#include "mlang/func/function.hpp"
+
+namespace {
+
+int call (mlang::script::EnvStack& env, const std::string& name, int value) {
+    std::vector<mlang::object::Object> params { mlang::object::Object { std::make_shared<mlang::object::Int>(value) } };
+    return env.get_function(name)->call(env, params).get_int();
+}
+
+} /* namespace */
+
+TEST(ReloadTest, Test0) {
+    std::string version_1;
+    version_1 += "function step (x) { return x + 1; }\n";
+    version_1 += "/* removed below */\n";
+    version_1 += "function old (x) { return x; }\n";
+    version_1 += "var counter = 0;\n";
+    version_1 += "var limit = 5;\n";
+    version_1 += "counter += step(1);\n";
+    version_1 += "if (counter > limit) { counter = limit; }\n";
+    version_1 += "else { print(\"%d\\n\", counter); }\n";
+
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    mlang::script::ReloadableScript script { version_1 };
+    ASSERT_EQ(script.get_stats().units, 6);
+    ASSERT_EQ(script.execute(env), 0);
+    ASSERT_EQ(sink->get(), "2\n");
+    ASSERT_EQ(call(env, "step", 1), 2);
+
+    std::string version_2;
+    version_2 += "function step (x) { return x + 10; }\n";
+    version_2 += "var counter = 0;\n";
+    version_2 += "var limit = 50;\n";
+    version_2 += "var added = step(0);\n";
+    version_2 += "counter += step(1);\n";
+    version_2 += "if (counter > limit) { counter = limit; }\n";
+    version_2 += "else { print(\"%d\\n\", counter); }\n";
+    version_2 += "counter += added;\n";
+    ASSERT_EQ(script.reload(version_2, env), 0);
+
+    const mlang::script::ReloadStats& stats = script.get_stats();
+    ASSERT_EQ(stats.units, 7);
+    ASSERT_EQ(stats.compiled, 4);   /* step, limit, added and the last statement */
+    ASSERT_EQ(stats.reused, 3);
+    ASSERT_EQ(stats.removed, 1);
+    ASSERT_EQ(stats.executed, 3);   /* limit exists already and keeps its value */
+    ASSERT_LT(stats.lexed_bytes, version_2.size() / 2);
+
+    /* unchanged statements did not run again, the globals kept their values */
+    ASSERT_EQ(sink->get(), "2\n");
+    ASSERT_EQ(env.get_variable("counter").get_int(), 12);
+    ASSERT_EQ(env.get_variable("limit").get_int(), 5);
+    ASSERT_EQ(env.get_variable("added").get_int(), 10);
+    ASSERT_EQ(call(env, "step", 1), 11);
+    ASSERT_FALSE(env.has_function("old"));
+}
+
+TEST(ReloadTest, Test1) {
+    const std::string version_1 = "function f (x) { return x * 2; }\nvar a = f(2);\n";
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    mlang::script::ReloadableScript script { version_1 };
+    ASSERT_EQ(script.execute(env), 0);
+
+    /* a syntax error changes nothing, it is reported with the line in the whole text */
+    ASSERT_EQ(script.reload("function f (x) { return x * 3; }\nvar a = f(2);\nvar b = ;\n", env), 1);
+    ASSERT_NE(sink->get().find("line 3"), std::string::npos);
+    ASSERT_EQ(call(env, "f", 5), 10);
+    ASSERT_FALSE(env.has_variable("b"));
+
+    /* the body of a changed function is compiled by the reload, the old function stays */
+    ASSERT_EQ(script.reload("function f (x) { return x +; }\nvar a = f(2);\n", env), 1);
+    ASSERT_EQ(call(env, "f", 5), 10);
+
+    /* a runtime error is reported, the new text is in place */
+    ASSERT_EQ(script.reload("function f (x) { return x * 4; }\nvar a = f(2);\nmissing(1);\n", env), 2);
+    ASSERT_EQ(call(env, "f", 5), 20);
+    ASSERT_EQ(script.reload(version_1, env), 0);
+    ASSERT_EQ(call(env, "f", 5), 10);
+    ASSERT_EQ(env.get_variable("a").get_int(), 4);
+}
+
+TEST(ReloadTest, Test2) {
+    /* an error inside a function leaves its scope, the next reload replaces the function */
+    mlang::script::EnvStack env {};
+    std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+    env.set_output(sink);
+    const std::size_t depth = env.get_depth();
+    mlang::script::ReloadableScript script { "function f (x) { return missing(x); }\nf(1);\n" };
+    ASSERT_EQ(script.execute(env), 2);
+    ASSERT_EQ(env.get_depth(), depth);
+    ASSERT_EQ(script.reload("function f (x) { return x * 3; }\nvar a = f(2);\nfunction g (x) { return missing(x); }\ng(1);\n", env), 2);
+    ASSERT_EQ(env.get_depth(), depth);
+    ASSERT_EQ(call(env, "f", 5), 15);
+
+    /* an exceeded budget is reported like Script::execute does */
+    mlang::script::Budget budget {};
+    budget.max_steps = 1000;
+    env.set_budget(budget);
+    ASSERT_EQ(script.reload("function f (x) { return x * 3; }\nvar a = f(2);\nfunction g (x) { while (true) { x++; } }\ng(2);\n", env), 3);
+    ASSERT_EQ(env.get_depth(), depth);
+    ASSERT_NE(sink->get().find("ERROR : execution budget exceeded"), std::string::npos);
+}
@@ -3,6 +3,7 @@
 #include <string>
 
 #include "mlang/script/script.hpp"
+#include "mlang/script/output.hpp"
 
 TEST(ScriptTest, Test0) {
     std::string script_text = "var a = 5; var b = 5.1;";
@@ -304,4 +305,23 @@ TEST(ScriptTest, Test13) {
     ASSERT_EQ(env.get_variable("a").get_typename(), mlang::object::Int::type_name);
     ASSERT_EQ(env.get_variable("a").get_int(), 5);
     ASSERT_EQ(env.has_variable("b"), false);
-}
\ No newline at end of file
+}
+
+TEST(ScriptTest, Test14) {
+    /* lexing the text again reuses the escaped literals kept by the source */
+    std::string script_text;
+    script_text += "function tag(s) { return \"<\\t\" + s; }\n";
+    script_text += "print(\"%s\\n\", tag(\"a\\tb\"));\n";
+    mlang::script::Script script { script_text };
+    std::size_t size = 0;
+    for (int i = 0; i < 5; ++i) {
+        for (mlang::script::ast_layout layout : { mlang::script::ast_layout::tree, mlang::script::ast_layout::flat }) {
+            mlang::script::EnvStack env {};
+            env.set_output(std::make_shared<mlang::script::StringSink>());
+            ASSERT_EQ(script.execute(env, layout), 0);
+            if (size == 0) { size = script.get_source().get_size(); }
+            ASSERT_EQ(script.get_source().get_size(), size);
+        }
+    }
+    ASSERT_GT(size, script_text.size());
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "mlang/runtime/shared_store.hpp"
+#include "mlang/runtime/event_loop.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/script/program.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/output.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/object/array.hpp"
+#include "mlang/exception.hpp"
+
+namespace {
+
+mlang::object::Object make_int (int value) { return mlang::object::Object { std::make_shared<mlang::object::Int>(value) }; }
+
+/* every run adds one to "count", a failed compare_and_set means another script was faster */
+const std::string increment_script =
+    "var store = new SharedStore(\"increments\");\n"
+    "var done = false;\n"
+    "while (!done) {\n"
+    "    var version = store.version(\"count\");\n"
+    "    var count = 0;\n"
+    "    if (store.has(\"count\")) { count = store.get(\"count\"); }\n"
+    "    done = store.compare_and_set(\"count\", version, count + 1);\n"
+    "}";
+
+} /* namespace */
+
+TEST(SharedStoreTest, Test0) {
+    std::shared_ptr<mlang::runtime::SharedStore> store = mlang::runtime::SharedStore::create();
+    ASSERT_EQ(store->get_version("speed"), 0);
+    ASSERT_TRUE(store->get("speed").is_none());
+    ASSERT_EQ(store->set("speed", make_int(10)), 1);
+    ASSERT_EQ(store->set("speed", make_int(12)), 2);
+    ASSERT_EQ(store->get("speed").get_int(), 12);
+    ASSERT_FALSE(store->compare_and_set("speed", 1, make_int(13)));
+    ASSERT_TRUE(store->compare_and_set("speed", 2, make_int(14)));
+    ASSERT_TRUE(store->compare_and_set("mode", 0, make_int(1)));
+    ASSERT_EQ(store->get_size(), 2);
+    ASSERT_THROW(store->set("speed", mlang::object::Object {}), mlang::RuntimeError);
+
+    /* a removed key is gone, setting it again never gives back a version it had */
+    ASSERT_TRUE(store->remove("speed"));
+    ASSERT_FALSE(store->remove("speed"));
+    ASSERT_EQ(store->get_version("speed"), 0);
+    ASSERT_TRUE(store->get("speed").is_none());
+    ASSERT_EQ(store->get_size(), 1);
+    ASSERT_FALSE(store->compare_and_set("speed", 3, make_int(15)));
+    ASSERT_EQ(store->set("speed", make_int(16)), 4);
+    ASSERT_TRUE(store->remove("speed"));
+    ASSERT_EQ(store->get_size(), 1);
+
+    /* the stored value shares nothing with the value that was set or with the value that was read */
+    std::shared_ptr<mlang::object::Array> array = std::make_shared<mlang::object::Array>(std::vector<mlang::object::Object> { make_int(7), make_int(8) });
+    store->set("limits", mlang::object::Object { array });
+    mlang::object::Object element = array->get_elements()[0];
+    element.assign(make_int(70));
+    mlang::object::Object read = store->get("limits");
+    ASSERT_EQ(read.get_string(), "Array : { 7 8 }");
+    mlang::object::Object read_element = std::dynamic_pointer_cast<mlang::object::Array>(read.get_internal())->get_elements()[1];
+    read_element.assign(make_int(80));
+    ASSERT_EQ(store->get("limits").get_string(), "Array : { 7 8 }");
+
+    /* the table grows, every key is still found */
+    for (int i = 0; i < 1000; ++i) { store->set("key" + std::to_string(i), make_int(i)); }
+    for (int i = 0; i < 1000; ++i) { ASSERT_EQ(store->get("key" + std::to_string(i)).get_int(), i); }
+    ASSERT_EQ(store->get_size(), 1002);
+    for (int i = 0; i < 1000; ++i) { ASSERT_TRUE(store->remove("key" + std::to_string(i))); }
+    ASSERT_EQ(store->get_size(), 2);
+    ASSERT_EQ(store->get("limits").get_string(), "Array : { 7 8 }");
+
+    /* stores of the same name are the same store */
+    mlang::runtime::SharedStore first { "shared_store_test" };
+    mlang::runtime::SharedStore second { "shared_store_test" };
+    first.set("answer", make_int(42));
+    ASSERT_EQ(second.get("answer").get_int(), 42);
+}
+
+TEST(SharedStoreTest, Test1) {
+    /* readers never see a torn or older value while writers update and add keys */
+    std::shared_ptr<mlang::runtime::SharedStore> store = mlang::runtime::SharedStore::create();
+    store->set("counter", make_int(0));
+    constexpr int writers = 2;
+    constexpr int increments = 2000;
+    std::atomic<bool> writing { true };
+    std::atomic<int> failures { 0 };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] () {
+            int last = 0;
+            while (writing.load()) {
+                const int value = store->get("counter").get_int();
+                if (value < last) { ++failures; }
+                last = value;
+            }
+        });
+    }
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] () {
+            for (int i = 0; i < increments; ++i) {
+                while (true) {
+                    const std::uint64_t version = store->get_version("counter");
+                    const int value = store->get("counter").get_int();
+                    if (store->compare_and_set("counter", version, make_int(value + 1))) { break; }
+                }
+                store->set("w" + std::to_string(w) + "_" + std::to_string(i), make_int(i));
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    writing = false;
+    for (std::thread& thread : readers) { thread.join(); }
+    ASSERT_EQ(failures.load(), 0);
+    ASSERT_EQ(store->get("counter").get_int(), writers * increments);
+    ASSERT_EQ(store->get_size(), 1 + writers * increments);
+}
+
+TEST(SharedStoreTest, Test2) {
+    /* isolates on different threads update the same named store */
+    mlang::runtime::SharedStore::define_type();
+    std::shared_ptr<const mlang::script::Program> program = mlang::script::Script { increment_script }.get_program();
+    constexpr int thread_count = 4;
+    constexpr int runs = 100;
+    std::atomic<int> failures { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&] () {
+            mlang::script::Isolate isolate { program };
+            for (int i = 0; i < runs; ++i) {
+                isolate.reset();
+                if (isolate.run() != 0) { ++failures; }
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    ASSERT_EQ(failures.load(), 0);
+    ASSERT_EQ(mlang::runtime::SharedStore { "increments" }.get("count").get_int(), thread_count * runs);
+
+    /* a watching task is parked until another task writes the key */
+    mlang::runtime::EventLoop loop {};
+    std::shared_ptr<mlang::runtime::Task> watcher = loop.spawn(mlang::script::Script {
+        "var store = new SharedStore(\"watched\");\nvar version = store.watch(\"mode\", store.version(\"mode\"));\nexit store.get(\"mode\") + version;"
+    }.get_program());
+    loop.spawn(mlang::script::Script { "var store = new SharedStore(\"watched\");\nstore.set(\"mode\", 10);" }.get_program());
+    loop.run();
+    ASSERT_EQ(watcher->get_exit_code(), 0);
+    ASSERT_EQ(watcher->get_value().get_int(), 11);
+
+    /* anywhere else watching blocks the thread */
+    mlang::runtime::SharedStore store { "watched" };
+    std::thread writer { [] () {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        mlang::runtime::SharedStore { "watched" }.set("mode", make_int(20));
+    } };
+    ASSERT_EQ(store.watch("mode", 1), 2);
+    writer.join();
+    ASSERT_EQ(store.get("mode").get_int(), 20);
+}
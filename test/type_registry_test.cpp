@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "mlang/script/type_registry.hpp"
+#include "mlang/script/environment.hpp"
+#include "mlang/script/script.hpp"
+#include "mlang/object/int.hpp"
+#include "mlang/exception.hpp"
+
+namespace {
+
+class CounterFactory : public mlang::object::ObjectFactory {
+public:
+    std::shared_ptr<mlang::object::InternalObject> create () const override { return std::make_shared<mlang::object::Int>(); }
+};
+
+} /* namespace */
+
+TEST(TypeRegistryTest, Test0) {
+    mlang::script::TypeRegistry& registry = mlang::script::TypeRegistry::instance();
+    ASSERT_EQ(registry.find(mlang::object::None::type_name), mlang::script::builtin_types::none);
+    ASSERT_EQ(registry.find(mlang::object::Int::type_name), mlang::script::builtin_types::integer);
+    ASSERT_EQ(registry.find(mlang::object::String::type_name), mlang::script::builtin_types::string);
+    ASSERT_EQ(registry.find("NoSuchType"), mlang::script::unknown_type);
+    ASSERT_THROW(registry.get_factory(mlang::script::unknown_type), mlang::RuntimeError);
+    ASSERT_THROW(registry.get_factory("NoSuchType"), mlang::RuntimeError);
+
+    const mlang::script::type_id id = mlang::script::Environment::define_type("RegistryCounter", std::make_shared<CounterFactory>());
+    ASSERT_EQ(registry.find("RegistryCounter"), id);
+    ASSERT_THROW(mlang::script::Environment::define_type("RegistryCounter", std::make_shared<CounterFactory>()), mlang::RuntimeError);
+    mlang::script::EnvStack env {};
+    env.declare_variable("c", id);
+    ASSERT_EQ(env.get_variable("c").get_typename(), mlang::object::Int::type_name);
+}
+
+TEST(TypeRegistryTest, Test1) {
+    /* types are defined while scripts look them up on other threads */
+    constexpr std::size_t type_count = 200;
+    std::atomic<bool> defining { true };
+    std::atomic<std::size_t> failures { 0 };
+    std::vector<std::thread> readers;
+    for (std::size_t r = 0; r < 3; ++r) {
+        readers.emplace_back([&] () {
+            mlang::script::Script script { "var a = new Int(1); var b = new String(\"x\"); a = 5;" };
+            while (defining.load()) {
+                mlang::script::EnvStack env {};
+                std::shared_ptr<mlang::script::StringSink> sink = std::make_shared<mlang::script::StringSink>();
+                env.set_output(sink);
+                if (script.execute(env) != 0) { ++failures; }
+                /* a defined type never moves */
+                const mlang::script::type_id first = mlang::script::TypeRegistry::instance().find("Concurrent0");
+                if ((first != mlang::script::unknown_type) && (mlang::script::TypeRegistry::instance().find("Concurrent0") != first)) { ++failures; }
+            }
+        });
+    }
+    std::vector<mlang::script::type_id> ids;
+    for (std::size_t i = 0; i < type_count; ++i) {
+        ids.push_back(mlang::script::Environment::define_type("Concurrent" + std::to_string(i), std::make_shared<CounterFactory>()));
+    }
+    defining = false;
+    for (std::thread& reader : readers) { reader.join(); }
+    ASSERT_EQ(failures.load(), 0);
+    for (std::size_t i = 0; i < type_count; ++i) {
+        ASSERT_EQ(mlang::script::Environment::find_type("Concurrent" + std::to_string(i)), ids[i]);
+        ASSERT_NO_THROW(mlang::script::Environment::get_factory(ids[i]).create());
+    }
+
+    /* a constructor caches the id, the type is created by every thread */
+    mlang::script::Script script { "var c = new Concurrent7(4); c = 3;" };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&] () {
+            mlang::script::EnvStack env {};
+            if (script.execute(env) != 0) { ++failures; }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    ASSERT_EQ(failures.load(), 0);
+}